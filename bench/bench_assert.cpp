@@ -0,0 +1,157 @@
+#include "bench_core.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief A benchmarking core which, besides the assertions of the core, dispatching on the kinds of the terms, offers the dispatch through a chain of `std::dynamic_pointer_cast`s which the core used to perform, so that the two can be compared on the same terms.
+ */
+class assert_core : public bench_core
+{
+public:
+    /**
+     * @brief Asserts the given expression, finding the constraint to post through a chain of `std::dynamic_pointer_cast`s.
+     */
+    bool cast_assert(riddle::bool_expr xpr) noexcept
+    {
+        if (auto n_xpr = std::dynamic_pointer_cast<riddle::bool_not>(xpr))
+        {
+            if (auto lt_xpr = std::dynamic_pointer_cast<riddle::lt_term>(n_xpr->get_arg()))
+                return mk_le(lt_xpr->get_rhs(), lt_xpr->get_lhs());
+            else if (auto le_xpr = std::dynamic_pointer_cast<riddle::le_term>(n_xpr->get_arg()))
+                return mk_lt(le_xpr->get_rhs(), le_xpr->get_lhs());
+            else if (auto eq_xpr = std::dynamic_pointer_cast<riddle::eq_term>(n_xpr->get_arg()))
+            {
+                if (eq_xpr->get_lhs() == eq_xpr->get_rhs())
+                    return false;
+                else if (auto lhs_xpr = std::dynamic_pointer_cast<riddle::arith_term>(eq_xpr->get_lhs()))
+                    return mk_neq(lhs_xpr, std::static_pointer_cast<riddle::arith_term>(eq_xpr->get_rhs()));
+                else if (auto lhs_sxpr = std::dynamic_pointer_cast<riddle::string_term>(eq_xpr->get_lhs()))
+                    return mk_neq(lhs_sxpr, std::static_pointer_cast<riddle::string_term>(eq_xpr->get_rhs()));
+                else if (auto lhs_bxpr = std::dynamic_pointer_cast<riddle::bool_term>(eq_xpr->get_lhs()))
+                    return mk_neq(lhs_bxpr, std::static_pointer_cast<riddle::bool_term>(eq_xpr->get_rhs()));
+                else
+                    return true;
+            }
+            else if (auto ge_xpr = std::dynamic_pointer_cast<riddle::ge_term>(n_xpr->get_arg()))
+                return mk_gt(ge_xpr->get_lhs(), ge_xpr->get_rhs());
+            else if (auto gt_xpr = std::dynamic_pointer_cast<riddle::gt_term>(n_xpr->get_arg()))
+                return mk_ge(gt_xpr->get_lhs(), gt_xpr->get_rhs());
+            else if (auto b_xpr = std::dynamic_pointer_cast<riddle::bool_term>(n_xpr->get_arg()))
+                return mk_assign(b_xpr, utils::False);
+            else
+                return false;
+        }
+        else if (auto lt_xpr = std::dynamic_pointer_cast<riddle::lt_term>(xpr))
+            return mk_lt(lt_xpr->get_lhs(), lt_xpr->get_rhs());
+        else if (auto le_xpr = std::dynamic_pointer_cast<riddle::le_term>(xpr))
+            return mk_le(le_xpr->get_lhs(), le_xpr->get_rhs());
+        else if (auto eq_xpr = std::dynamic_pointer_cast<riddle::eq_term>(xpr))
+        {
+            if (eq_xpr->get_lhs() == eq_xpr->get_rhs())
+                return true;
+            else if (auto lhs_xpr = std::dynamic_pointer_cast<riddle::arith_term>(eq_xpr->get_lhs()))
+                return mk_eq(lhs_xpr, std::static_pointer_cast<riddle::arith_term>(eq_xpr->get_rhs()));
+            else if (auto lhs_sxpr = std::dynamic_pointer_cast<riddle::string_term>(eq_xpr->get_lhs()))
+                return mk_eq(lhs_sxpr, std::static_pointer_cast<riddle::string_term>(eq_xpr->get_rhs()));
+            else if (auto lhs_bxpr = std::dynamic_pointer_cast<riddle::bool_term>(eq_xpr->get_lhs()))
+                return mk_eq(lhs_bxpr, std::static_pointer_cast<riddle::bool_term>(eq_xpr->get_rhs()));
+            else
+                return false;
+        }
+        else if (auto ge_xpr = std::dynamic_pointer_cast<riddle::ge_term>(xpr))
+            return mk_ge(ge_xpr->get_lhs(), ge_xpr->get_rhs());
+        else if (auto gt_xpr = std::dynamic_pointer_cast<riddle::gt_term>(xpr))
+            return mk_gt(gt_xpr->get_lhs(), gt_xpr->get_rhs());
+        else if (auto b_xpr = std::dynamic_pointer_cast<riddle::bool_term>(xpr))
+            return mk_assign(b_xpr, utils::True);
+        else
+            return false;
+    }
+};
+
+/**
+ * @brief Builds the given number of constraints, cycling through the comparisons, their negations and the boolean constraints.
+ */
+static std::vector<riddle::bool_expr> constraints(assert_core &cr, size_t size)
+{
+    std::vector<riddle::arith_expr> vars;
+    for (size_t i = 0; i < 64; ++i)
+        vars.push_back(cr.new_real());
+    std::vector<riddle::bool_expr> bools;
+    for (size_t i = 0; i < 64; ++i)
+        bools.push_back(cr.new_bool());
+
+    std::vector<riddle::bool_expr> xprs;
+    xprs.reserve(size);
+    for (size_t i = 0; xprs.size() < size; ++i)
+    {
+        const auto &lhs = vars[i % vars.size()];
+        const auto &rhs = vars[(i * 7 + 1) % vars.size()];
+        riddle::bool_expr xpr;
+        switch (i % 7)
+        {
+        case 0:
+            xpr = cr.new_lt(lhs, rhs);
+            break;
+        case 1:
+            xpr = cr.new_le(lhs, rhs);
+            break;
+        case 2:
+            xpr = cr.new_eq(lhs, rhs);
+            break;
+        case 3:
+            xpr = cr.new_ge(lhs, rhs);
+            break;
+        case 4:
+            xpr = cr.new_gt(lhs, rhs);
+            break;
+        case 5:
+            xpr = cr.new_eq(bools[i % bools.size()], bools[(i * 7 + 1) % bools.size()]);
+            break;
+        default:
+            xpr = bools[i % bools.size()];
+        }
+        xprs.push_back(i % 3 == 0 ? cr.new_not(std::move(xpr)) : std::move(xpr));
+    }
+    return xprs;
+}
+
+/**
+ * @brief Asserts the given constraints a number of times through the given function, reporting the best time per assertion.
+ */
+template <typename F>
+static double run(const std::string &title, assert_core &cr, const std::vector<riddle::bool_expr> &xprs, size_t repetitions, F &&assert_expr)
+{
+    auto best = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < repetitions; ++i)
+    {
+        cr.posted = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &xpr : xprs)
+            assert_expr(xpr);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        if (cr.posted != xprs.size())
+            throw std::logic_error("some constraints have not been posted");
+    }
+    const auto ns = best / static_cast<double>(xprs.size());
+    std::cout << std::left << std::setw(24) << title << std::right << std::setw(12) << xprs.size() << " constraints " << std::fixed << std::setprecision(2) << std::setw(8) << ns << " ns/constraint\n";
+    return ns;
+}
+
+int main(int argc, char const *argv[])
+{
+    // usage: riddle_assert_bench [number of constraints]..
+    const size_t size = argc > 1 ? std::stoul(argv[1]) : 1 << 20;
+
+    assert_core cr;
+    const auto xprs = constraints(cr, size);
+    const auto casts = run("dynamic_pointer_cast", cr, xprs, 10, [&cr](const riddle::bool_expr &xpr)
+                           { return cr.cast_assert(xpr); });
+    const auto kinds = run("term kinds", cr, xprs, 10, [&cr](const riddle::bool_expr &xpr)
+                           { return cr.assert_expr(xpr); });
+    std::cout << "speedup: " << std::fixed << std::setprecision(2) << casts / kinds << "x\n";
+    return 0;
+}
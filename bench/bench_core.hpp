@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core.hpp"
+#include "items.hpp"
+
+/**
+ * @brief A core whose backend accepts every constraint, counting the constraints it is given.
+ */
+class bench_core : public riddle::core
+{
+public:
+    riddle::bool_expr new_bool(const bool) override { return new_term<riddle::bool_item>(static_cast<riddle::bool_type &>(get_type(riddle::bool_kw)), utils::lit()); }
+    riddle::bool_expr new_bool() override { return new_bool(false); }
+    utils::lbool bool_value(const riddle::bool_term &) const noexcept override { return utils::Undefined; }
+    riddle::arith_expr new_int(const INT_TYPE) override { return new_term<riddle::arith_item>(static_cast<riddle::int_type &>(get_type(riddle::int_kw)), utils::lin()); }
+    riddle::arith_expr new_int() override { return new_int(0); }
+    riddle::arith_expr new_int(const INT_TYPE lb, const INT_TYPE) override { return new_int(lb); }
+    riddle::arith_expr new_uncertain_int(const INT_TYPE lb, const INT_TYPE) override { return new_int(lb); }
+    riddle::arith_expr new_real(utils::rational &&) override { return new_term<riddle::arith_item>(static_cast<riddle::real_type &>(get_type(riddle::real_kw)), utils::lin()); }
+    riddle::arith_expr new_real() override { return new_real(utils::rational(0)); }
+    riddle::arith_expr new_real(utils::rational &&lb, utils::rational &&) override { return new_real(utils::rational(lb)); }
+    riddle::arith_expr new_uncertain_real(utils::rational &&lb, utils::rational &&) override { return new_real(utils::rational(lb)); }
+    riddle::arith_expr new_time(utils::rational &&) override { return new_term<riddle::arith_item>(static_cast<riddle::time_type &>(get_type(riddle::time_kw)), utils::lin()); }
+    riddle::arith_expr new_time() override { return new_time(utils::rational(0)); }
+    utils::inf_rational arith_value(const riddle::arith_term &) const noexcept override { return utils::inf_rational(); }
+    bool is_constant(const riddle::arith_term &) const noexcept override { return false; }
+    riddle::string_expr new_string(std::string &&) override { return new_term<riddle::string_item>(static_cast<riddle::string_type &>(get_type(riddle::string_kw)), ""); }
+    riddle::string_expr new_string() override { return new_string(""); }
+    std::string string_value(const riddle::string_term &) const noexcept override { return ""; }
+    riddle::expr new_enum(riddle::component_type &, std::vector<riddle::expr> &&) override { throw std::logic_error("enums are not benchmarked"); }
+    std::unordered_set<riddle::expr> enum_value(const riddle::enum_term &) const noexcept override { return {}; }
+
+    riddle::arith_expr new_negation(riddle::arith_expr) override { return new_real(); }
+    riddle::arith_expr new_sum(std::vector<riddle::arith_expr> &&) override { return new_real(); }
+    riddle::arith_expr new_subtraction(std::vector<riddle::arith_expr> &&) override { return new_real(); }
+    riddle::arith_expr new_product(std::vector<riddle::arith_expr> &&) override { return new_real(); }
+    riddle::arith_expr new_division(std::vector<riddle::arith_expr> &&) override { return new_real(); }
+
+    void new_disjunction(std::vector<std::unique_ptr<riddle::conjunction>> &&) override {}
+    void new_clause(std::vector<riddle::bool_expr> &&) override {}
+
+    riddle::atom_expr create_atom(bool, riddle::predicate &, riddle::item_map &&) override { throw std::logic_error("atoms are not benchmarked"); }
+    riddle::atom_state get_atom_state(const riddle::atom_term &) const noexcept override { return riddle::atom_state::active; }
+
+    size_t posted = 0; // the number of constraints posted to the backend..
+
+protected:
+    bool mk_assign(riddle::bool_expr, utils::lbool) noexcept override { return ++posted; }
+    bool mk_eq(riddle::bool_expr, riddle::bool_expr) noexcept override { return ++posted; }
+    bool mk_neq(riddle::bool_expr, riddle::bool_expr) noexcept override { return ++posted; }
+
+    bool mk_lt(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+    bool mk_le(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+    bool mk_eq(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+    bool mk_neq(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+    bool mk_ge(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+    bool mk_gt(riddle::arith_expr, riddle::arith_expr) noexcept override { return ++posted; }
+
+    bool mk_eq(riddle::string_expr, riddle::string_expr, std::shared_ptr<riddle::resolver> = nullptr) noexcept override { return ++posted; }
+    bool mk_neq(riddle::string_expr, riddle::string_expr, std::shared_ptr<riddle::resolver> = nullptr) noexcept override { return ++posted; }
+
+    bool mk_assign(riddle::enum_expr, const utils::enum_val &) noexcept override { return ++posted; }
+    bool mk_forbid(riddle::enum_expr, const utils::enum_val &) noexcept override { return ++posted; }
+    bool mk_eq(riddle::enum_expr, riddle::enum_expr) noexcept override { return ++posted; }
+    bool mk_neq(riddle::enum_expr, riddle::enum_expr) noexcept override { return ++posted; }
+};
@@ -0,0 +1,41 @@
+#include "bench_core.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+/**
+ * @brief Reads a script declaring the given number of global items, returning the time it took in milliseconds.
+ */
+static double read_globals(size_t size)
+{
+    std::string script;
+    script.reserve(size * 24);
+    for (size_t i = 0; i < size; ++i)
+        script += "real x" + std::to_string((i * 7919) % size) + " = 1.0;\n"; // the globals are not declared in the order of their names..
+
+    bench_core cr;
+    const auto start = std::chrono::steady_clock::now();
+    cr.read(script);
+    const auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (cr.get_items().size() != size)
+        throw std::logic_error("some globals have not been declared");
+    return ms;
+}
+
+int main(int argc, char const *argv[])
+{
+    // usage: riddle_globals_bench [largest number of globals]..
+    const size_t max_size = argc > 1 ? std::stoul(argv[1]) : 160000;
+
+    double prev = 0;
+    for (size_t size = max_size / 16; size <= max_size; size *= 2)
+    { // loading should scale linearly, so the time should roughly double with the number of globals..
+        const auto ms = read_globals(size);
+        std::cout << std::right << std::setw(12) << size << " globals " << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms " << std::setw(8) << ms * 1e6 / static_cast<double>(size) << " ns/global";
+        if (prev > 0)
+            std::cout << "  x" << std::setprecision(2) << ms / prev;
+        std::cout << '\n';
+        prev = ms;
+    }
+    return 0;
+}
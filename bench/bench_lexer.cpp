@@ -0,0 +1,115 @@
+#include "lexer.hpp"
+#include "scan.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define RIDDLE_BENCH_CYCLES
+#endif
+
+/**
+ * @brief Returns the current value of the time stamp counter, or of a nanosecond clock where no such counter is available.
+ */
+static std::uint64_t ticks() noexcept
+{
+#ifdef RIDDLE_BENCH_CYCLES
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+static const char *name(riddle::scan::isa set) noexcept
+{
+    switch (set)
+    {
+    case riddle::scan::isa::avx2:
+        return "avx2";
+    case riddle::scan::isa::sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief Tokenizes the given sources a number of times with each supported instruction set, reporting the best throughput.
+ */
+static void run(const std::string &title, const std::vector<std::string> &sources, size_t repetitions)
+{
+    size_t bytes = 0;
+    for (const auto &src : sources)
+        bytes += src.size();
+
+    riddle::symbol_table symbols;
+    for (const auto set : {riddle::scan::isa::scalar, riddle::scan::isa::sse2, riddle::scan::isa::avx2})
+    {
+        if (set > riddle::scan::supported())
+            continue;
+        riddle::scan::use(set);
+
+        auto best = std::numeric_limits<std::uint64_t>::max();
+        size_t tokens = 0;
+        for (size_t i = 0; i < repetitions; ++i)
+        {
+            tokens = 0;
+            const auto start = ticks();
+            for (const auto &src : sources)
+                tokens += riddle::lexer(symbols).tokenize(src).size();
+            best = std::min(best, ticks() - start);
+        }
+#ifdef RIDDLE_BENCH_CYCLES
+        const char *unit = "bytes/cycle";
+#else
+        const char *unit = "bytes/ns";
+#endif
+        std::cout << std::left << std::setw(24) << title << std::setw(8) << name(set) << std::right << std::setw(12) << bytes << " bytes " << std::setw(10) << tokens << " tokens " << std::fixed << std::setprecision(3) << std::setw(8) << static_cast<double>(bytes) / static_cast<double>(std::max<std::uint64_t>(best, 1)) << ' ' << unit << '\n';
+    }
+    riddle::scan::use(riddle::scan::supported());
+}
+
+static std::vector<std::string> read_corpus(const std::filesystem::path &dir)
+{
+    std::vector<std::string> sources;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(dir))
+        if (entry.is_regular_file() && entry.path().extension() == ".rddl")
+        {
+            std::ifstream ifs(entry.path(), std::ios::binary);
+            sources.emplace_back(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+    return sources;
+}
+
+static std::string synthetic(const std::string &chunk, size_t size)
+{
+    std::string src;
+    src.reserve(size + chunk.size());
+    while (src.size() < size)
+        src += chunk;
+    return src;
+}
+
+int main(int argc, char const *argv[])
+{
+    const std::filesystem::path examples = argc > 1 ? argv[1] : RIDDLE_EXAMPLES_DIR;
+    constexpr size_t size = 1 << 24;
+
+    run("examples", read_corpus(examples), 20);
+    run("mixed", {synthetic("class Robot : Agent {\n    real speed = 1.5;\n    predicate Move(Location from, Location to) { duration >= 10; }\n}\n", size)}, 5);
+    run("long identifiers", {synthetic("a_rather_long_identifier_naming_some_robot_location_in_the_plan = another_rather_long_identifier_naming_some_robot_location;\n", size)}, 5);
+    run("indentation", {synthetic("                                        x;\n", size)}, 5);
+    run("line comments", {synthetic("// a line comment describing, at length, what the following declarations are about\nx;\n", size)}, 5);
+    run("block comments", {synthetic("/*\n * a block comment describing, at length,\n * what the following declarations are about\n */\nx;\n", size)}, 5);
+    run("string literals", {synthetic("s = \"a string literal whose content is long enough to span a few vectors\";\n", size)}, 5);
+    return 0;
+}
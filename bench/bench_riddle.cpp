@@ -0,0 +1,137 @@
+#include "parser.hpp"
+#include "json.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0; // the number of allocations performed so far..
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+/**
+ * @brief The outcome of a measurement.
+ */
+struct measure
+{
+    double seconds = 0;     // the average duration of a run..
+    size_t tokens = 0;      // the number of tokens processed by a run..
+    size_t allocations = 0; // the number of allocations performed by a run..
+};
+
+/**
+ * @brief Runs the given function the given number of times, measuring the average duration and allocations of a run.
+ */
+template <typename F>
+measure run(size_t repetitions, F &&f)
+{
+    measure m;
+    const auto c_allocations = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i)
+        m.tokens = f();
+    m.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(repetitions);
+    m.allocations = (allocations - c_allocations) / repetitions;
+    return m;
+}
+
+static json::json to_json(const measure &m, size_t bytes)
+{
+    json::json j;
+    j["seconds"] = m.seconds;
+    j["mb_per_s"] = static_cast<double>(bytes) / (1024 * 1024) / m.seconds;
+    j["tokens_per_s"] = static_cast<double>(m.tokens) / m.seconds;
+    j["allocations_per_token"] = static_cast<double>(m.allocations) / static_cast<double>(std::max<size_t>(m.tokens, 1));
+    return j;
+}
+
+/**
+ * @brief Measures the lexer and the parser over the given source.
+ */
+static json::json bench(const std::string &name, const std::string &src)
+{
+    // small sources are processed repeatedly, so that each measurement lasts long enough..
+    const size_t repetitions = std::max<size_t>(1, (1 << 20) / std::max<size_t>(src.size(), 1));
+
+    riddle::symbol_table symbols;
+    const auto lex = run(repetitions, [&]()
+                         {
+                             std::istringstream is(src);
+                             return riddle::lexer(symbols).parse(is).size();
+                         });
+    const auto tokenize = run(repetitions, [&]()
+                              { return riddle::lexer(symbols).tokenize(src).size(); });
+    const auto parse = run(repetitions, [&]()
+                           {
+                               riddle::parser p(src, symbols);
+                               static_cast<void>(p.parse_compilation_unit());
+                               return tokenize.tokens;
+                           });
+
+    json::json j;
+    j["name"] = name;
+    j["bytes"] = static_cast<long long>(src.size());
+    j["tokens"] = static_cast<long long>(tokenize.tokens);
+    j["lexer"] = to_json(lex, src.size());
+    j["tokenize"] = to_json(tokenize, src.size());
+    j["parser"] = to_json(parse, src.size());
+    return j;
+}
+
+/**
+ * @brief Generates a syntactically valid RiDDLe source of at least the given size.
+ */
+static std::string synthetic(size_t size)
+{
+    std::string src;
+    src.reserve(size + 512);
+    for (size_t i = 0; src.size() < size; ++i)
+    {
+        const auto n = std::to_string(i);
+        src += "// robot " + n + "\nclass Robot" + n + " : Agent {\n    real speed = " + n + ".5;\n    Location home;\n\n    Robot" + n + "(Location home) : home(home) {}\n\n    /* moves the robot\n       between two locations */\n    predicate Move(Location from, Location to) {\n        duration >= 10 * speed;\n        goal at_from = new At(at: start, l: from);\n        { to != from; } or { duration == 0.0; }\n    }\n};\n\nreal amount" + n + " = [0.0, 100.0];\nfact f" + n + " = new Robot" + n + ".Move(from: \"depot\", to: \"site " + n + "\");\n";
+    }
+    return src;
+}
+
+int main(int argc, char const *argv[])
+{
+    // usage: riddle_bench [examples directory] [synthetic sizes, in MB, comma separated]..
+    const std::filesystem::path examples = argc > 1 ? argv[1] : RIDDLE_EXAMPLES_DIR;
+    const std::string sizes = argc > 2 ? argv[2] : "1,10,100";
+
+    json::json j_results(json::json_type::array);
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(examples))
+        if (entry.is_regular_file() && entry.path().extension() == ".rddl")
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    for (const auto &file : files)
+    {
+        std::ifstream ifs(file, std::ios::binary);
+        const std::string src{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+        j_results.push_back(bench(std::filesystem::relative(file, examples).generic_string(), src));
+    }
+
+    std::istringstream ss(sizes);
+    for (std::string mb; std::getline(ss, mb, ',');)
+        j_results.push_back(bench("synthetic_" + mb + "mb", synthetic(std::stoul(mb) << 20)));
+
+    json::json j_bench;
+    j_bench["library"] = "RiDDLe";
+    j_bench["version"] = RIDDLE_VERSION;
+    j_bench["results"] = std::move(j_results);
+    std::cout << j_bench.dump() << std::endl;
+    return 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace riddle
+{
+  /**
+   * @class arena arena.hpp "include/arena.hpp"
+   * @brief A monotonic memory arena.
+   *
+   * Memory is carved out of large chunks and is never returned to the arena: it is released all at once, when the arena is destroyed. Objects allocated from an arena must, therefore, be destroyed before the arena itself.
+   */
+  class arena final
+  {
+  public:
+    /**
+     * @brief Constructs a new arena.
+     *
+     * @param chunk_size The size of the chunks memory is carved out of.
+     */
+    arena(size_t chunk_size = 1 << 16) noexcept : chunk_size(chunk_size) {}
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    /**
+     * @brief Allocates the given number of bytes, suitably aligned for any scalar type.
+     *
+     * @param size The number of bytes to allocate.
+     * @return A pointer to the allocated memory.
+     */
+    [[nodiscard]] void *allocate(size_t size);
+
+    /**
+     * @brief Returns the number of bytes allocated from the arena so far.
+     */
+    [[nodiscard]] size_t allocated() const noexcept { return used; }
+
+  private:
+    const size_t chunk_size;                          // the size of the chunks..
+    std::vector<std::unique_ptr<std::byte[]>> chunks; // the chunks memory is carved out of..
+    std::byte *cur = nullptr;                         // the first free byte of the last chunk..
+    std::byte *end = nullptr;                         // the end of the last chunk..
+    size_t used = 0;                                  // the number of bytes allocated so far..
+  };
+
+  /**
+   * @class ast_node arena.hpp "include/arena.hpp"
+   * @brief A base for the nodes of the abstract syntax trees.
+   *
+   * Nodes created through `new (a) node(...)` are allocated from the arena `a`, so that the nodes of a compilation unit are laid out close to each other and their memory is released in one go, together with the arena. Nodes created through a plain `new` are allocated from the heap. Either way, nodes are owned and destroyed one by one, hence a header in front of each node tells the `delete` operator whether its memory is to be returned to the heap.
+   */
+  class ast_node
+  {
+  public:
+    static void *operator new(size_t size);
+    static void *operator new(size_t size, arena &a);
+    static void operator delete(void *ptr) noexcept;
+    static void operator delete(void *, arena &) noexcept {} // called if the constructor throws: the memory stays with the arena..
+  };
+
+  /**
+   * @brief Creates a node, allocating it from the given arena or, if null, from the heap.
+   *
+   * @tparam T The type of the node.
+   * @param a The arena to allocate the node from, which must outlive the node, or null.
+   * @param args The arguments of the constructor of the node.
+   * @return The created node.
+   */
+  template <typename T, typename... Args>
+  [[nodiscard]] std::unique_ptr<T> make_node(arena *a, Args &&...args)
+  {
+    if (a)
+      return std::unique_ptr<T>(new (*a) T(std::forward<Args>(args)...));
+    return std::make_unique<T>(std::forward<Args>(args)...);
+  }
+} // namespace riddle
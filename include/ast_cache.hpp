@@ -0,0 +1,159 @@
+#pragma once
+
+#include "compilation_unit.hpp"
+#include <unordered_map>
+
+namespace riddle
+{
+  /**
+   * @brief The version of the binary format of abstract syntax trees.
+   *
+   * It must be increased whenever the nodes, or the way they are written, change, so that stale caches are discarded.
+   */
+  constexpr std::uint32_t ast_format_version = 1;
+
+  /**
+   * @brief Hashes the given source through the 64-bit FNV-1a function.
+   *
+   * @param src The source to hash.
+   * @return The hash of the source.
+   */
+  [[nodiscard]] std::uint64_t content_hash(std::string_view src) noexcept;
+
+  /**
+   * @class ast_writer ast_cache.hpp "include/ast_cache.hpp"
+   * @brief Writes abstract syntax trees in a compact binary format.
+   *
+   * Integers are written as variable-length quantities, so that the format does not depend on the byte order of the machine. Identifiers are written once, in a table preceding the nodes, and are referred to through their index in the table.
+   */
+  class ast_writer final
+  {
+  public:
+    void write_bool(bool val) { body.push_back(val ? 1 : 0); }
+    void write_uint(std::uint64_t val);
+    void write_int(std::int64_t val) { write_uint((static_cast<std::uint64_t>(val) << 1) ^ static_cast<std::uint64_t>(val >> 63)); }
+    void write_string(std::string_view str);
+
+    void write(const id_token &tk);
+    void write(const bool_token &tk);
+    void write(const int_token &tk);
+    void write(const real_token &tk);
+    void write(const string_token &tk);
+    void write(const std::vector<id_token> &ids);
+
+    void write(const expression *xpr);
+    void write(const statement *stmt);
+    template <typename T>
+    void write(const std::vector<std::unique_ptr<T>> &nodes)
+    {
+      write_uint(nodes.size());
+      for (const auto &node : nodes)
+        write(node.get());
+    }
+    void write(const type_declaration *td);
+    void write(const field_declaration *fd);
+    void write(const constructor_declaration *cd);
+    void write(const method_declaration *md);
+    void write(const predicate_declaration *pd);
+
+    /**
+     * @brief Writes the node kind tag of the next node.
+     */
+    void tag(std::uint8_t kind) { body.push_back(static_cast<char>(kind)); }
+
+    /**
+     * @brief Returns the written trees, preceded by a header recording the format version and the hash of the source they come from.
+     *
+     * @param hash The hash of the source.
+     */
+    [[nodiscard]] std::string finish(std::uint64_t hash) const;
+
+  private:
+    std::string body;                                         // the written nodes..
+    std::vector<const std::string *> ids;                     // the written identifiers, in order of first appearance..
+    std::unordered_map<const std::string *, std::size_t> idx; // the index of the written identifiers, keyed by their interned address..
+  };
+
+  /**
+   * @class ast_reader ast_cache.hpp "include/ast_cache.hpp"
+   * @brief Reads abstract syntax trees written by an `ast_writer`.
+   */
+  class ast_reader final
+  {
+  public:
+    /**
+     * @brief Constructs a reader over the given data, validating its header.
+     *
+     * @param data The data to read. It must outlive the reader.
+     * @param hash The hash of the source the trees are expected to come from.
+     * @param symbols The symbol table in which the identifiers are interned.
+     * @param nodes The arena the nodes are allocated from, which must outlive them, or null for the heap.
+     * @throws std::runtime_error If the data has not been written with the current format, for a source with the given hash.
+     */
+    ast_reader(std::string_view data, std::uint64_t hash, symbol_table &symbols, arena *nodes = nullptr);
+
+    [[nodiscard]] bool read_bool();
+    [[nodiscard]] std::uint64_t read_uint();
+    [[nodiscard]] std::int64_t read_int()
+    {
+      const auto val = read_uint();
+      return static_cast<std::int64_t>(val >> 1) ^ -static_cast<std::int64_t>(val & 1);
+    }
+    [[nodiscard]] std::string_view read_string();
+
+    [[nodiscard]] id_token read_id();
+    [[nodiscard]] std::vector<id_token> read_ids();
+    [[nodiscard]] bool_token read_bool_token();
+    [[nodiscard]] int_token read_int_token();
+    [[nodiscard]] real_token read_real_token();
+    [[nodiscard]] string_token read_string_token();
+
+    [[nodiscard]] std::unique_ptr<expression> read_expression();
+    [[nodiscard]] std::vector<std::unique_ptr<expression>> read_expressions();
+    [[nodiscard]] std::unique_ptr<statement> read_statement();
+    [[nodiscard]] std::vector<std::unique_ptr<statement>> read_statements();
+    [[nodiscard]] std::unique_ptr<conjunction_statement> read_conjunction();
+    [[nodiscard]] std::unique_ptr<type_declaration> read_type_declaration();
+    [[nodiscard]] std::unique_ptr<field_declaration> read_field_declaration();
+    [[nodiscard]] std::unique_ptr<constructor_declaration> read_constructor_declaration();
+    [[nodiscard]] std::unique_ptr<method_declaration> read_method_declaration();
+    [[nodiscard]] std::unique_ptr<predicate_declaration> read_predicate_declaration();
+
+    /**
+     * @brief Checks whether all the data has been read.
+     */
+    [[nodiscard]] bool done() const noexcept { return pos == data.size(); }
+
+  private:
+    [[nodiscard]] std::uint8_t read_byte();
+    [[nodiscard]] std::vector<std::pair<std::vector<id_token>, id_token>> read_params();
+    [[nodiscard]] std::vector<std::pair<id_token, std::unique_ptr<expression>>> read_inits();
+
+    template <typename T, typename... Args>
+    [[nodiscard]] std::unique_ptr<T> make_node(Args &&...args) { return riddle::make_node<T>(nodes, std::forward<Args>(args)...); }
+
+  private:
+    const std::string_view data;          // the data to read..
+    arena *const nodes;                   // the arena the nodes are allocated from, if any..
+    std::size_t pos = 0;                  // the current position within the data..
+    std::vector<const std::string *> ids; // the interned identifiers of the table..
+  };
+
+  /**
+   * @brief Serializes the given compilation unit.
+   *
+   * @param cu The compilation unit to serialize.
+   * @param hash The hash of the source the compilation unit comes from.
+   * @return The serialized compilation unit.
+   */
+  [[nodiscard]] std::string serialize(const compilation_unit &cu, std::uint64_t hash);
+  /**
+   * @brief Deserializes a compilation unit, allocating its nodes from a new arena.
+   *
+   * @param data The serialized compilation unit.
+   * @param hash The hash of the source the compilation unit is expected to come from.
+   * @param symbols The symbol table in which the identifiers are interned.
+   * @return The compilation unit, or `nullptr` if the data is stale or corrupted.
+   */
+  [[nodiscard]] std::unique_ptr<compilation_unit> deserialize(std::string_view data, std::uint64_t hash, symbol_table &symbols);
+} // namespace riddle
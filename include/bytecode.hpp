@@ -0,0 +1,207 @@
+#pragma once
+
+#include "statement.hpp"
+#include <cstdint>
+#include <mutex>
+
+namespace riddle
+{
+  /**
+   * @brief The operations of the bytecode.
+   *
+   * The operations act on a stack of items: the operands of each operation are popped from the stack, in the order they have been pushed, and its result, if any, is pushed on the stack.
+   */
+  enum class opcode : std::uint8_t
+  {
+    push_null,           // pushes a null item..
+    push_bool,           // pushes the boolean `a`..
+    push_int,            // pushes the integer constant `a`..
+    push_bounded_int,    // pushes an integer variable within the integer constants `a` and `b`..
+    push_uncertain_int,  // pushes an uncertain integer within the integer constants `a` and `b`..
+    push_real,           // pushes the real constant `a`..
+    push_bounded_real,   // pushes a real variable within the real constants `a` and `b`..
+    push_uncertain_real, // pushes an uncertain real within the real constants `a` and `b`..
+    push_string,         // pushes the string constant `a`..
+    load,                // pushes the item of slot `a`..
+    try_load,            // pushes the item of slot `a`, or a null item if it is not found..
+    get_item,            // replaces the object on top of the stack with its item named `a`..
+    bool_and,            // pushes the conjunction of `a` items..
+    bool_or,             // pushes the disjunction of `a` items..
+    bool_xor,            // pushes the exclusive disjunction of `a` items..
+    bool_not,            // pushes the negation of an item..
+    minus,               // pushes the opposite of an item..
+    sum,                 // pushes the sum of `a` items..
+    subtraction,         // pushes the subtraction of `a` items..
+    product,             // pushes the product of `a` items..
+    division,            // pushes the division of `a` items..
+    lt,                  // pushes the `<` comparison of two items..
+    le,                  // pushes the `<=` comparison of two items..
+    gt,                  // pushes the `>` comparison of two items..
+    ge,                  // pushes the `>=` comparison of two items..
+    eq,                  // pushes the `==` comparison of two items..
+    instantiate,         // pushes a new instance of type `a`, constructed from `b` items through the constructor cached by `c`..
+    invoke,              // pushes the result of method `a` invoked on an object, or on a null item, with `b` items through the method cached by `c`..
+    declare,             // stores, into slot `b`, a new local of type `a`, initialized with an item if `c` is set..
+    assert_constraint,   // asserts an item..
+    disjunction,         // creates a disjunction of the blocks from `a` to `a + b`, popping their costs..
+    for_all_begin,       // begins iterating over the instances of type `a`..
+    for_all_next,        // stores, into slot `a`, the next instance of the innermost iteration, or ends it and jumps to `b`..
+    jump,                // jumps to `a`..
+    store_return,        // stores an item into slot `a`, unless a value has already been returned..
+    new_atom,            // stores, into slot `b`, a new atom of formula `a`, popping its arguments and its tau..
+    execute              // executes the statement `a` through the tree walker..
+  };
+
+  /**
+   * @brief An instruction of the bytecode.
+   *
+   * The meaning of the operands depends on the operation: they are either immediate values (e.g., slots, counts and jump targets), or indexes into the typed constant pools of the program.
+   */
+  struct instruction
+  {
+    opcode op;           // the operation..
+    std::uint32_t a = 0; // the first operand..
+    std::uint32_t b = 0; // the second operand..
+    std::uint32_t c = 0; // the third operand..
+  };
+
+  /**
+   * @class program bytecode.hpp "include/bytecode.hpp"
+   * @brief A body compiled into a linear bytecode.
+   *
+   * Programs are an alternative to walking the trees of the bound bodies: they are compiled from the trees once, the first time a body is run as bytecode, and are run by a dispatch loop against the same `core` interface. The constants of a program refer to the trees it has been compiled from, which must outlive it.
+   */
+  class program final
+  {
+    friend class program_compiler;
+
+  public:
+    /**
+     * @brief Compiles the given bound statements.
+     *
+     * @param stmts The statements to compile.
+     * @return The compiled program.
+     */
+    [[nodiscard]] static program compile(const std::vector<std::unique_ptr<statement>> &stmts);
+
+    /**
+     * @brief Runs the program within the given scope and frame.
+     *
+     * @param scp The scope in which the program is run.
+     * @param ctx The frame in which the program is run, laid out as the statements the program has been compiled from.
+     */
+    void run(const scope &scp, frame &ctx) const;
+
+    /**
+     * @brief Returns the instructions of the program.
+     */
+    [[nodiscard]] const std::vector<instruction> &get_code() const noexcept { return code; }
+
+  private:
+    /**
+     * @brief The description of a formula.
+     */
+    struct formula
+    {
+      bool is_fact;                       // whether the formula is a fact or a goal..
+      bool qualified;                     // whether the predicate is qualified by the tau..
+      std::string_view predicate_name;    // the name of the predicate..
+      std::vector<std::string_view> args; // the names of the arguments, in the order they are pushed..
+      predicate *const *resolved;         // the predicate of the unqualified formulas, once checked..
+    };
+
+    /**
+     * @brief A reference to a type, by name and by the type the name has been resolved to while checking.
+     */
+    struct type_ref
+    {
+      const std::vector<id_token> *tp_id; // the possibly qualified name of the type..
+      type *const *resolved;              // the type the name has been resolved to, once checked..
+    };
+
+    std::vector<instruction> code;                                 // the instructions..
+    std::vector<INT_TYPE> ints;                                    // the integer constants..
+    std::vector<utils::rational> reals;                            // the real constants..
+    std::vector<std::string_view> names;                           // the names and the string constants..
+    std::vector<type_ref> types;                                   // the type references..
+    std::vector<formula> formulas;                                 // the formulas..
+    std::vector<const statement *> statements;                     // the statements executed through the tree walker..
+    std::vector<overload_cache<constructor> *> constructor_caches; // the caches of the constructor call sites..
+    std::vector<overload_cache<method> *> method_caches;           // the caches of the method call sites..
+    std::vector<program> blocks;                                   // the blocks of the disjunctions..
+  };
+
+  /**
+   * @class lazy_program bytecode.hpp "include/bytecode.hpp"
+   * @brief A body which is compiled into a program the first time it is run.
+   *
+   * The declarations hold their bodies as lazy programs, so that the cores walking the trees, as they do by default, never pay for compiling them.
+   */
+  class lazy_program final
+  {
+  public:
+    explicit lazy_program(const std::vector<std::unique_ptr<statement>> &stmts) noexcept : stmts(stmts) {}
+    lazy_program(const lazy_program &) = delete;
+
+    /**
+     * @brief Runs the program within the given scope and frame, compiling the statements first if they have not been compiled yet.
+     *
+     * @param scp The scope in which the program is run.
+     * @param ctx The frame in which the program is run, laid out as the statements the program is compiled from.
+     */
+    void run(const scope &scp, frame &ctx) const;
+
+  private:
+    const std::vector<std::unique_ptr<statement>> &stmts; // the statements the program is compiled from..
+    mutable std::once_flag compiled;                      // compiles the statements once, even when run concurrently..
+    mutable std::unique_ptr<program> code;                // the compiled program, once run..
+  };
+
+  /**
+   * @class program_compiler bytecode.hpp "include/bytecode.hpp"
+   * @brief Compiles bound trees into a program.
+   */
+  class program_compiler final
+  {
+  public:
+    /**
+     * @brief Appends the given instruction, returning its position.
+     */
+    std::uint32_t emit(opcode op, std::uint32_t a = 0, std::uint32_t b = 0, std::uint32_t c = 0);
+    /**
+     * @brief Returns the position of the next instruction.
+     */
+    [[nodiscard]] std::uint32_t here() const noexcept { return static_cast<std::uint32_t>(prog.code.size()); }
+    /**
+     * @brief Sets the exit target of the iteration at the given position to the next instruction.
+     */
+    void patch(std::uint32_t pos) noexcept { prog.code[pos].b = here(); }
+
+    [[nodiscard]] std::uint32_t add_int(INT_TYPE val);
+    [[nodiscard]] std::uint32_t add_real(const utils::rational &val);
+    [[nodiscard]] std::uint32_t add_name(std::string_view name);
+    [[nodiscard]] std::uint32_t add_type(const std::vector<id_token> &tp_id, type *const &resolved);
+    [[nodiscard]] std::uint32_t add_formula(bool is_fact, bool qualified, std::string_view predicate_name, std::vector<std::string_view> &&args, predicate *const &resolved);
+    [[nodiscard]] std::uint32_t add_statement(const statement &stmt);
+    [[nodiscard]] std::uint32_t add_cache(overload_cache<constructor> &cache);
+    [[nodiscard]] std::uint32_t add_cache(overload_cache<method> &cache);
+    [[nodiscard]] std::uint32_t add_block(const std::vector<std::unique_ptr<statement>> &stmts);
+
+    /**
+     * @brief Compiles the given expression, which pushes its value.
+     */
+    void compile(const expression &xpr) { xpr.compile(*this); }
+    /**
+     * @brief Compiles the given statement.
+     */
+    void compile(const statement &stmt) { stmt.compile(*this); }
+
+    /**
+     * @brief Returns the compiled program.
+     */
+    [[nodiscard]] program finish() { return std::move(prog); }
+
+  private:
+    program prog; // the program being compiled..
+  };
+} // namespace riddle
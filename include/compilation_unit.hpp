@@ -7,14 +7,52 @@ namespace riddle
   class compilation_unit
   {
   public:
-    compilation_unit(std::vector<std::unique_ptr<type_declaration>> &&types, std::vector<std::unique_ptr<method_declaration>> &&methods, std::vector<std::unique_ptr<predicate_declaration>> &&predicates, std::vector<std::unique_ptr<statement>> &&statements) : types(std::move(types)), methods(std::move(methods)), predicates(std::move(predicates)), body(std::move(statements)) {}
+    /**
+     * @brief Constructs a new compilation unit.
+     *
+     * @param types The type declarations.
+     * @param methods The method declarations.
+     * @param predicates The predicate declarations.
+     * @param statements The statements.
+     * @param nodes The arena the nodes of the compilation unit have been allocated from, if any. It is kept alive as long as the compilation unit.
+     */
+    compilation_unit(std::vector<std::unique_ptr<type_declaration>> &&types, std::vector<std::unique_ptr<method_declaration>> &&methods, std::vector<std::unique_ptr<predicate_declaration>> &&predicates, std::vector<std::unique_ptr<statement>> &&statements, std::shared_ptr<arena> nodes = nullptr) : compilation_unit(std::move(types), std::move(methods), std::move(predicates), std::move(statements), std::vector<std::shared_ptr<arena>>{std::move(nodes)}) {}
+    /**
+     * @brief Constructs a new compilation unit whose nodes have been allocated from more arenas.
+     *
+     * @param types The type declarations.
+     * @param methods The method declarations.
+     * @param predicates The predicate declarations.
+     * @param statements The statements.
+     * @param nodes The arenas the nodes of the compilation unit have been allocated from. They are kept alive as long as the compilation unit.
+     */
+    compilation_unit(std::vector<std::unique_ptr<type_declaration>> &&types, std::vector<std::unique_ptr<method_declaration>> &&methods, std::vector<std::unique_ptr<predicate_declaration>> &&predicates, std::vector<std::unique_ptr<statement>> &&statements, std::vector<std::shared_ptr<arena>> &&nodes) : nodes(std::move(nodes)), types(std::move(types)), methods(std::move(methods)), predicates(std::move(predicates)), body(std::move(statements)) {}
+
+    /**
+     * @brief Checks whether the compilation unit declares any type, method or predicate.
+     */
+    [[nodiscard]] bool has_declarations() const noexcept { return !types.empty() || !methods.empty() || !predicates.empty(); }
+    /**
+     * @brief Checks whether the compilation unit contains any statement.
+     */
+    [[nodiscard]] bool has_statements() const noexcept { return !body.empty(); }
 
     void declare(scope &scp) const;
     void refine(scope &scp) const;
     void refine_predicates(scope &scp) const;
+    /**
+     * @brief Checks the types of the statements, declaring the global items they introduce into the given context.
+     */
+    void check_statements(type_context &globals) const;
+    /**
+     * @brief Checks the types of the bodies of the declarations against the given global items.
+     */
+    void check(const scope &scp, const type_context &globals) const;
     void execute(const scope &scp, env &ctx) const;
+    void write(ast_writer &w) const;
 
   private:
+    std::vector<std::shared_ptr<arena>> nodes;                      // The arenas the nodes have been allocated from, which must outlive them.
     std::vector<std::unique_ptr<type_declaration>> types;           // The type declarations.
     std::vector<std::unique_ptr<method_declaration>> methods;       // The method declarations.
     std::vector<std::unique_ptr<predicate_declaration>> predicates; // The predicate declarations.
@@ -1,13 +1,23 @@
 #pragma once
 
 #include "statement.hpp"
+#include "frame.hpp"
 
 namespace riddle
 {
   class conjunction final
   {
   public:
-    conjunction(const scope &scp, env &&ctx, const utils::rational cst = utils::rational::one, const std::vector<std::unique_ptr<statement>> &body = {}) noexcept;
+    conjunction(const scope &scp, frame &&ctx, const utils::rational cst = utils::rational::one, const std::vector<std::unique_ptr<statement>> &body = {}) noexcept;
+    /**
+     * @brief Constructs a conjunction whose body is compiled into bytecode.
+     *
+     * @param scp The scope in which the conjunction is evaluated.
+     * @param ctx The frame in which the conjunction is evaluated.
+     * @param cst The cost of the conjunction.
+     * @param code The body of the conjunction, compiled into bytecode.
+     */
+    conjunction(const scope &scp, frame &&ctx, const utils::rational cst, const program &code) noexcept;
 
     /**
      * @brief Executes the conjunction operation.
@@ -19,8 +29,9 @@ namespace riddle
 
   private:
     const scope &scp;                                    // the scope in which the conjunction is evaluated
-    env ctx;                                             // the environment context
+    frame ctx;                                           // the environment context
     utils::rational cst;                                 // the cost of the conjunction
     const std::vector<std::unique_ptr<statement>> &body; // the body of the conjunction
+    const program *code = nullptr;                       // the body of the conjunction, if compiled into bytecode
   };
 } // namespace riddle
@@ -8,7 +8,7 @@ namespace riddle
   class constructor final : public scope
   {
   public:
-    constructor(scope &scp, std::vector<std::unique_ptr<field>> &&args = {}, const std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &inits = {}, const std::vector<std::unique_ptr<statement>> &body = {}) noexcept;
+    constructor(scope &scp, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &inits, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept;
     constructor(const constructor &) = delete;
 
     /**
@@ -26,5 +26,7 @@ namespace riddle
     std::vector<std::string> args;                                                           // The names of the arguments.
     const std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &inits; // The initializations.
     const std::vector<std::unique_ptr<statement>> &body;                                     // The body of the constructor.
+    const frame_layout &layout;                                                              // The layout of the frames the constructor is invoked in.
+    const lazy_program &code;                                                                // The body of the constructor, compiled into bytecode.
   };
 } // namespace riddle
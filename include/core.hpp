@@ -4,8 +4,13 @@
 #include "inf_rational.hpp"
 #include "type.hpp"
 #include "parser.hpp"
+#include "term_pool.hpp"
 #include <unordered_set>
+#include <unordered_map>
+#include <set>
+#include <map>
 #include <filesystem>
+#include <optional>
 
 namespace riddle
 {
@@ -21,9 +26,12 @@ namespace riddle
     friend class method_declaration;
     friend class class_declaration;
     friend class predicate_declaration;
+    friend class component_type;
+    friend class expression_statement;
+    friend class local_field_statement;
+    friend class formula_statement;
 #ifdef COMPUTE_NAMES
     friend class component;
-    friend class component_type;
 #endif
     friend class enum_term;
 
@@ -48,6 +56,75 @@ namespace riddle
      */
     [[nodiscard]] std::string get_name() const noexcept { return name; }
 
+    /**
+     * @brief Retrieves the symbol table of the core.
+     *
+     * The identifiers of the compilation units read by this core are interned in this table, which lives as long as the core.
+     *
+     * @return symbol_table& The symbol table.
+     */
+    [[nodiscard]] symbol_table &get_symbols() noexcept { return symbols; }
+
+    /**
+     * @brief Retrieves the maximum number of threads used for parsing files.
+     *
+     * @return size_t The maximum number of threads.
+     */
+    [[nodiscard]] size_t get_parse_threads() const noexcept { return parse_threads; }
+    /**
+     * @brief Sets the maximum number of threads used for parsing files.
+     *
+     * Files read through `read(const std::vector<std::filesystem::path> &)` are parsed concurrently by up to this many threads, including the calling one. A value of one parses the files sequentially.
+     *
+     * @param n The maximum number of threads.
+     */
+    void set_parse_threads(size_t n) noexcept { parse_threads = std::max<size_t>(n, 1); }
+
+    /**
+     * @brief Retrieves the directory of the abstract syntax tree cache.
+     *
+     * @return const std::optional<std::filesystem::path>& The directory of the cache, empty if the cached trees are stored beside their sources, or `std::nullopt` if the cache is disabled.
+     */
+    [[nodiscard]] const std::optional<std::filesystem::path> &get_ast_cache() const noexcept { return ast_cache_dir; }
+    /**
+     * @brief Sets the directory of the abstract syntax tree cache.
+     *
+     * Files read through `read(const std::vector<std::filesystem::path> &)` are parsed once: their abstract syntax trees are stored in a binary cache, keyed by a hash of their content, and are loaded from the cache, rather than reparsed, as long as the content does not change. The cached trees are stored beside their sources, as `<file>.ast`, if the given directory is empty, and in the given directory, as `<hash>.ast`, otherwise. The cache is disabled by default.
+     *
+     * @param dir The directory of the cache, empty for storing the cached trees beside their sources, or `std::nullopt` for disabling the cache.
+     */
+    void set_ast_cache(std::optional<std::filesystem::path> dir) { ast_cache_dir = std::move(dir); }
+
+    /**
+     * @brief Checks whether the bodies of the methods, constructors and predicates are run as bytecode.
+     *
+     * @return true if the bodies are run as bytecode, false if they are walked as trees.
+     */
+    [[nodiscard]] bool uses_bytecode() const noexcept { return bytecode; }
+    /**
+     * @brief Sets whether the bodies of the methods, constructors and predicates are run as bytecode.
+     *
+     * The bodies are compiled into a linear bytecode the first time they are run, so that the cores walking the trees never compile them, and the compiled programs are run by a dispatch loop, rather than by walking the trees of the statements, if enabled. The trees remain the reference implementation: both are expected to produce the same items, constraints and atoms. The bytecode is disabled by default.
+     *
+     * @param enable Whether to run the bodies as bytecode.
+     */
+    void set_bytecode(bool enable) noexcept { bytecode = enable; }
+
+    /**
+     * @brief Checks whether the boolean and comparison terms are hash-consed.
+     *
+     * @return true if the terms are hash-consed, false otherwise.
+     */
+    [[nodiscard]] bool uses_hash_consing() const noexcept { return hash_consing; }
+    /**
+     * @brief Sets whether the boolean and comparison terms are hash-consed.
+     *
+     * If enabled, the `new_and`, `new_or`, `new_xor`, `new_not`, `new_lt`, `new_le`, `new_eq`, `new_gt` and `new_ge` functions return the existing term, as long as it is alive, rather than a new one, when called with the same operands, and neither `assert_expr` nor the constraint statements post again a term which is alive and has already been asserted within the same resolver. Hash-consing is disabled by default.
+     *
+     * @param enable Whether to hash-cons the terms.
+     */
+    void set_hash_consing(bool enable) noexcept { hash_consing = enable; }
+
     /**
      * @brief Reads and processes the given RiDDLe script.
      *
@@ -56,6 +133,14 @@ namespace riddle
      * @param script The RiDDLe script.
      */
     virtual void read(std::string_view script);
+    /**
+     * @brief Reads and processes the RiDDLe script from the given input stream.
+     *
+     * The script is parsed incrementally: the declarations are processed as soon as the following statement is parsed, and each statement is executed as soon as it is parsed, so that the source is never held in memory as a whole. Declarations, hence, must precede the statements which use them. Each element is allocated from an arena of its own, and the executed statements are dropped, together with their nodes, unless the terms they created refer to them (e.g., disjunctions), so that the memory taken by the script does not grow with the number of its statements.
+     *
+     * @param is The input stream.
+     */
+    virtual void read(std::istream &is);
     /**
      * @brief Reads and processes the given RiDDLe files.
      *
@@ -64,6 +149,15 @@ namespace riddle
      * @param files The RiDDLe files.
      */
     virtual void read(const std::vector<std::filesystem::path> &files);
+    /**
+     * @brief Reads again the given RiDDLe files, processing only the ones which changed since they were last read.
+     *
+     * Each file is fingerprinted through a hash of its content. Files which have not been read before are processed as by `read(const std::vector<std::filesystem::path> &)`. Unchanged files are skipped. Changed files must have been read through this function, since the problem of a file is recorded only then, and must contain statements only: the problem defined by their previous version (i.e., its items, instances, atoms and constraints) is retracted, and their statements are executed against the declarations already in place. Retracting a problem requires a backend implementing `retract`.
+     *
+     * @param files The RiDDLe files.
+     * @throws std::runtime_error If a changed file declares, or used to declare, types, methods or predicates.
+     */
+    virtual void reload(const std::vector<std::filesystem::path> &files);
 
     /**
      * @brief Create a new bool expression.
@@ -426,7 +520,28 @@ namespace riddle
      * @param args An optional map of arguments where the key is a string and the value is a shared pointer to an item. Defaults to an empty map.
      * @return A shared pointer to the newly created atom.
      */
-    [[nodiscard]] atom_expr new_atom(bool is_fact, predicate &pred, std::map<std::string, expr, std::less<>> &&args = {});
+    [[nodiscard]] atom_expr new_atom(bool is_fact, predicate &pred, item_map &&args = {});
+
+    /**
+     * @brief Creates a new term of the given type.
+     *
+     * Terms are allocated, together with their reference counts, from the size-class pools of the core when the library is built with the `TERM_POOLS` option, and from the global allocator otherwise. Cores are expected to create their terms through this function.
+     *
+     * @tparam Tp The type of the term to create.
+     * @tparam Args The types of the arguments to pass to the term.
+     * @param args The arguments to pass to the term.
+     * @return std::shared_ptr<Tp> The created term.
+     */
+    template <typename Tp, typename... Args>
+    [[nodiscard]] std::shared_ptr<Tp> new_term(Args &&...args)
+    {
+      static_assert(std::is_base_of_v<term, Tp>, "Tp must be a subclass of term");
+#ifdef TERM_POOLS
+      return std::allocate_shared<Tp>(pool_allocator<Tp>(term_alloc), std::forward<Args>(args)...);
+#else
+      return std::make_shared<Tp>(std::forward<Args>(args)...);
+#endif
+    }
     [[nodiscard]] virtual atom_state get_atom_state(const atom_term &atm) const noexcept = 0;
 
     [[nodiscard]] field &get_field(std::string_view name) const override;
@@ -541,7 +656,7 @@ namespace riddle
 #endif
 
   private:
-    [[nodiscard]] virtual atom_expr create_atom(bool is_fact, predicate &pred, std::map<std::string, expr, std::less<>> &&args = {}) = 0;
+    [[nodiscard]] virtual atom_expr create_atom(bool is_fact, predicate &pred, item_map &&args = {}) = 0;
 
     virtual bool mk_assign(bool_expr xpr, utils::lbool val) noexcept = 0;
     virtual bool mk_eq(bool_expr lhs, bool_expr rhs) noexcept = 0;
@@ -562,13 +677,150 @@ namespace riddle
     virtual bool mk_eq(enum_expr lhs, enum_expr rhs) noexcept = 0;
     virtual bool mk_neq(enum_expr lhs, enum_expr rhs) noexcept = 0;
 
+    /**
+     * @brief Retracts the problem defined by the previous version of a reloaded file.
+     *
+     * Backends supporting `reload` must retract the given asserted terms, whether they have been posted through `assert_expr` or as clauses, along with anything they created for the given atoms and for the disjunctions posted while the statements of the file were executed. Once this function returns, the core removes the given instances and atoms from their types and predicates, and the items of the file from its environment, and destroys the statements of the previous version. The default implementation throws, leaving the core untouched, so that reloading is available only to the backends which implement it.
+     *
+     * @param terms The instances, the atoms and the clauses created by the statements of the previous version of the file, along with the terms it asserted which are not asserted by any other statement.
+     * @throws std::runtime_error if the backend does not support retracting terms.
+     */
+    virtual void retract(const std::vector<expr> &terms);
+
+  private:
+    /**
+     * @brief The kinds of the hash-consed terms.
+     */
+    enum class cons_kind : std::uint8_t
+    {
+      and_kind,
+      or_kind,
+      xor_kind,
+      not_kind,
+      lt_kind,
+      le_kind,
+      eq_kind,
+      gt_kind,
+      ge_kind
+    };
+
+    /**
+     * @brief The key of a hash-consed term: its kind and the identities of its operands.
+     */
+    struct cons_key
+    {
+      cons_kind kind;
+      std::vector<const term *> args;
+
+      bool operator==(const cons_key &other) const noexcept { return kind == other.kind && args == other.args; }
+    };
+
+    struct cons_key_hash
+    {
+      std::size_t operator()(const cons_key &key) const noexcept;
+    };
+
+    /**
+     * @brief An asserted term, along with the resolver it has been asserted within, referred to weakly so as not to extend their lifetimes.
+     */
+    using assertion = std::pair<std::weak_ptr<resolver>, std::weak_ptr<bool_term>>;
+
+    /**
+     * @brief Orders the assertions by the identities of their resolvers and of their terms, which are retained even once these have died.
+     */
+    struct assertion_less
+    {
+      bool operator()(const assertion &lhs, const assertion &rhs) const noexcept
+      {
+        if (lhs.first.owner_before(rhs.first))
+          return true;
+        if (rhs.first.owner_before(lhs.first))
+          return false;
+        return lhs.second.owner_before(rhs.second);
+      }
+    };
+
+    /**
+     * @brief Returns the term of the given kind with the given operands, creating it through the given function unless the terms are hash-consed and an identical term is alive.
+     */
+    template <typename Make>
+    bool_expr cons(cons_kind kind, std::vector<const term *> &&args, Make &&make);
+
+    /**
+     * @brief Counts an assertion of the given term within the current resolver, returning whether it is the first one, hence the term is to be posted.
+     */
+    bool add_assertion(const bool_expr &xpr);
+
+    /**
+     * @brief Posts the given boolean expression to the backend, through the `mk_*` functions.
+     *
+     * @param xpr The boolean expression to be posted.
+     * @return true if the posting was successful, false otherwise.
+     */
+    bool post_expr(bool_expr xpr) noexcept;
+
   private:
+    /**
+     * @brief Parses the given files, concurrently if allowed by the number of parse threads.
+     *
+     * @param files The files to parse.
+     * @param hashes The hashes of the contents of the files, filled in by the function.
+     * @param incremental Whether the files which have not changed since they were last read should be skipped, leaving a null compilation unit in their place.
+     * @return The compilation units of the files.
+     */
+    [[nodiscard]] std::vector<std::unique_ptr<compilation_unit>> parse_files(const std::vector<std::filesystem::path> &files, std::vector<std::uint64_t> &hashes, bool incremental);
+    /**
+     * @brief A file read by the core.
+     */
+    struct loaded_file
+    {
+      std::uint64_t hash;                                                    // the hash of the content of the file..
+      bool domain;                                                           // whether the file declares types, methods or predicates..
+      bool retractable;                                                      // whether the file has been read through `reload`, its problem being recorded so as to be retracted..
+      const compilation_unit *cu;                                            // the compilation unit of the file..
+      std::vector<std::string> items;                                        // the items defined by the statements of the file, if retractable..
+      std::vector<expr> terms;                                               // the instances, the atoms and the clauses created by the statements of the file, if retractable..
+      std::vector<std::pair<std::weak_ptr<resolver>, bool_expr>> assertions; // the terms asserted by the statements of the file, along with the resolvers they have been asserted within, if retractable..
+    };
+
+    /**
+     * @brief Executes the statements of the given compilation unit, recording in the given file the items and the terms they define so that they can be retracted.
+     */
+    void execute(loaded_file &file, const compilation_unit &cu);
+    /**
+     * @brief Notifies the core that a global item with the given name has been defined, recording it into the file being executed, if any.
+     */
+    void item_defined(std::string_view id)
+    {
+      if (c_file)
+        c_file->items.emplace_back(id);
+    }
+    /**
+     * @brief Retracts the problem defined by the statements of the given file, letting the backend retract it before removing its items, instances and atoms from the core.
+     */
+    void retract_file(loaded_file &file);
+
+  private:
+    symbol_table symbols;                                                             // the symbol table of the core, declared first so as to outlive everything referring to it..
     const std::string name;                                                           // the name of the core..
+    size_t parse_threads;                                                             // the maximum number of threads used for parsing files..
+    std::optional<std::filesystem::path> ast_cache_dir;                               // the directory of the abstract syntax tree cache, if enabled..
+    bool bytecode = false;                                                            // whether the bodies are run as bytecode..
+    bool hash_consing = false;                                                        // whether the boolean and comparison terms are hash-consed..
+#ifdef TERM_POOLS
+    pool_allocator<term> term_alloc; // the allocator of the terms created by the core..
+#endif
     std::map<std::string, std::vector<std::unique_ptr<method>>, std::less<>> methods; // the methods declared in the core..
     std::map<std::string, std::unique_ptr<type>, std::less<>> types;                  // the types declared in the core..
     std::map<std::string, std::unique_ptr<predicate>, std::less<>> predicates;        // the predicates declared in the core..
     std::shared_ptr<resolver> c_res;                                                  // the current resolver..
+    std::unordered_map<cons_key, std::weak_ptr<bool_term>, cons_key_hash> consed;     // the hash-consed terms..
+    std::size_t consed_purge = 1024;                                                  // the number of hash-consed terms beyond which the dead ones are purged..
+    std::map<assertion, std::size_t, assertion_less> asserted;                        // the number of times each term has been asserted within each resolver, if hash-consed..
+    std::size_t asserted_purge = 1024;                                                // the number of assertions beyond which the dead ones are purged..
     std::vector<std::unique_ptr<compilation_unit>> cus;                               // the compilation units read by the core..
+    std::map<std::filesystem::path, loaded_file> loaded_files;                        // the files read by the core, keyed by their normalized path..
+    loaded_file *c_file = nullptr;                                                    // the file whose statements are being executed, if any..
 
 #ifdef COMPUTE_NAMES
     std::unordered_map<const term *, const std::string> expr_names; // the names of the expressions..
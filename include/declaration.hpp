@@ -1,13 +1,13 @@
 #pragma once
 
-#include "statement.hpp"
+#include "bytecode.hpp"
 
 namespace riddle
 {
   class compilation_unit;
   class class_declaration;
 
-  class type_declaration
+  class type_declaration : public ast_node
   {
     friend class compilation_unit;
     friend class class_declaration;
@@ -16,6 +16,13 @@ namespace riddle
     type_declaration() = default;
     virtual ~type_declaration() = default;
 
+    /**
+     * @brief Writes the declaration through the given writer.
+     *
+     * @param w The writer.
+     */
+    virtual void write(ast_writer &w) const = 0;
+
   private:
     /**
      * @brief Declares a type within the given scope.
@@ -39,6 +46,15 @@ namespace riddle
      * @param scope A reference to the scope in which the declaration is made.
      */
     virtual void refine_predicates(scope &) const {}
+    /**
+     * @brief Checks the types of the bodies of a type within the given scope.
+     *
+     * This method is called after all predicates have been refined, and annotates the expressions of the bodies with their static types.
+     *
+     * @param scope A reference to the scope in which the declaration is made.
+     * @param globals The context of the global items.
+     */
+    virtual void check(const scope &, const type_context &) const {}
   };
 
   class enum_declaration final : public type_declaration
@@ -46,6 +62,8 @@ namespace riddle
   public:
     enum_declaration(id_token &&name, std::vector<string_token> &&values, std::vector<std::vector<id_token>> &&enum_refs) : name(std::move(name)), values(std::move(values)), enum_refs(std::move(enum_refs)) {}
 
+    void write(ast_writer &w) const override;
+
   private:
     void declare(scope &scp) const override;
     void refine(scope &scp) const override;
@@ -56,69 +74,84 @@ namespace riddle
     std::vector<std::vector<id_token>> enum_refs;
   };
 
-  class field_declaration final
+  class field_declaration final : public ast_node
   {
     friend class class_declaration;
 
   public:
     field_declaration(std::vector<id_token> &&tp, std::vector<std::pair<id_token, std::unique_ptr<expression>>> &&fields) : tp(std::move(tp)), fields(std::move(fields)) {}
 
+    void write(ast_writer &w) const;
+
   private:
     void refine(scope &scp) const;
+    void check(type_context &ctx) const;
 
   private:
     std::vector<id_token> tp;
     std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
   };
 
-  class constructor_declaration final
+  class constructor_declaration final : public ast_node
   {
     friend class class_declaration;
 
   public:
-    constructor_declaration(std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &&inits, std::vector<std::unique_ptr<statement>> &&stmts) : params(std::move(params)), inits(std::move(inits)), stmts(std::move(stmts)) {}
+    constructor_declaration(std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &&inits, std::vector<std::unique_ptr<statement>> &&stmts);
 
     void refine(scope &scp) const;
+    void check(const scope &scp, const type_context &globals) const;
+    void write(ast_writer &w) const;
 
   private:
     std::vector<std::pair<std::vector<id_token>, id_token>> params;
     std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> inits;
     std::vector<std::unique_ptr<statement>> stmts;
+    frame_layout layout; // the layout of the frames the constructor is invoked in..
+    lazy_program code;   // the body of the constructor, compiled into bytecode the first time it is run as such..
   };
 
-  class method_declaration final
+  class method_declaration final : public ast_node
   {
     friend class compilation_unit;
     friend class class_declaration;
 
   public:
-    method_declaration(std::vector<id_token> &&rt, id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::unique_ptr<statement>> &&stmts) : rt(std::move(rt)), name(std::move(name)), params(std::move(params)), stmts(std::move(stmts)) {}
+    method_declaration(std::vector<id_token> &&rt, id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::unique_ptr<statement>> &&stmts);
 
     void refine(scope &scp) const;
+    void check(const scope &scp, const type_context &globals) const;
+    void write(ast_writer &w) const;
 
   private:
     std::vector<id_token> rt;
     id_token name;
     std::vector<std::pair<std::vector<id_token>, id_token>> params;
     std::vector<std::unique_ptr<statement>> stmts;
+    frame_layout layout; // the layout of the frames the method is invoked in..
+    lazy_program code;   // the body of the method, compiled into bytecode the first time it is run as such..
   };
 
-  class predicate_declaration final
+  class predicate_declaration final : public ast_node
   {
     friend class compilation_unit;
     friend class class_declaration;
 
   public:
-    predicate_declaration(id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::vector<id_token>> &&base_predicates, std::vector<std::unique_ptr<statement>> &&body) : name(std::move(name)), params(std::move(params)), base_predicates(std::move(base_predicates)), body(std::move(body)) {}
+    predicate_declaration(id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::vector<id_token>> &&base_predicates, std::vector<std::unique_ptr<statement>> &&body);
 
     void declare(scope &scp) const;
     void refine(scope &scp) const;
+    void check(const scope &scp, const type_context &globals) const;
+    void write(ast_writer &w) const;
 
   private:
     id_token name;
     std::vector<std::pair<std::vector<id_token>, id_token>> params;
     std::vector<std::vector<id_token>> base_predicates;
     std::vector<std::unique_ptr<statement>> body;
+    frame_layout layout; // the layout of the frames the predicate is called in..
+    lazy_program code;   // the body of the predicate, compiled into bytecode the first time it is run as such..
   };
 
   class class_declaration final : public type_declaration
@@ -126,10 +159,13 @@ namespace riddle
   public:
     class_declaration(id_token &&name, std::vector<std::vector<id_token>> &&base_classes, std::vector<std::unique_ptr<field_declaration>> &&fields, std::vector<std::unique_ptr<constructor_declaration>> &&constructors, std::vector<std::unique_ptr<method_declaration>> &&methods, std::vector<std::unique_ptr<predicate_declaration>> &&predicates, std::vector<std::unique_ptr<type_declaration>> &&types) : name(std::move(name)), base_classes(std::move(base_classes)), fields(std::move(fields)), constructors(std::move(constructors)), methods(std::move(methods)), predicates(std::move(predicates)), types(std::move(types)) {}
 
+    void write(ast_writer &w) const override;
+
   private:
     void declare(scope &scp) const override;
     void refine(scope &scp) const override;
     void refine_predicates(scope &scp) const override;
+    void check(const scope &scp, const type_context &globals) const override;
 
   private:
     id_token name;
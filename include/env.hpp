@@ -1,5 +1,6 @@
 #pragma once
 
+#include "item_map.hpp"
 #include "json.hpp"
 #include <map>
 #include <string>
@@ -49,7 +50,7 @@ namespace riddle
 #endif
 
   public:
-    env(core &c, env &parent, std::map<std::string, expr, std::less<>> &&items = {}) noexcept;
+    env(core &c, env &parent, item_map &&items = {}) noexcept;
     env(const env &) = delete;
     env(env &&) = default;
     virtual ~env() = default;
@@ -122,7 +123,7 @@ namespace riddle
      *
      * @return A reference to the map of items.
      */
-    [[nodiscard]] const std::map<std::string, expr, std::less<>> &get_items() const noexcept { return items; }
+    [[nodiscard]] const item_map &get_items() const noexcept { return items; }
 
     /**
      * @brief Converts the environment to a JSON object.
@@ -140,6 +141,6 @@ namespace riddle
     env &parent;
 
   protected:
-    std::map<std::string, expr, std::less<>> items;
+    item_map items;
   };
 } // namespace riddle
@@ -2,12 +2,77 @@
 
 #include "term.hpp"
 #include "lexer.hpp"
+#include "arena.hpp"
+#include "frame.hpp"
+#include <optional>
+#include <algorithm>
 
 namespace riddle
 {
   class scope;
+  class ast_writer;
+  class program;
+  class lazy_program;
+  class program_compiler;
+  class type_context;
+  class method;
+  class constructor;
+
+  /**
+   * @brief The bounds of the values an arithmetic literal, or a bounded arithmetic literal, evaluates to.
+   */
+  struct literal_bounds
+  {
+    utils::rational lb; // the lower bound..
+    utils::rational ub; // the upper bound..
+    bool is_int;        // whether the literal is an int literal..
+  };
 
-  class expression
+  /**
+   * @brief An inline cache of the overload a call site resolved to, for the types it has last been called with.
+   *
+   * Since the overloads of a scope never change once declared, repeated calls with the same types dispatch straight to the cached overload.
+   *
+   * @tparam Overload The kind of the overloads, i.e., methods or constructors.
+   */
+  template <typename Overload>
+  class overload_cache final
+  {
+  public:
+    /**
+     * @brief Returns the overload of the given scope matching the types of the given arguments, resolving it through the given function on a miss.
+     *
+     * @param scp The scope the overload is resolved in.
+     * @param args The arguments of the call.
+     * @param resolve The function resolving the overload, given the types of the arguments.
+     * @return Overload& The overload.
+     */
+    template <typename Resolve>
+    Overload &get(const scope &scp, const std::vector<expr> &args, Resolve &&resolve)
+    {
+      if (&scp != resolved_in || !std::equal(args.begin(), args.end(), argument_types.begin(), argument_types.end(), [](const expr &arg, const type *tp)
+                                             { return &arg->get_type() == tp; }))
+      { // a miss, we resolve the overload..
+        std::vector<std::reference_wrapper<const type>> arg_types;
+        arg_types.reserve(args.size());
+        for (const auto &arg : args)
+          arg_types.emplace_back(arg->get_type());
+        overload = &resolve(arg_types);
+        resolved_in = &scp;
+        argument_types.clear();
+        for (const auto &arg : args)
+          argument_types.push_back(&arg->get_type());
+      }
+      return *overload;
+    }
+
+  private:
+    const scope *resolved_in = nullptr;       // the scope the overload has been resolved in..
+    std::vector<const type *> argument_types; // the types of the arguments the overload has been resolved for..
+    Overload *overload = nullptr;             // the resolved overload..
+  };
+
+  class expression : public ast_node
   {
   public:
     expression() = default;
@@ -22,6 +87,75 @@ namespace riddle
      * @return expr A shared pointer to the evaluated item.
      */
     [[nodiscard]] virtual expr evaluate(const scope &scp, env &ctx) const = 0;
+
+    /**
+     * @brief Binds the names the expression refers to into the slots of the given layout.
+     *
+     * Bound expressions must be evaluated within frames having the given layout.
+     *
+     * @param layout The layout of the frames the expression is evaluated in.
+     */
+    virtual void bind([[maybe_unused]] frame_layout &layout) {}
+
+    /**
+     * @brief Compiles the expression, which pushes its value, through the given compiler.
+     *
+     * @param c The compiler.
+     */
+    virtual void compile(program_compiler &c) const = 0;
+
+    /**
+     * @brief Writes the expression through the given writer.
+     *
+     * @param w The writer.
+     */
+    virtual void write(ast_writer &w) const = 0;
+
+    /**
+     * @brief Infers the static type of the expression within the given context, annotating the expression with it.
+     *
+     * Checked expressions can be evaluated without checking the kind of the items their subexpressions evaluate to.
+     *
+     * @param ctx The context in which the expression is checked.
+     * @return const type& The static type of the expression.
+     * @throws std::runtime_error if the expression is ill-typed, or std::out_of_range if it refers to an unknown item, type or method.
+     */
+    const type &check(type_context &ctx)
+    {
+      tp = &infer(ctx);
+      return *tp;
+    }
+
+    /**
+     * @brief Returns the static type of the expression, or `nullptr` if the expression has not been checked.
+     */
+    [[nodiscard]] const type *get_type() const noexcept { return tp; }
+
+    /**
+     * @brief Simplifies the expression, whose subexpressions have already been simplified.
+     *
+     * Constant subexpressions are folded, identities are removed and nested operators of the same kind are flattened, so that evaluating the expression creates fewer terms.
+     *
+     * @return std::unique_ptr<expression> The expression replacing this one, or `nullptr` if this expression is kept (possibly with simplified operands).
+     */
+    [[nodiscard]] virtual std::unique_ptr<expression> simplify() { return nullptr; }
+    /**
+     * @brief Returns the bounds of the values the expression evaluates to, if the expression is an arithmetic literal or a bounded arithmetic literal.
+     */
+    [[nodiscard]] virtual std::optional<literal_bounds> get_bounds() const { return std::nullopt; }
+    /**
+     * @brief Returns the value of the expression, if the expression is a bool literal.
+     */
+    [[nodiscard]] virtual std::optional<bool> get_truth() const noexcept { return std::nullopt; }
+
+  private:
+    /**
+     * @brief Infers the static type of the expression within the given context, checking its subexpressions.
+     */
+    [[nodiscard]] virtual const type &infer(type_context &ctx) const = 0;
+
+  private:
+    const type *tp = nullptr; // the static type of the expression, once checked..
   };
 
   class bool_expression final : public expression
@@ -30,6 +164,10 @@ namespace riddle
     bool_expression(bool_token &&l) noexcept : l(std::move(l)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::optional<bool> get_truth() const noexcept override { return l.value; }
 
   private:
     bool_token l;
@@ -41,6 +179,10 @@ namespace riddle
     int_expression(int_token &&l) noexcept : l(std::move(l)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::optional<literal_bounds> get_bounds() const override;
 
   private:
     int_token l;
@@ -52,6 +194,10 @@ namespace riddle
     bounded_int_expression(int_token &&lb, int_token &&ub) noexcept : lb(std::move(lb)), ub(std::move(ub)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::optional<literal_bounds> get_bounds() const override;
 
   private:
     int_token lb;
@@ -64,6 +210,9 @@ namespace riddle
     uncertain_int_expression(int_token &&lb, int_token &&ub) noexcept : lb(std::move(lb)), ub(std::move(ub)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
 
   private:
     int_token lb;
@@ -76,6 +225,10 @@ namespace riddle
     real_expression(real_token &&l) noexcept : l(std::move(l)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::optional<literal_bounds> get_bounds() const override;
 
   private:
     real_token l;
@@ -87,6 +240,10 @@ namespace riddle
     bounded_real_expression(real_token &&lb, real_token &&ub) noexcept : lb(std::move(lb)), ub(std::move(ub)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::optional<literal_bounds> get_bounds() const override;
 
   private:
     real_token lb;
@@ -99,6 +256,9 @@ namespace riddle
     uncertain_real_expression(real_token &&lb, real_token &&ub) noexcept : lb(std::move(lb)), ub(std::move(ub)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
 
   private:
     real_token lb;
@@ -111,6 +271,9 @@ namespace riddle
     string_expression(string_token &&l) noexcept : l(std::move(l)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
 
   private:
     string_token l;
@@ -122,9 +285,14 @@ namespace riddle
     id_expression(std::vector<id_token> &&obj_id) noexcept : object_id(std::move(obj_id)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<id_token> object_id;
+    std::size_t slot = unbound_slot; // the slot of the object, if bound..
   };
 
   class and_expression final : public expression
@@ -133,6 +301,11 @@ namespace riddle
     and_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
     friend std::unique_ptr<expression> push_negations(std::unique_ptr<expression> expr) noexcept;
     friend std::unique_ptr<expression> distribute(std::unique_ptr<expression> expr) noexcept;
@@ -147,6 +320,11 @@ namespace riddle
     or_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
     friend std::unique_ptr<expression> push_negations(std::unique_ptr<expression> expr) noexcept;
     friend std::unique_ptr<expression> distribute(std::unique_ptr<expression> expr) noexcept;
@@ -161,6 +339,10 @@ namespace riddle
     xor_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<std::unique_ptr<expression>> xprs;
@@ -172,6 +354,11 @@ namespace riddle
     not_expression(std::unique_ptr<expression> xpr) noexcept : xpr(std::move(xpr)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
     friend std::unique_ptr<expression> push_negations(std::unique_ptr<expression> expr) noexcept;
 
@@ -185,6 +372,11 @@ namespace riddle
     minus_expression(std::unique_ptr<expression> xpr) noexcept : xpr(std::move(xpr)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> xpr;
@@ -196,6 +388,11 @@ namespace riddle
     sum_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<std::unique_ptr<expression>> xprs;
@@ -207,6 +404,11 @@ namespace riddle
     subtraction_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<std::unique_ptr<expression>> xprs;
@@ -218,6 +420,11 @@ namespace riddle
     product_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<std::unique_ptr<expression>> xprs;
@@ -229,6 +436,11 @@ namespace riddle
     division_expression(std::vector<std::unique_ptr<expression>> &&xprs) noexcept : xprs(std::move(xprs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<std::unique_ptr<expression>> xprs;
@@ -240,6 +452,11 @@ namespace riddle
     lt_expression(std::unique_ptr<expression> lhs, std::unique_ptr<expression> rhs) noexcept : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> lhs;
@@ -252,6 +469,11 @@ namespace riddle
     le_expression(std::unique_ptr<expression> lhs, std::unique_ptr<expression> rhs) noexcept : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> lhs;
@@ -264,6 +486,11 @@ namespace riddle
     gt_expression(std::unique_ptr<expression> lhs, std::unique_ptr<expression> rhs) noexcept : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> lhs;
@@ -276,6 +503,11 @@ namespace riddle
     ge_expression(std::unique_ptr<expression> lhs, std::unique_ptr<expression> rhs) noexcept : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> lhs;
@@ -288,6 +520,11 @@ namespace riddle
     eq_expression(std::unique_ptr<expression> lhs, std::unique_ptr<expression> rhs) noexcept : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    [[nodiscard]] std::unique_ptr<expression> simplify() override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> lhs;
@@ -300,10 +537,27 @@ namespace riddle
     constructor_expression(std::vector<id_token> &&tp_id, std::vector<std::unique_ptr<expression>> &&args) noexcept : type_id(std::move(tp_id)), arguments(std::move(args)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    void bind(frame_layout &layout) override;
+
+    /**
+     * @brief Creates a new instance of the given type through the constructor matching the given arguments.
+     *
+     * @param tp The type of the instance.
+     * @param args The arguments of the constructor.
+     * @param cache The cache of the call site.
+     * @return The new instance.
+     * @throws std::runtime_error if the type is not a component type.
+     */
+    [[nodiscard]] static expr instantiate(type &tp, std::vector<expr> &&args, overload_cache<constructor> &cache);
 
   private:
     std::vector<id_token> type_id;
     std::vector<std::unique_ptr<expression>> arguments;
+    mutable type *resolved_type = nullptr;     // the type of the instance, once checked..
+    mutable overload_cache<constructor> cache; // the constructor the expression has last resolved to..
   };
 
   class call_expression final : public expression
@@ -312,10 +566,63 @@ namespace riddle
     call_expression(std::vector<id_token> &&obj_id, id_token &&fn_id, std::vector<std::unique_ptr<expression>> &&args) noexcept : object_id(std::move(obj_id)), function_id(std::move(fn_id)), arguments(std::move(args)) {}
 
     [[nodiscard]] expr evaluate(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    [[nodiscard]] const type &infer(type_context &ctx) const override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<id_token> object_id;
     id_token function_id;
     std::vector<std::unique_ptr<expression>> arguments;
+    std::size_t slot = unbound_slot;      // the slot of the object, if bound..
+    mutable overload_cache<method> cache; // the method the expression has last resolved to..
   };
-} // namespace riddle
+
+  /**
+   * @brief Simplifies the given expression, whose subexpressions have already been simplified.
+   *
+   * @param xpr The expression.
+   * @return std::unique_ptr<expression> The simplified expression.
+   */
+  [[nodiscard]] std::unique_ptr<expression> simplify(std::unique_ptr<expression> xpr);
+  /**
+   * @brief Resolves the given, possibly qualified, type name within the given scope.
+   *
+   * @param scp The scope in which the type name is resolved.
+   * @param tp_id The type name.
+   * @return The type.
+   * @throws std::runtime_error if a qualifier does not refer to a component type.
+   */
+  [[nodiscard]] type &resolve_type(const scope &scp, const std::vector<id_token> &tp_id);
+  /**
+   * @brief Resolves the given, possibly qualified, type name within the given scope, unless it has already been resolved.
+   *
+   * @param scp The scope in which the type name is resolved.
+   * @param tp_id The type name.
+   * @param resolved The type the name has been resolved to while checking, or `nullptr` if it has not been checked.
+   * @return The type.
+   * @throws std::runtime_error if a qualifier does not refer to a component type.
+   */
+  [[nodiscard]] type &resolve_type(const scope &scp, const std::vector<id_token> &tp_id, type *resolved);
+  /**
+   * @brief Retrieves the item with the given name of the given component, atom or enum.
+   *
+   * @param obj The object.
+   * @param name The name of the item.
+   * @return The item.
+   * @throws std::runtime_error if the object is neither a component, nor an atom, nor an enum.
+   */
+  [[nodiscard]] expr get_item(const expr &obj, std::string_view name);
+  /**
+   * @brief Invokes the method with the given name, matching the given arguments, on the given component or core.
+   *
+   * @param obj The object the method is invoked on.
+   * @param name The name of the method.
+   * @param args The arguments of the method.
+   * @param cache The cache of the call site.
+   * @return The value returned by the method, if any.
+   * @throws std::runtime_error if the object is neither a component nor a core.
+   */
+  expr invoke(const expr &obj, std::string_view name, std::vector<expr> &&args, overload_cache<method> &cache);
+} // namespace riddle
\ No newline at end of file
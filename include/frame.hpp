@@ -0,0 +1,158 @@
+#pragma once
+
+#include "env.hpp"
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace riddle
+{
+  /**
+   * @brief The slot of the nodes which have not been bound to a frame layout.
+   *
+   * Unbound nodes, such as the statements of the problem and the default initializers of the fields, retrieve their items by name.
+   */
+  constexpr std::size_t unbound_slot = std::numeric_limits<std::size_t>::max();
+
+  /**
+   * @class frame_layout frame.hpp "include/frame.hpp"
+   * @brief The layout of the frames in which a body is executed.
+   *
+   * The layout is computed once, when the body is bound, by assigning a slot to each of the local items of the body (i.e., the instance, the arguments, the local fields, the atoms and the variables of the for-all statements) and to each of the free names it refers to. The items of the free names are imported lazily, from the parent of the frame, the first time they are read.
+   */
+  class frame_layout final
+  {
+  public:
+    /**
+     * @brief Declares a new local item, visible until the enclosing scope is closed.
+     *
+     * A local item hides any item with the same name declared before.
+     *
+     * @param name The name of the item.
+     * @return The slot of the item.
+     */
+    std::size_t declare(std::string_view name);
+    /**
+     * @brief Resolves the given name into the slot of the innermost visible local item, or into the slot of the imported item if no local item has the given name.
+     *
+     * @param name The name to resolve.
+     * @return The slot the name is resolved into.
+     */
+    std::size_t resolve(std::string_view name);
+    /**
+     * @brief Finds the innermost visible local item with the given name.
+     *
+     * @param name The name of the item.
+     * @return The slot of the item, if any.
+     */
+    [[nodiscard]] std::optional<std::size_t> find(std::string_view name) const noexcept;
+    /**
+     * @brief Returns the slot of the value returned by the body, creating it if necessary.
+     */
+    std::size_t return_slot();
+    /**
+     * @brief Returns the slot of the value returned by the body, if the body returns any value.
+     */
+    [[nodiscard]] std::optional<std::size_t> find_return_slot() const noexcept { return ret; }
+
+    /**
+     * @brief Opens a new scope for the local items.
+     */
+    void open_scope() { scopes.push_back(visible.size()); }
+    /**
+     * @brief Closes the innermost scope, hiding the local items declared within it.
+     */
+    void close_scope()
+    {
+      visible.resize(scopes.back());
+      scopes.pop_back();
+    }
+
+    /**
+     * @brief Returns the number of slots of the frames.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return slots.size(); }
+    /**
+     * @brief Returns the name of the item held by the given slot.
+     */
+    [[nodiscard]] const std::string &get_name(std::size_t slot) const noexcept { return slots[slot].name; }
+    /**
+     * @brief Checks whether the given slot holds an imported item.
+     */
+    [[nodiscard]] bool is_import(std::size_t slot) const noexcept { return slots[slot].import; }
+
+  private:
+    struct slot_info
+    {
+      std::string name; // the name of the item..
+      bool import;      // whether the item is imported from the parent of the frame..
+    };
+    std::vector<slot_info> slots;     // the slots of the frames..
+    std::vector<std::size_t> visible; // the slots of the visible local items, in order of declaration..
+    std::vector<std::size_t> scopes;  // the number of visible local items at the opening of each scope..
+    std::optional<std::size_t> ret;   // the slot of the returned value, if any..
+  };
+
+  /**
+   * @class frame frame.hpp "include/frame.hpp"
+   * @brief The environment in which a bound body is executed.
+   *
+   * The items of the body are stored in a flat vector of slots, laid out by the body's `frame_layout`, so that bound nodes access them through their index rather than through their name.
+   */
+  class frame final : public env
+  {
+  public:
+    /**
+     * @brief Constructs a new frame.
+     *
+     * @param c The core.
+     * @param parent The parent environment, from which the free names are imported.
+     * @param layout The layout of the frame, if any. Frames without a layout have no slots and behave as plain environments.
+     */
+    frame(core &c, env &parent, const frame_layout *layout = nullptr) noexcept : env(c, parent), layout(layout), slots(layout ? layout->size() : 0) {}
+    /**
+     * @brief Constructs a copy of the given frame, sharing its parent and its layout.
+     */
+    frame(const frame &other) : env(other.get_core(), other.get_parent()), layout(other.layout), slots(other.slots) { items = other.items; }
+    frame(frame &&) = default;
+
+    /**
+     * @brief Returns the item held by the given slot, for writing it.
+     */
+    [[nodiscard]] expr &operator[](std::size_t slot) noexcept { return slots[slot]; }
+    /**
+     * @brief Reads the item held by the given slot, importing it from the parent of the frame if necessary.
+     *
+     * @param slot The slot to read.
+     * @return The item held by the slot.
+     * @throws std::out_of_range if the item is not found.
+     */
+    [[nodiscard]] const expr &load(std::size_t slot)
+    {
+      auto &itm = slots[slot];
+      if (!itm)
+      {
+        if (!layout->is_import(slot))
+          throw std::out_of_range("item `" + layout->get_name(slot) + "` not found");
+        itm = get_parent().get(layout->get_name(slot));
+      }
+      return itm;
+    }
+
+    /**
+     * @brief Retrieves an item by its name, for the nodes which have not been bound.
+     *
+     * The local items held by the slots are searched first, then the items of the environment and, finally, those of the parent environment.
+     *
+     * @param name The name of the item to retrieve.
+     * @return The item with the given name.
+     * @throws std::out_of_range if the item is not found.
+     */
+    [[nodiscard]] expr get(std::string_view name) override;
+
+  private:
+    const frame_layout *layout; // the layout of the frame..
+    std::vector<expr> slots;    // the items of the frame..
+  };
+} // namespace riddle
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace riddle
+{
+  class term;
+  using expr = std::shared_ptr<term>;
+
+  /**
+   * @class item_map item_map.hpp "include/item_map.hpp"
+   * @brief A map from names to items, stored as a vector.
+   *
+   * Environments usually hold a handful of items (e.g., the fields of a component or the arguments of an atom), which are looked up by name far more often than they are added. Storing them contiguously requires a single allocation per environment, rather than one node per item, while the vector of small maps is kept sorted by name, so that a binary search keeps lookups logarithmic. As for a `std::map`, the items can be looked up through any string-like key without building a `std::string`.
+   *
+   * Keeping the vector sorted would make the insertion of many items (e.g., the global items of a core) quadratic. Once a map grows beyond `index_threshold` items, new items are appended and are looked up through a hash index of their positions, while an erased item is replaced by the last one. Small maps, hence, are iterated in the order of their names, while large maps are iterated in an unspecified order. Iterators are invalidated by insertions and erasures, and only by them: reading the map never changes it, so that it can be read concurrently.
+   */
+  class item_map final
+  {
+  public:
+    using key_type = std::string;
+    using mapped_type = expr;
+    using value_type = std::pair<std::string, expr>;
+    using size_type = std::size_t;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    static constexpr size_type index_threshold = 32; // the number of items beyond which the items are indexed by the hash of their names..
+
+    item_map() = default;
+    item_map(std::initializer_list<value_type> init)
+    {
+      items.reserve(init.size());
+      for (const auto &itm : init)
+        emplace(itm.first, itm.second);
+    }
+    item_map(const item_map &other) : items(other.items), index(other.index ? std::make_unique<position_index>(*other.index) : nullptr) {}
+    item_map(item_map &&) noexcept = default;
+    item_map &operator=(const item_map &other)
+    {
+      if (this != &other)
+        *this = item_map(other);
+      return *this;
+    }
+    item_map &operator=(item_map &&) noexcept = default;
+
+    [[nodiscard]] iterator begin() noexcept { return items.begin(); }
+    [[nodiscard]] iterator end() noexcept { return items.end(); }
+    [[nodiscard]] const_iterator begin() const noexcept { return items.cbegin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return items.cend(); }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return items.empty(); }
+    [[nodiscard]] size_type size() const noexcept { return items.size(); }
+    /**
+     * @brief Reserves room for the given number of items.
+     *
+     * @param n The number of items.
+     */
+    void reserve(size_type n) { items.reserve(n); }
+
+    /**
+     * @brief Returns an iterator to the item with the given name, or `end()` if there is no such item.
+     *
+     * @param name The name of the item.
+     */
+    [[nodiscard]] iterator find(std::string_view name) noexcept { return items.begin() + static_cast<std::ptrdiff_t>(position(name)); }
+    [[nodiscard]] const_iterator find(std::string_view name) const noexcept { return items.cbegin() + static_cast<std::ptrdiff_t>(position(name)); }
+    /**
+     * @brief Returns the number of items with the given name, either `0` or `1`.
+     *
+     * @param name The name of the item.
+     */
+    [[nodiscard]] size_type count(std::string_view name) const noexcept { return position(name) != items.size() ? 1 : 0; }
+
+    /**
+     * @brief Returns the item with the given name.
+     *
+     * @param name The name of the item.
+     * @throws std::out_of_range if there is no item with the given name.
+     */
+    [[nodiscard]] const expr &at(std::string_view name) const
+    {
+      if (auto pos = position(name); pos != items.size())
+        return items[pos].second;
+      throw std::out_of_range("item `" + std::string(name) + "` not found");
+    }
+
+    /**
+     * @brief Adds an item with the given name, unless an item with the same name already exists.
+     *
+     * @param name The name of the item.
+     * @param val The item.
+     * @return std::pair<iterator, bool> An iterator to the item with the given name, and whether the item has been added.
+     */
+    template <typename Val>
+    std::pair<iterator, bool> emplace(std::string_view name, Val &&val)
+    {
+      if (index)
+      { // the item is appended, the index taking care of the lookups..
+        if (auto pos = position(name); pos != items.size())
+          return {items.begin() + static_cast<std::ptrdiff_t>(pos), false};
+        index->emplace(hash(name), items.size());
+        items.emplace_back(std::string(name), std::forward<Val>(val));
+        return {std::prev(items.end()), true};
+      }
+      auto it = lower_bound(name);
+      if (it != items.end() && it->first == name)
+        return {it, false};
+      it = items.emplace(it, std::string(name), std::forward<Val>(val));
+      if (items.size() > index_threshold)
+      { // the map has grown large enough to be indexed..
+        const auto pos = it - items.begin();
+        build_index();
+        it = items.begin() + pos;
+      }
+      return {it, true};
+    }
+
+    /**
+     * @brief Adds the items of the given range whose names are not already in the map.
+     *
+     * @param first The beginning of the range.
+     * @param last The end of the range.
+     */
+    template <typename It>
+    void insert(It first, It last)
+    {
+      items.reserve(items.size() + static_cast<size_type>(std::distance(first, last)));
+      for (; first != last; ++first)
+        emplace(first->first, first->second);
+    }
+
+    /**
+     * @brief Removes the item with the given name, if any.
+     *
+     * @param name The name of the item.
+     * @return size_type The number of removed items, either `0` or `1`.
+     */
+    size_type erase(std::string_view name)
+    {
+      const auto pos = position(name);
+      if (pos == items.size())
+        return 0;
+      if (index)
+      { // the last item takes the place of the removed one..
+        unindex(items[pos].first, pos);
+        if (const auto last = items.size() - 1; pos != last)
+        {
+          unindex(items[last].first, last);
+          index->emplace(hash(items[last].first), pos);
+          items[pos] = std::move(items[last]);
+        }
+        items.pop_back();
+      }
+      else
+        items.erase(items.begin() + static_cast<std::ptrdiff_t>(pos));
+      return 1;
+    }
+
+  private:
+    using position_index = std::unordered_multimap<std::size_t, size_type>;
+
+    [[nodiscard]] iterator lower_bound(std::string_view name) noexcept { return std::lower_bound(items.begin(), items.end(), name, name_less); }
+    [[nodiscard]] const_iterator lower_bound(std::string_view name) const noexcept { return std::lower_bound(items.cbegin(), items.cend(), name, name_less); }
+
+    /**
+     * @brief Returns the position of the item with the given name, or the number of items if there is no such item.
+     */
+    [[nodiscard]] size_type position(std::string_view name) const noexcept
+    {
+      if (index)
+      {
+        const auto [first, last] = index->equal_range(hash(name));
+        for (auto it = first; it != last; ++it)
+          if (items[it->second].first == name)
+            return it->second;
+        return items.size();
+      }
+      auto it = lower_bound(name);
+      return it != items.cend() && it->first == name ? static_cast<size_type>(it - items.cbegin()) : items.size();
+    }
+
+    void build_index()
+    {
+      if (!index)
+        index = std::make_unique<position_index>();
+      index->clear();
+      index->reserve(items.size());
+      for (size_type pos = 0; pos < items.size(); ++pos)
+        index->emplace(hash(items[pos].first), pos);
+    }
+    void unindex(std::string_view name, size_type pos) noexcept
+    {
+      const auto [first, last] = index->equal_range(hash(name));
+      for (auto it = first; it != last; ++it)
+        if (it->second == pos)
+        {
+          index->erase(it);
+          return;
+        }
+    }
+
+    static bool name_less(const value_type &itm, std::string_view name) noexcept { return std::string_view(itm.first) < name; }
+    static std::size_t hash(std::string_view name) noexcept { return std::hash<std::string_view>{}(name); }
+
+  private:
+    std::vector<value_type> items;         // the items, sorted by name until the map is indexed..
+    std::unique_ptr<position_index> index; // the positions of the items, by the hash of their names, once the map has grown large..
+  };
+} // namespace riddle
@@ -83,7 +83,7 @@ namespace riddle
   class atom : public riddle::atom_term
   {
   public:
-    atom(flaw &flw, riddle::predicate &pred, bool is_fact, std::map<std::string, std::shared_ptr<riddle::term>, std::less<>> &&args, const bool_expr &sigma) noexcept;
+    atom(flaw &flw, riddle::predicate &pred, bool is_fact, riddle::item_map &&args, const bool_expr &sigma) noexcept;
 
     [[nodiscard]] const bool_expr &get_sigma() const noexcept { return sigma; }
 
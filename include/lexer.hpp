@@ -1,9 +1,13 @@
 #pragma once
 
 #include "rational.hpp"
+#include "symbol_table.hpp"
+#include "ring_buffer.hpp"
 #include <vector>
 #include <memory>
 #include <istream>
+#include <string_view>
+#include <cstdint>
 
 namespace riddle
 {
@@ -20,7 +24,7 @@ namespace riddle
   constexpr const char *tau_kw = "tau";
   constexpr const char *this_kw = "this";
 
-  enum symbol
+  enum symbol : std::uint8_t
   {
     START,       // Start state
     BOOL,        // `bool`
@@ -105,7 +109,7 @@ namespace riddle
    *
    * @note This class is marked as final and cannot be inherited from.
    *
-   * @param id The identifier string.
+   * @param id The identifier string, interned in a symbol table.
    * @param line The line number where the token is found.
    * @param start_pos The starting position of the token in the line.
    * @param end_pos The ending position of the token in the line.
@@ -113,10 +117,11 @@ namespace riddle
   class id_token final : public token
   {
   public:
-    id_token(std::string &&id, size_t line, size_t start_pos, size_t end_pos) noexcept : token(ID, line, start_pos, end_pos), id(std::move(id)) {}
-    id_token(id_token &&) noexcept = default; // Move constructor
+    id_token(const std::string &id, size_t line, size_t start_pos, size_t end_pos) noexcept : token(ID, line, start_pos, end_pos), id(id) {}
+    id_token(std::string &&id, size_t line, size_t start_pos, size_t end_pos) = delete; // The identifier must be interned
+    id_token(id_token &&) noexcept = default;                                            // Move constructor
 
-    const std::string id; // The identifier string
+    const std::string &id; // The identifier string
   };
 
   /**
@@ -204,23 +209,178 @@ namespace riddle
     const std::string value; // The string value
   };
 
+  /**
+   * @struct token_record lexer.hpp "include/lexer.hpp"
+   * @brief A compact, fixed-size representation of a lexical token.
+   *
+   * Token records are stored contiguously within a token_stream. The payload of identifiers, numeric and string literals is an index into the corresponding side table of the stream, while the payload of boolean literals is the value itself. Identifiers are interned in the symbol table of the lexer which produced the stream.
+   */
+  struct token_record
+  {
+    std::uint32_t line;      // The line number of the token
+    std::uint32_t start_pos; // The starting position of the token in the line
+    std::uint32_t end_pos;   // The ending position of the token in the line
+    std::uint32_t payload;   // The value of the token, as an index into the side table of its symbol
+    symbol sym;              // The symbol associated with the token
+  };
+
+  class lexer;
+
+  /**
+   * @class token_stream lexer.hpp "include/lexer.hpp"
+   * @brief A flat sequence of tokens.
+   *
+   * The tokens are stored as a contiguous ring of token records, while the identifiers, the numeric and the string literals are stored in per-kind side tables. Building and releasing a token stream, therefore, requires a handful of allocations regardless of the number of tokens.
+   *
+   * A stream can be bound to the lexer which produces it, in which case tokens are pulled from the lexer on demand, as they are accessed. Consumers can release the tokens they are done with, so that the memory held by the stream is bounded by the longest span of tokens retained at once rather than by the size of the source.
+   */
+  class token_stream final
+  {
+    friend class lexer;
+
+  public:
+    /**
+     * @brief Returns the number of tokens produced so far.
+     *
+     * @return The number of tokens produced so far, including the released ones and, once reached, the terminating `EoF` token.
+     */
+    [[nodiscard]] size_t size() const noexcept { return records.end_index(); }
+    /**
+     * @brief Returns the token at the given position, pulling it from the lexer if needed.
+     *
+     * @param pos The position of the token.
+     * @return The token record at the given position.
+     * @throws std::out_of_range If the position is beyond the end of the stream or the token has been released.
+     */
+    [[nodiscard]] const token_record &at(size_t pos)
+    {
+      if (records.contains(pos))
+        return records[pos];
+      return pull(pos);
+    }
+
+    /**
+     * @brief Releases all the tokens before the given position.
+     *
+     * @param pos The position of the first token to retain.
+     */
+    void release(size_t pos) noexcept;
+
+    [[nodiscard]] const std::string &get_id(const token_record &tk) const noexcept { return *ids[tk.payload]; }
+    [[nodiscard]] bool get_bool(const token_record &tk) const noexcept { return tk.payload; }
+    [[nodiscard]] INT_TYPE get_int(const token_record &tk) const noexcept { return ints[tk.payload]; }
+    [[nodiscard]] const utils::rational &get_real(const token_record &tk) const noexcept { return reals[tk.payload]; }
+    /**
+     * @brief Moves the real literal of the given token out of the stream.
+     *
+     * The literal can be taken only once: the consumer becomes its owner.
+     *
+     * @param tk The token.
+     * @return The real literal of the token.
+     */
+    [[nodiscard]] utils::rational take_real(const token_record &tk) noexcept { return std::move(reals[tk.payload]); }
+    [[nodiscard]] std::string_view get_string(const token_record &tk) const noexcept { return strings[tk.payload]; }
+
+  private:
+    token_stream(lexer *source = nullptr) noexcept : source(source) {}
+
+    const token_record &pull(size_t pos);
+
+    void push(symbol sym, size_t line, size_t start_pos, size_t end_pos, size_t payload = 0) { records.push_back({static_cast<std::uint32_t>(line), static_cast<std::uint32_t>(start_pos), static_cast<std::uint32_t>(end_pos), static_cast<std::uint32_t>(payload), sym}); }
+
+  private:
+    lexer *source;                             // The lexer producing the tokens on demand, if any
+    ring_buffer<token_record> records;         // The token records
+    ring_buffer<const std::string *> ids{16};  // The interned identifiers
+    ring_buffer<INT_TYPE> ints{16};            // The integer literals
+    ring_buffer<utils::rational> reals{16};    // The real literals
+    ring_buffer<std::string> strings{16};      // The string literals
+  };
+
   class lexer final
   {
+    friend class token_stream;
+
   public:
+    /**
+     * @brief Constructs a new lexer.
+     *
+     * @param symbols The symbol table in which the identifiers are interned, usually the one of the core the tokens are meant for. It must outlive the produced tokens.
+     */
+    explicit lexer(symbol_table &symbols) noexcept : symbols(symbols) {}
+
+    /**
+     * @brief Tokenizes the content of the given input stream.
+     *
+     * @param is The input stream to tokenize.
+     * @return The tokens, terminated by an `EoF` token.
+     * @throws std::runtime_error If an unexpected character or an unterminated literal is found.
+     */
     std::vector<std::unique_ptr<const token>> parse(std::istream &is);
+    /**
+     * @brief Tokenizes the given contiguous source buffer.
+     *
+     * The buffer is scanned in place through pointer arithmetic: no character is read through a stream and lexemes are taken as slices of the source, so that identifiers and string literals are copied exactly once, into their token.
+     *
+     * @param src The source to tokenize. It must outlive the call.
+     * @return The tokens, terminated by an `EoF` token.
+     * @throws std::runtime_error If an unexpected character or an unterminated literal is found.
+     */
+    std::vector<std::unique_ptr<const token>> parse(std::string_view src);
+    /**
+     * @brief Tokenizes the given contiguous source buffer into a flat token stream.
+     *
+     * @param src The source to tokenize. It must outlive the call.
+     * @return The token stream, terminated by an `EoF` token.
+     * @throws std::runtime_error If an unexpected character or an unterminated literal is found.
+     */
+    token_stream tokenize(std::string_view src);
+
+    /**
+     * @brief Returns a token stream which pulls the tokens of the given source buffer from this lexer on demand.
+     *
+     * @param src The source to tokenize. It must outlive the returned stream.
+     * @return The token stream, bound to this lexer, which must outlive it.
+     */
+    token_stream stream(std::string_view src);
+    /**
+     * @brief Returns a token stream which pulls the tokens of the given input stream from this lexer on demand.
+     *
+     * The input is read in chunks into a window which retains just the characters of the token being scanned, so that the memory held by the lexer does not depend on the size of the input.
+     *
+     * @param is The input stream to tokenize. It must outlive the returned stream.
+     * @return The token stream, bound to this lexer, which must outlive it.
+     */
+    token_stream stream(std::istream &is);
 
   private:
-    bool match(std::istream &is, char expected) noexcept;
-    std::unique_ptr<const token> finish_token() noexcept;
+    void reset(std::string_view src) noexcept;
+    void next_token(token_stream &ts);
+    void skip_blanks();
+    [[nodiscard]] bool refill(const char *&keep);
+    [[nodiscard]] bool available(size_t n);
+    void new_line(const char *nl) noexcept;
+    [[nodiscard]] size_t column(const char *p) const noexcept { return offset + static_cast<size_t>(p - begin) - line_start; }
 
-    static bool is_id_part(const char &ch) noexcept { return ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9'); }
+    /**
+     * @brief Classifies the given identifier as a keyword, a boolean literal or a plain identifier.
+     *
+     * The identifier is looked up in a table built at compile time through a perfect hash, so that each identifier is classified with a single comparison.
+     */
+    static symbol keyword(std::string_view id) noexcept;
 
   private:
-    symbol current_state = START;
+    static constexpr size_t window_size = 1 << 16; // The initial size of the window over input streams
 
-    size_t line = 1;
-    size_t start = 0;
+    symbol_table &symbols; // The symbol table in which the identifiers are interned
+    size_t line = 1;       // The current line
 
-    std::string text;
+    std::istream *input = nullptr; // The input stream, when lexing an input stream
+    std::string window;            // The window over the input stream
+    const char *begin = nullptr;   // The beginning of the source buffer, or of the window
+    const char *cur = nullptr;     // The current position in the source buffer
+    const char *end = nullptr;     // The end of the source buffer
+    size_t offset = 0;             // The offset of `begin` from the beginning of the source
+    size_t line_start = 0;         // The offset of the beginning of the current line from the beginning of the source
   };
 } // namespace riddle
\ No newline at end of file
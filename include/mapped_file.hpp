@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace riddle
+{
+  /**
+   * @class mapped_file mapped_file.hpp "include/mapped_file.hpp"
+   * @brief A file mapped read-only into memory.
+   *
+   * The content of the file is accessed in place, without copying it through stream buffers, and the pages of the file are shared with the other processes mapping it. Where memory mapping is not available, the content is read into a buffer instead. The file is unmapped when the object is destroyed, so views of its content must not outlive it.
+   */
+  class mapped_file final
+  {
+  public:
+    /**
+     * @brief Maps the given file into memory.
+     *
+     * @param file The file to map.
+     * @throws std::runtime_error If the file cannot be opened.
+     */
+    explicit mapped_file(const std::filesystem::path &file);
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+    ~mapped_file();
+
+    /**
+     * @brief Returns the content of the file.
+     */
+    [[nodiscard]] std::string_view content() const noexcept { return {data, size}; }
+
+  private:
+    const char *data = nullptr; // the content of the file..
+    size_t size = 0;            // the size of the file..
+    bool mapped = false;        // whether the content is mapped, rather than read into the buffer..
+    std::string buffer;         // the content of the file, if it could not be mapped..
+  };
+} // namespace riddle
@@ -9,7 +9,7 @@ namespace riddle
   class method : public scope
   {
   public:
-    method(scope &scp, std::optional<std::reference_wrapper<type>> return_type, std::string_view name, std::vector<std::unique_ptr<field>> &&args = {}, const std::vector<std::unique_ptr<statement>> &body = {}) noexcept;
+    method(scope &scp, std::optional<std::reference_wrapper<type>> return_type, std::string_view name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept;
 
     /**
      * @brief Retrieves the name of the method.
@@ -29,6 +29,13 @@ namespace riddle
      */
     [[nodiscard]] const std::vector<std::string> &get_args() const noexcept { return args; }
 
+    /**
+     * @brief Retrieves the return type.
+     *
+     * @return const std::optional<std::reference_wrapper<type>>& The return type of the method, or `std::nullopt` if the method does not return a value.
+     */
+    [[nodiscard]] const std::optional<std::reference_wrapper<type>> &get_return_type() const noexcept { return return_type; }
+
     /**
      * @brief Invokes a method with the given environment context and arguments.
      *
@@ -47,5 +54,7 @@ namespace riddle
     const std::string name;                                        // The name of the method.
     std::vector<std::string> args;                                 // The names of the arguments.
     const std::vector<std::unique_ptr<statement>> &body;           // The body of the method.
+    const frame_layout &layout;                                    // The layout of the frames the method is invoked in.
+    const lazy_program &code;                                      // The body of the method, compiled into bytecode.
   };
 } // namespace riddle
@@ -4,12 +4,63 @@
 
 namespace riddle
 {
+  /**
+   * @class compilation_unit_listener parser.hpp "include/parser.hpp"
+   * @brief A listener notified of the top-level elements of a compilation unit as soon as they are parsed.
+   */
+  class compilation_unit_listener
+  {
+  public:
+    virtual ~compilation_unit_listener() = default;
+
+    virtual void parsed(std::unique_ptr<type_declaration> &&td) = 0;
+    virtual void parsed(std::unique_ptr<method_declaration> &&md) = 0;
+    virtual void parsed(std::unique_ptr<predicate_declaration> &&pd) = 0;
+    virtual void parsed(std::unique_ptr<statement> &&stmt) = 0;
+
+    /**
+     * @brief Returns whether each top-level element is to be allocated from an arena of its own.
+     *
+     * If so, the parser starts a new arena before parsing each element, and the listener, when notified of the element, retrieves it through `parser::get_arena`. The memory of the elements which are dropped is released as soon as their arena is no longer referred to.
+     */
+    [[nodiscard]] virtual bool element_arenas() const noexcept { return false; }
+  };
+
   class parser final
   {
   public:
-    parser(std::istream &is);
+    /**
+     * @brief Constructs a parser which reads the given input stream incrementally.
+     *
+     * @param is The input stream to parse. It must outlive the parser.
+     * @param symbols The symbol table in which the identifiers are interned, usually the one of the core the trees are meant for. It must outlive the trees.
+     */
+    parser(std::istream &is, symbol_table &symbols);
+    /**
+     * @brief Constructs a parser for the given source buffer.
+     *
+     * @param src The source to parse. It must outlive the parser.
+     * @param symbols The symbol table in which the identifiers are interned, usually the one of the core the trees are meant for. It must outlive the trees.
+     */
+    parser(std::string_view src, symbol_table &symbols);
+    parser(const parser &) = delete;
+    parser &operator=(const parser &) = delete;
 
     [[nodiscard]] std::unique_ptr<compilation_unit> parse_compilation_unit();
+    /**
+     * @brief Parses a compilation unit, handing each top-level element to the given listener as soon as it is parsed.
+     *
+     * The nodes of the elements are allocated from the arena of the parser, or from an arena per element if the listener asks for it, which the listener must keep alive as long as the nodes. The nodes built by the other `parse_*` functions, when called directly, are allocated from the heap instead. The tokens of the elements already handed to the listener are released, so that the memory held by the parser is bounded by the size of the largest element rather than by the size of the source.
+     *
+     * @param listener The listener notified of the parsed elements.
+     */
+    void parse_compilation_unit(compilation_unit_listener &listener);
+    /**
+     * @brief Returns the arena the nodes built by `parse_compilation_unit` are allocated from, i.e., the arena of the last parsed element if each element is allocated from an arena of its own.
+     *
+     * The arena must outlive the nodes: the compilation units built by the parser share its ownership.
+     */
+    [[nodiscard]] const std::shared_ptr<arena> &get_arena() const noexcept { return nodes; }
     [[nodiscard]] std::unique_ptr<enum_declaration> parse_enum_declaration();
     [[nodiscard]] std::unique_ptr<class_declaration> parse_class_declaration();
     [[nodiscard]] std::unique_ptr<field_declaration> parse_field_declaration();
@@ -17,16 +68,29 @@ namespace riddle
     [[nodiscard]] std::unique_ptr<constructor_declaration> parse_constructor_declaration();
     [[nodiscard]] std::unique_ptr<predicate_declaration> parse_predicate_declaration();
     [[nodiscard]] std::unique_ptr<statement> parse_statement();
-    [[nodiscard]] std::unique_ptr<expression> parse_expression(std::size_t precedence = 0);
+    [[nodiscard]] std::unique_ptr<expression> parse_expression();
 
   private:
     [[nodiscard]] bool match(const symbol &sym);
 
+    [[nodiscard]] id_token id_at(size_t p);
+    [[nodiscard]] id_token kw_at(size_t p, const char *kw);
+    [[nodiscard]] bool_token bool_at(size_t p);
+    [[nodiscard]] int_token int_at(size_t p);
+    [[nodiscard]] real_token real_at(size_t p);
+    [[nodiscard]] string_token string_at(size_t p);
+
     void error(std::string &&err);
 
+    template <typename T, typename... Args>
+    [[nodiscard]] std::unique_ptr<T> make_node(Args &&...args) { return riddle::make_node<T>(c_nodes, std::forward<Args>(args)...); }
+
   private:
-    lexer lex;                                     // The lexer object
-    std::vector<std::unique_ptr<const token>> tokens; // The tokens
-    std::size_t pos = 0;                           // The current position in the tokens
+    symbol_table &symbols;        // The symbol table in which the identifiers are interned
+    lexer lex;                    // The lexer producing the tokens
+    token_stream tokens;          // The tokens, pulled from the lexer on demand
+    std::size_t pos = 0;          // The current position in the tokens
+    std::shared_ptr<arena> nodes; // The arena the nodes of the compilation units are allocated from
+    arena *c_nodes = nullptr;     // The arena the nodes are currently allocated from, if any, or null for the heap
   };
 } // namespace riddle
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+
+namespace riddle
+{
+  /**
+   * @class ring_buffer ring_buffer.hpp "include/ring_buffer.hpp"
+   * @brief A growable ring buffer addressed through absolute indices.
+   *
+   * Elements are appended at the back and released from the front. Every element keeps, for its whole lifetime, the index it was given when appended, so that consumers can refer to elements through stable positions regardless of how many elements have been released in the meantime. The storage doubles only when the retained elements do not fit anymore.
+   *
+   * @tparam T The type of the elements. It must be default constructible.
+   */
+  template <typename T>
+  class ring_buffer final
+  {
+  public:
+    ring_buffer(size_t capacity = 64) : buf(round_up(capacity)), mask(buf.size() - 1) {}
+
+    /**
+     * @brief Returns the index of the first retained element.
+     */
+    [[nodiscard]] size_t begin_index() const noexcept { return first; }
+    /**
+     * @brief Returns the index the next appended element will be given.
+     */
+    [[nodiscard]] size_t end_index() const noexcept { return last; }
+    /**
+     * @brief Checks whether the element with the given index is retained.
+     */
+    [[nodiscard]] bool contains(size_t idx) const noexcept { return idx >= first && idx < last; }
+
+    [[nodiscard]] T &operator[](size_t idx) noexcept
+    {
+      assert(contains(idx));
+      return buf[idx & mask];
+    }
+    [[nodiscard]] const T &operator[](size_t idx) const noexcept
+    {
+      assert(contains(idx));
+      return buf[idx & mask];
+    }
+    [[nodiscard]] T &back() noexcept { return (*this)[last - 1]; }
+
+    /**
+     * @brief Appends an element, growing the storage if needed.
+     *
+     * @return The index of the appended element.
+     */
+    size_t push_back(T &&val)
+    {
+      if (last - first == buf.size())
+        grow();
+      buf[last & mask] = std::move(val);
+      return last++;
+    }
+
+    /**
+     * @brief Releases all the elements whose index is lower than the given one.
+     *
+     * @param idx The index of the first element to retain.
+     */
+    void release(size_t idx) noexcept
+    {
+      for (; first < idx && first < last; ++first)
+        buf[first & mask] = T(); // we release the resources held by the element..
+    }
+
+  private:
+    void grow()
+    {
+      std::vector<T> c_buf(buf.size() * 2);
+      for (size_t i = first; i < last; ++i)
+        c_buf[i & (c_buf.size() - 1)] = std::move(buf[i & mask]);
+      buf = std::move(c_buf);
+      mask = buf.size() - 1;
+    }
+
+    static size_t round_up(size_t capacity) noexcept
+    {
+      size_t c = 1;
+      while (c < capacity)
+        c <<= 1;
+      return c;
+    }
+
+  private:
+    std::vector<T> buf; // the storage, whose size is always a power of two..
+    size_t mask;        // the mask turning indices into storage positions..
+    size_t first = 0;   // the index of the first retained element..
+    size_t last = 0;    // the index of the next appended element..
+  };
+} // namespace riddle
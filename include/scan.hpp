@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+namespace riddle::scan
+{
+  /**
+   * @brief The instruction sets the scanning primitives can be implemented with.
+   */
+  enum class isa
+  {
+    scalar, // Portable, one character at a time
+    sse2,   // 16 characters at a time
+    avx2    // 32 characters at a time
+  };
+
+  /**
+   * @brief Returns the widest instruction set supported by the running processor.
+   */
+  [[nodiscard]] isa supported() noexcept;
+  /**
+   * @brief Returns the instruction set currently used by the scanning primitives.
+   */
+  [[nodiscard]] isa current() noexcept;
+  /**
+   * @brief Selects the instruction set used by the scanning primitives.
+   *
+   * The widest supported instruction set is selected at startup, so this is meant for benchmarks and tests only. It is not thread-safe with respect to concurrent scans.
+   *
+   * @param set The instruction set to use. If not supported by the running processor, the widest supported one is used instead.
+   */
+  void use(isa set) noexcept;
+
+  /**
+   * @brief Checks whether the given character can be part of an identifier.
+   *
+   * Characters outside the ASCII range are accepted, so that identifiers can contain UTF-8 encoded characters.
+   */
+  [[nodiscard]] constexpr bool is_id_char(char ch) noexcept { return ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || static_cast<unsigned char>(ch) >= 0x80; }
+
+  /**
+   * @brief Skips spaces, tabs and carriage returns.
+   *
+   * New lines are not skipped, so that the caller can keep track of them.
+   *
+   * @return The first character in `[p, end)` which is not a space, a tab or a carriage return, or `end`.
+   */
+  [[nodiscard]] const char *skip_spaces(const char *p, const char *end) noexcept;
+  /**
+   * @brief Skips the characters which can be part of an identifier.
+   *
+   * @return The first character in `[p, end)` which cannot be part of an identifier, or `end`.
+   */
+  [[nodiscard]] const char *skip_id(const char *p, const char *end) noexcept;
+  /**
+   * @brief Finds the first occurrence of the given character.
+   *
+   * @return The first occurrence of `c` in `[p, end)`, or `end`.
+   */
+  [[nodiscard]] const char *find(const char *p, const char *end, char c) noexcept;
+  /**
+   * @brief Finds the first occurrence of either of the given characters.
+   *
+   * @return The first occurrence of `c0` or `c1` in `[p, end)`, or `end`.
+   */
+  [[nodiscard]] const char *find_either(const char *p, const char *end, char c0, char c1) noexcept;
+} // namespace riddle::scan
@@ -4,7 +4,7 @@
 
 namespace riddle
 {
-  class statement
+  class statement : public ast_node
   {
   public:
     statement() = default;
@@ -12,6 +12,42 @@ namespace riddle
     virtual ~statement() = default;
 
     virtual void execute(const scope &scp, env &ctx) const = 0;
+
+    /**
+     * @brief Binds the names the statement declares, or refers to, into the slots of the given layout.
+     *
+     * Bound statements must be executed within frames having the given layout.
+     *
+     * @param layout The layout of the frames the statement is executed in.
+     */
+    virtual void bind(frame_layout &layout) = 0;
+
+    /**
+     * @brief Compiles the statement through the given compiler.
+     *
+     * @param c The compiler.
+     */
+    virtual void compile(program_compiler &c) const = 0;
+
+    /**
+     * @brief Checks the types of the statement's expressions within the given context, declaring the items the statement introduces.
+     *
+     * @param ctx The context in which the statement is checked.
+     * @throws std::runtime_error if the statement is ill-typed, or std::out_of_range if it refers to an unknown item, type, method or predicate.
+     */
+    virtual void check(type_context &ctx) = 0;
+
+    /**
+     * @brief Writes the statement through the given writer.
+     *
+     * @param w The writer.
+     */
+    virtual void write(ast_writer &w) const = 0;
+
+    /**
+     * @brief Returns whether the terms created by executing the statement might refer to the statement, which must then outlive them.
+     */
+    [[nodiscard]] virtual bool is_referred() const noexcept { return false; }
   };
 
   class local_field_statement final : public statement
@@ -20,10 +56,26 @@ namespace riddle
     local_field_statement(std::vector<id_token> &&field_type, std::vector<std::pair<id_token, std::unique_ptr<expression>>> &&fields) : field_type(std::move(field_type)), fields(std::move(fields)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+
+    /**
+     * @brief Creates the item a local field of the given type is initialized with, when no initializer is given.
+     *
+     * @param ctx The environment in which the field is created.
+     * @param tp The type of the field.
+     * @return The item.
+     * @throws inconsistency_exception if the type is a component type without instances.
+     */
+    [[nodiscard]] static expr new_local(env &ctx, type &tp);
 
   private:
     std::vector<id_token> field_type;
     std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
+    std::vector<std::size_t> slots; // the slots of the fields, if bound..
+    type *resolved_type = nullptr;  // the type of the fields, once checked..
   };
 
   class assignment_statement final : public statement
@@ -32,11 +84,16 @@ namespace riddle
     assignment_statement(std::vector<id_token> &&object_id, id_token &&field_id, std::unique_ptr<expression> value) : object_id(std::move(object_id)), field_id(std::move(field_id)), value(std::move(value)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::vector<id_token> object_id;
     id_token field_id;
     std::unique_ptr<expression> value;
+    std::size_t slot = unbound_slot; // the slot of the object, if bound..
   };
 
   class expression_statement final : public statement
@@ -45,6 +102,18 @@ namespace riddle
     expression_statement(std::unique_ptr<expression> xpr) : xpr(std::move(xpr)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+
+    /**
+     * @brief Asserts the given constraint, by converting it into conjunctive normal form and by asserting each of its clauses.
+     *
+     * @param scp The scope in which the constraint is asserted.
+     * @param xpr The constraint.
+     */
+    static void assert_constraint(const scope &scp, const expr &xpr);
 
   private:
     std::unique_ptr<expression> xpr;
@@ -60,6 +129,11 @@ namespace riddle
     conjunction_statement(std::vector<std::unique_ptr<statement>> &&stmts, std::unique_ptr<expression> cst = nullptr) : stmts(std::move(stmts)), cst(std::move(cst)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+    [[nodiscard]] bool is_referred() const noexcept override;
 
   private:
     std::vector<std::unique_ptr<statement>> stmts;
@@ -72,9 +146,15 @@ namespace riddle
     disjunction_statement(std::vector<std::unique_ptr<conjunction_statement>> &&blocks) : blocks(std::move(blocks)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+    [[nodiscard]] bool is_referred() const noexcept override { return true; } // the posted conjunctions execute the blocks..
 
   private:
     std::vector<std::unique_ptr<conjunction_statement>> blocks;
+    bool bound = false; // whether the statement has been bound..
   };
 
   class for_all_statement final : public statement
@@ -83,11 +163,18 @@ namespace riddle
     for_all_statement(std::vector<id_token> &&enum_type, id_token &&enum_id, std::vector<std::unique_ptr<statement>> stmts) : enum_type(std::move(enum_type)), enum_id(std::move(enum_id)), stmts(std::move(stmts)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+    [[nodiscard]] bool is_referred() const noexcept override;
 
   private:
     std::vector<id_token> enum_type;
     id_token enum_id;
     std::vector<std::unique_ptr<statement>> stmts;
+    std::size_t slot = unbound_slot; // the slot of the variable, if bound..
+    type *resolved_type = nullptr;   // the type of the variable, once checked..
   };
 
   class return_statement final : public statement
@@ -96,9 +183,14 @@ namespace riddle
     return_statement(std::unique_ptr<expression> xpr) : xpr(std::move(xpr)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
 
   private:
     std::unique_ptr<expression> xpr;
+    std::size_t slot = unbound_slot; // the slot of the returned value, if bound..
   };
 
   class formula_statement final : public statement
@@ -107,6 +199,24 @@ namespace riddle
     formula_statement(bool is_fact, id_token &&id, std::vector<id_token> &&tau, id_token &&predicate_name, std::vector<std::pair<id_token, std::unique_ptr<expression>>> &&args) : is_fact(is_fact), id(std::move(id)), tau(std::move(tau)), predicate_name(std::move(predicate_name)), args(std::move(args)) {}
 
     void execute(const scope &scp, env &ctx) const override;
+    void write(ast_writer &w) const override;
+    void compile(program_compiler &c) const override;
+    void check(type_context &ctx) override;
+    void bind(frame_layout &layout) override;
+
+    /**
+     * @brief Creates a new atom, initializing the arguments of its predicate which are not given.
+     *
+     * @param scp The scope in which the atom is created.
+     * @param ctx The environment in which the atom is created.
+     * @param is_fact Whether the atom is a fact or a goal.
+     * @param predicate_name The name of the predicate.
+     * @param qualified Whether the predicate is qualified by the tau, rather than resolved within the scope.
+     * @param resolved The predicate the name has been resolved to while checking, or `nullptr` if it has not been checked or is qualified.
+     * @param args The arguments of the atom, including its tau, if any.
+     * @return The new atom.
+     */
+    [[nodiscard]] static expr new_atom(const scope &scp, env &ctx, bool is_fact, std::string_view predicate_name, bool qualified, predicate *resolved, item_map &&args);
 
   private:
     bool is_fact;
@@ -114,5 +224,8 @@ namespace riddle
     std::vector<id_token> tau;
     id_token predicate_name;
     std::vector<std::pair<id_token, std::unique_ptr<expression>>> args;
+    std::size_t slot = unbound_slot;         // the slot of the atom, if bound..
+    std::size_t tau_slot = unbound_slot;     // the slot of the tau, if bound..
+    predicate *resolved_predicate = nullptr; // the predicate of the atom, once checked, if not qualified..
   };
-} // namespace riddle
+} // namespace riddle
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace riddle
+{
+  /**
+   * @class symbol_table symbol_table.hpp "include/symbol_table.hpp"
+   * @brief Interns identifiers.
+   *
+   * Each distinct identifier is stored exactly once and is handed out as a reference to the stored string, which remains valid for the whole lifetime of the table. Identifiers are never removed, hence each core owns its table, which the lexers and the parsers working for the core are given explicitly, and which is released together with the core. Tokens and the nodes of the abstract syntax tree refer to the interned strings rather than holding copies of them.
+   *
+   * Interning is confined to the front end: the scopes, the environments and the core still key their fields, items, types and predicates on `std::string`, and look them up by content.
+   */
+  class symbol_table final
+  {
+  public:
+    /**
+     * @brief Constructs a new symbol table.
+     *
+     * @param concurrent Whether the table can be accessed concurrently by more threads.
+     */
+    symbol_table(bool concurrent = false) noexcept : concurrent(concurrent) {}
+    symbol_table(const symbol_table &) = delete;
+
+    /**
+     * @brief Interns the given identifier.
+     *
+     * @param id The identifier to intern.
+     * @return A reference to the interned identifier.
+     */
+    [[nodiscard]] const std::string &intern(std::string_view id);
+
+    /**
+     * @brief Returns the number of distinct identifiers in the table.
+     *
+     * @return The number of distinct identifiers.
+     */
+    [[nodiscard]] size_t size() const noexcept { return ids.size(); }
+
+    /**
+     * @brief Sets whether the table can be accessed concurrently by more threads.
+     *
+     * The setting must not be changed while the table is being accessed by other threads.
+     *
+     * @param c Whether the table can be accessed concurrently.
+     */
+    void set_concurrent(bool c) noexcept { concurrent = c; }
+
+  private:
+    [[nodiscard]] const std::string &do_intern(std::string_view id);
+
+  private:
+    bool concurrent;                                                 // whether the table can be accessed concurrently..
+    std::mutex mtx;                                                  // the mutex protecting the table, if concurrent..
+    std::deque<std::string> ids;                                     // the interned identifiers..
+    std::unordered_map<std::string_view, const std::string *> index; // the interned identifiers, indexed by their content..
+  };
+} // namespace riddle
@@ -3,6 +3,7 @@
 #include "env.hpp"
 #include "enum.hpp"
 #include "resolver.hpp"
+#include <cstdint>
 #include <vector>
 
 namespace riddle
@@ -20,6 +21,35 @@ namespace riddle
   using bool_expr = std::shared_ptr<bool_term>;
   class expression_statement;
 
+  /**
+   * @brief The kinds of terms.
+   *
+   * The kind of a term is set when the term is constructed, so that terms can be told apart without resorting to run-time type information.
+   */
+  enum class term_kind : std::uint8_t
+  {
+    bool_kind,      // a boolean term, other than the ones below..
+    and_kind,       // a conjunction..
+    or_kind,        // a disjunction..
+    xor_kind,       // an exclusive disjunction..
+    not_kind,       // a negation..
+    lt_kind,        // a `<` comparison..
+    le_kind,        // a `<=` comparison..
+    eq_kind,        // an `==` comparison..
+    ge_kind,        // a `>=` comparison..
+    gt_kind,        // a `>` comparison..
+    arith_kind,     // an arithmetic term..
+    string_kind,    // a string term..
+    component_kind, // an instance of a component type..
+    enum_kind,      // an enumerated term..
+    atom_kind       // an atom..
+  };
+
+  /**
+   * @brief Checks whether terms of the given kind are boolean terms.
+   */
+  [[nodiscard]] constexpr bool is_bool_kind(term_kind kind) noexcept { return kind <= term_kind::gt_kind; }
+
   /**
    * @class term term.hpp "include/term.hpp"
    * @brief The term class.
@@ -31,7 +61,7 @@ namespace riddle
   class term : public utils::enum_val
   {
   public:
-    term(type &tp) noexcept : tp(tp) {}
+    term(type &tp, term_kind kind) noexcept : tp(tp), kind(kind) {}
     term(const term &) = delete;
 
     /**
@@ -52,16 +82,24 @@ namespace riddle
      */
     [[nodiscard]] type &get_type() const noexcept { return tp; }
 
+    /**
+     * @brief Get the kind of the term.
+     *
+     * @return The kind of the term.
+     */
+    [[nodiscard]] term_kind get_kind() const noexcept { return kind; }
+
     [[nodiscard]] virtual json::json to_json() const noexcept = 0;
 
   private:
     type &tp;
+    const term_kind kind;
   };
 
   class bool_term : public term
   {
   public:
-    bool_term(bool_type &tp) noexcept;
+    bool_term(bool_type &tp, term_kind kind = term_kind::bool_kind) noexcept;
 
     [[nodiscard]] virtual std::string to_string() const noexcept override;
 
@@ -73,7 +111,7 @@ namespace riddle
     friend expression_statement;
 
   public:
-    and_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp), args(std::move(args)) {}
+    and_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp, term_kind::and_kind), args(std::move(args)) {}
 
     friend bool_expr push_negations(bool_expr expr) noexcept;
     friend bool_expr distribute(bool_expr expr) noexcept;
@@ -87,7 +125,7 @@ namespace riddle
     friend expression_statement;
 
   public:
-    or_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp), args(std::move(args)) {}
+    or_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp, term_kind::or_kind), args(std::move(args)) {}
 
     friend bool_expr push_negations(bool_expr expr) noexcept;
     friend bool_expr distribute(bool_expr expr) noexcept;
@@ -99,7 +137,7 @@ namespace riddle
   class xor_term : public bool_term
   {
   public:
-    xor_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp), args(std::move(args)) {}
+    xor_term(bool_type &tp, std::vector<bool_expr> &&args) noexcept : bool_term(tp, term_kind::xor_kind), args(std::move(args)) {}
 
   private:
     std::vector<bool_expr> args;
@@ -108,9 +146,9 @@ namespace riddle
   class bool_not : public bool_term
   {
   public:
-    bool_not(bool_type &tp, bool_expr arg) noexcept : bool_term(tp), arg(std::move(arg)) {}
+    bool_not(bool_type &tp, bool_expr arg) noexcept : bool_term(tp, term_kind::not_kind), arg(std::move(arg)) {}
 
-    bool_expr get_arg() const noexcept { return arg; }
+    const bool_expr &get_arg() const noexcept { return arg; }
 
     friend bool_expr push_negations(bool_expr expr) noexcept;
 
@@ -133,10 +171,10 @@ namespace riddle
   class lt_term : public bool_term
   {
   public:
-    lt_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    lt_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp, term_kind::lt_kind), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
-    arith_expr get_lhs() const noexcept { return lhs; }
-    arith_expr get_rhs() const noexcept { return rhs; }
+    const arith_expr &get_lhs() const noexcept { return lhs; }
+    const arith_expr &get_rhs() const noexcept { return rhs; }
 
   private:
     arith_expr lhs, rhs;
@@ -145,10 +183,10 @@ namespace riddle
   class le_term : public bool_term
   {
   public:
-    le_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    le_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp, term_kind::le_kind), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
-    arith_expr get_lhs() const noexcept { return lhs; }
-    arith_expr get_rhs() const noexcept { return rhs; }
+    const arith_expr &get_lhs() const noexcept { return lhs; }
+    const arith_expr &get_rhs() const noexcept { return rhs; }
 
   private:
     arith_expr lhs, rhs;
@@ -157,10 +195,10 @@ namespace riddle
   class eq_term : public bool_term
   {
   public:
-    eq_term(bool_type &tp, expr lhs, expr rhs) noexcept : bool_term(tp), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    eq_term(bool_type &tp, expr lhs, expr rhs) noexcept : bool_term(tp, term_kind::eq_kind), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
-    expr get_lhs() const noexcept { return lhs; }
-    expr get_rhs() const noexcept { return rhs; }
+    const expr &get_lhs() const noexcept { return lhs; }
+    const expr &get_rhs() const noexcept { return rhs; }
 
   private:
     expr lhs, rhs;
@@ -169,10 +207,10 @@ namespace riddle
   class ge_term : public bool_term
   {
   public:
-    ge_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    ge_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp, term_kind::ge_kind), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
-    arith_expr get_lhs() const noexcept { return lhs; }
-    arith_expr get_rhs() const noexcept { return rhs; }
+    const arith_expr &get_lhs() const noexcept { return lhs; }
+    const arith_expr &get_rhs() const noexcept { return rhs; }
 
   private:
     arith_expr lhs, rhs;
@@ -181,10 +219,10 @@ namespace riddle
   class gt_term : public bool_term
   {
   public:
-    gt_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+    gt_term(bool_type &tp, arith_expr lhs, arith_expr rhs) noexcept : bool_term(tp, term_kind::gt_kind), lhs(std::move(lhs)), rhs(std::move(rhs)) {}
 
-    arith_expr get_lhs() const noexcept { return lhs; }
-    arith_expr get_rhs() const noexcept { return rhs; }
+    const arith_expr &get_lhs() const noexcept { return lhs; }
+    const arith_expr &get_rhs() const noexcept { return rhs; }
 
   private:
     arith_expr lhs, rhs;
@@ -252,7 +290,7 @@ namespace riddle
   class atom_term : public term, public env
   {
   public:
-    atom_term(flaw &flw, predicate &t, bool fact, std::map<std::string, expr, std::less<>> &&args = {}) noexcept;
+    atom_term(flaw &flw, predicate &t, bool fact, item_map &&args = {}) noexcept;
 
     [[nodiscard]] flaw &get_flaw() const noexcept { return flw; }
 
@@ -263,7 +301,7 @@ namespace riddle
     [[nodiscard]] virtual json::json to_json() const noexcept override;
 
   private:
-    static env &atom_parent(const predicate &t, const std::map<std::string, expr, std::less<>> &args);
+    static env &atom_parent(const predicate &t, const item_map &args);
 
   private:
     flaw &flw; // the flaw this atom belongs to
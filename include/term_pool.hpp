@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace riddle
+{
+  /**
+   * @class term_pool term_pool.hpp "include/term_pool.hpp"
+   * @brief A pool of memory blocks grouped by size class.
+   *
+   * Blocks are carved out of large chunks and, once released, are kept in a free list of their size class, so that they can be handed out again without involving the global allocator. Requests larger than the largest size class are served by the global allocator. A pool is not thread-safe: it is meant to serve the terms of a single core, which is used by one thread at a time.
+   */
+  class term_pool final
+  {
+    template <typename Tp>
+    friend class pool_allocator;
+
+  public:
+    static constexpr size_t granularity = alignof(std::max_align_t);    // the difference between the sizes of two consecutive size classes..
+    static constexpr size_t max_block_size = 16 * granularity;          // the size of the largest size class..
+    static constexpr size_t size_classes = max_block_size / granularity; // the number of size classes..
+
+    /**
+     * @brief Constructs a new pool.
+     *
+     * @param chunk_size The size of the chunks blocks are carved out of.
+     */
+    term_pool(size_t chunk_size = 1 << 16) noexcept : chunk_size(chunk_size) {}
+    term_pool(const term_pool &) = delete;
+    term_pool &operator=(const term_pool &) = delete;
+
+    /**
+     * @brief Allocates a block of the given number of bytes, suitably aligned for any scalar type.
+     *
+     * @param size The number of bytes to allocate.
+     * @return A pointer to the allocated block.
+     */
+    [[nodiscard]] void *allocate(size_t size);
+    /**
+     * @brief Releases a block previously allocated from this pool.
+     *
+     * @param ptr The block to release.
+     * @param size The number of bytes the block has been allocated with.
+     */
+    void deallocate(void *ptr, size_t size) noexcept;
+
+    /**
+     * @brief Returns the number of bytes currently allocated from the pool.
+     */
+    [[nodiscard]] size_t allocated() const noexcept { return used; }
+    /**
+     * @brief Returns the number of bytes reserved by the pool for its chunks.
+     */
+    [[nodiscard]] size_t reserved() const noexcept { return chunks.size() * chunk_size; }
+
+  private:
+    struct free_block
+    {
+      free_block *next;
+    };
+
+    const size_t chunk_size;                          // the size of the chunks..
+    std::vector<std::unique_ptr<std::byte[]>> chunks; // the chunks blocks are carved out of..
+    std::byte *cur = nullptr;                         // the first free byte of the last chunk..
+    std::byte *end = nullptr;                         // the end of the last chunk..
+    std::array<free_block *, size_classes> free{};    // the released blocks of each size class..
+    size_t used = 0;                                  // the number of bytes currently allocated..
+    size_t refs = 0;                                  // the number of allocators referring to the pool..
+  };
+
+  /**
+   * @class pool_allocator term_pool.hpp "include/term_pool.hpp"
+   * @brief An allocator drawing its memory from a term pool.
+   *
+   * Allocators share the ownership of their pool through a non-atomic reference count: the pool is destroyed together with the last allocator referring to it. Since `std::allocate_shared` keeps a copy of the allocator in the control block of each created object, the pool outlives all the objects allocated from it.
+   *
+   * @tparam Tp The type of the allocated objects.
+   */
+  template <typename Tp>
+  class pool_allocator
+  {
+    template <typename Up>
+    friend class pool_allocator;
+
+  public:
+    using value_type = Tp;
+
+    /**
+     * @brief Constructs an allocator drawing from a new pool.
+     */
+    pool_allocator() : pool(new term_pool()) { ++pool->refs; }
+    pool_allocator(const pool_allocator &other) noexcept : pool(other.pool) { ++pool->refs; }
+    template <typename Up>
+    pool_allocator(const pool_allocator<Up> &other) noexcept : pool(other.pool) { ++pool->refs; }
+    pool_allocator &operator=(const pool_allocator &) = delete;
+    ~pool_allocator()
+    {
+      if (--pool->refs == 0)
+        delete pool;
+    }
+
+    [[nodiscard]] Tp *allocate(size_t n)
+    {
+      static_assert(alignof(Tp) <= term_pool::granularity, "over-aligned types cannot be pooled");
+      return static_cast<Tp *>(pool->allocate(n * sizeof(Tp)));
+    }
+    void deallocate(Tp *ptr, size_t n) noexcept { pool->deallocate(ptr, n * sizeof(Tp)); }
+
+    /**
+     * @brief Returns the pool the allocator draws from.
+     */
+    [[nodiscard]] const term_pool &get_pool() const noexcept { return *pool; }
+
+    template <typename Up>
+    bool operator==(const pool_allocator<Up> &other) const noexcept { return pool == other.pool; }
+    template <typename Up>
+    bool operator!=(const pool_allocator<Up> &other) const noexcept { return pool != other.pool; }
+
+  private:
+    term_pool *pool; // the pool the memory is drawn from..
+  };
+} // namespace riddle
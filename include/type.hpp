@@ -375,7 +375,7 @@ namespace riddle
     friend class predicate_declaration;
 
   public:
-    predicate(scope &scp, std::string &&name, std::vector<std::unique_ptr<field>> &&args = {}, const std::vector<std::unique_ptr<statement>> &body = {}) noexcept;
+    predicate(scope &scp, std::string &&name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept;
     virtual ~predicate() = default;
 
     [[nodiscard]] bool is_assignable_from(const type &other) const override;
@@ -417,6 +417,8 @@ namespace riddle
     std::vector<std::reference_wrapper<predicate>> parents; // the base predicates (i.e. the predicates this predicate inherits from)..
     std::vector<std::reference_wrapper<field>> args;        // the arguments of the predicate..
     const std::vector<std::unique_ptr<statement>> &body;    // the body of the predicate..
+    const frame_layout &layout;                             // the layout of the frames the predicate is called in..
+    const lazy_program &code;                               // the body of the predicate, compiled into bytecode..
     std::vector<atom_expr> atoms;                           // the atoms of the predicate..
   };
 
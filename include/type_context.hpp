@@ -0,0 +1,88 @@
+#pragma once
+
+#include "type.hpp"
+
+namespace riddle
+{
+  /**
+   * @class type_context type_context.hpp "include/type_context.hpp"
+   * @brief The static types of the items visible while checking a body.
+   *
+   * A context mirrors the environments the checked statements are executed in: the items declared by the statements themselves come first, then the items of the object the body is executed on (i.e., the fields of a component type, or the arguments of a predicate), and then the global items.
+   */
+  class type_context final
+  {
+  public:
+    /**
+     * @brief Constructs a context.
+     *
+     * @param scp The scope in which the statements are checked.
+     * @param globals The context of the global items, or `nullptr` for resolving the global items against the core.
+     * @param self The type of the object the statements are executed on, if any.
+     * @param return_type The type of the values the statements return, if any.
+     */
+    type_context(const scope &scp, const type_context *globals = nullptr, const type *self = nullptr, const type *return_type = nullptr) noexcept : scp(scp), globals(globals), self(self), return_type(return_type) {}
+    type_context(const type_context &) = delete;
+
+    /**
+     * @brief Returns the scope in which the statements are checked.
+     */
+    [[nodiscard]] const scope &get_scope() const noexcept { return scp; }
+    /**
+     * @brief Returns the type of the values the statements return, or `nullptr` if they cannot return values.
+     */
+    [[nodiscard]] const type *get_return_type() const noexcept { return return_type; }
+
+    /**
+     * @brief Declares an item of the given type, hiding any visible item with the same name.
+     *
+     * @param name The name of the item.
+     * @param tp The type of the item.
+     */
+    void declare(std::string_view name, const type &tp) { locals.emplace_back(name, &tp); }
+
+    /**
+     * @brief Opens a block: the items declared within it are not visible once it is closed.
+     */
+    void open_scope() { scopes.push_back(locals.size()); }
+    /**
+     * @brief Closes the innermost block.
+     */
+    void close_scope()
+    {
+      locals.resize(scopes.back());
+      scopes.pop_back();
+    }
+
+    /**
+     * @brief Returns the type of the visible item with the given name.
+     *
+     * @param name The name of the item.
+     * @return const type& The type of the item.
+     * @throws std::out_of_range if no item with the given name is visible.
+     */
+    [[nodiscard]] const type &get(std::string_view name) const;
+
+    /**
+     * @brief Returns the type of the item with the given name of the items of the given type.
+     *
+     * @param tp The type of the object.
+     * @param name The name of the item.
+     * @return const type& The type of the item.
+     * @throws std::out_of_range if the items of the given type have no item with the given name.
+     */
+    [[nodiscard]] static const type &get_item(const type &tp, std::string_view name);
+
+  private:
+    [[nodiscard]] const type *find(std::string_view name) const;
+    [[nodiscard]] static const type *find_item(const type &tp, std::string_view name);
+
+  private:
+    const scope &scp;                                              // the scope in which the statements are checked..
+    const type_context *globals;                                   // the context of the global items, if any..
+    const type *self;                                              // the type of the object the statements are executed on, if any..
+    const type *return_type;                                       // the type of the returned values, if any..
+    std::vector<std::pair<std::string_view, const type *>> locals; // the declared items..
+    std::vector<std::size_t> scopes;                               // the number of declared items at the start of each open block..
+  };
+} // namespace riddle
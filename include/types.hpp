@@ -62,10 +62,6 @@ namespace riddle
     virtual void created_atom(atom_expr atm) override;
 
     virtual std::shared_ptr<flaw> new_peak(std::vector<atom_expr> &&atms) noexcept = 0;
-
-  private:
-    std::unique_ptr<constructor_declaration> ctr;
-    std::unique_ptr<predicate_declaration> use_pred;
   };
 
   class consumable_resource : public flaw_aware_component_type, public timeline
@@ -84,11 +80,6 @@ namespace riddle
 
     virtual std::shared_ptr<flaw> new_overproduction(std::vector<atom_expr> &&prod_atms, std::vector<atom_expr> &&cons_atms) noexcept = 0;
     virtual std::shared_ptr<flaw> new_overconsumption(std::vector<atom_expr> &&cons_atms, std::vector<atom_expr> &&prod_atms) noexcept = 0;
-
-  private:
-    std::unique_ptr<constructor_declaration> ctr;
-    std::unique_ptr<predicate_declaration> prod_pred;
-    std::unique_ptr<predicate_declaration> cons_pred;
   };
 
   [[nodiscard]] std::vector<std::shared_ptr<resolver>> causes_from_atoms(const std::vector<atom_expr> &atms) noexcept;
@@ -0,0 +1,47 @@
+#include "arena.hpp"
+#include <algorithm>
+
+namespace riddle
+{
+    // every node is preceded by a header telling whether it has been allocated from an arena, preserving the alignment of the node..
+    static constexpr size_t header_size = alignof(std::max_align_t);
+
+    void *arena::allocate(size_t size)
+    {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        if (static_cast<size_t>(end - cur) < size)
+        { // we need a new chunk..
+            const auto c_size = std::max(chunk_size, size);
+            chunks.emplace_back(new std::byte[c_size]); // array new aligns for any scalar type..
+            cur = chunks.back().get();
+            end = cur + c_size;
+        }
+        auto *ptr = cur;
+        cur += size;
+        used += size;
+        return ptr;
+    }
+
+    void *ast_node::operator new(size_t size)
+    {
+        auto *ptr = static_cast<std::byte *>(::operator new(header_size + size));
+        *ptr = std::byte{0};
+        return ptr + header_size;
+    }
+
+    void *ast_node::operator new(size_t size, arena &a)
+    {
+        auto *ptr = static_cast<std::byte *>(a.allocate(header_size + size));
+        *ptr = std::byte{1};
+        return ptr + header_size;
+    }
+
+    void ast_node::operator delete(void *ptr) noexcept
+    {
+        if (!ptr)
+            return;
+        auto *header = static_cast<std::byte *>(ptr) - header_size;
+        if (*header == std::byte{0}) // nodes allocated from an arena are released together with the arena..
+            ::operator delete(header);
+    }
+} // namespace riddle
@@ -0,0 +1,819 @@
+#include "ast_cache.hpp"
+#include <stdexcept>
+
+namespace riddle
+{
+    namespace
+    {
+        constexpr char magic[] = {'R', 'D', 'L', 'C'}; // the magic number opening the serialized trees..
+
+        /**
+         * @brief The kinds of the nodes, written before each node so that the right node can be read back.
+         */
+        enum node_kind : std::uint8_t
+        {
+            null_node,
+            // expressions..
+            bool_xpr,
+            int_xpr,
+            bounded_int_xpr,
+            uncertain_int_xpr,
+            real_xpr,
+            bounded_real_xpr,
+            uncertain_real_xpr,
+            string_xpr,
+            id_xpr,
+            and_xpr,
+            or_xpr,
+            xor_xpr,
+            not_xpr,
+            minus_xpr,
+            sum_xpr,
+            subtraction_xpr,
+            product_xpr,
+            division_xpr,
+            lt_xpr,
+            le_xpr,
+            gt_xpr,
+            ge_xpr,
+            eq_xpr,
+            constructor_xpr,
+            call_xpr,
+            // statements..
+            local_field_stmt,
+            assignment_stmt,
+            expression_stmt,
+            conjunction_stmt,
+            disjunction_stmt,
+            for_all_stmt,
+            return_stmt,
+            formula_stmt,
+            // declarations..
+            enum_decl,
+            class_decl
+        };
+
+        [[noreturn]] void corrupted() { throw std::runtime_error("corrupted AST data"); }
+    } // namespace
+
+    std::uint64_t content_hash(std::string_view src) noexcept
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const auto c : src)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    void ast_writer::write_uint(std::uint64_t val)
+    {
+        for (; val >= 0x80; val >>= 7)
+            body.push_back(static_cast<char>((val & 0x7F) | 0x80));
+        body.push_back(static_cast<char>(val));
+    }
+    void ast_writer::write_string(std::string_view str)
+    {
+        write_uint(str.size());
+        body.append(str);
+    }
+
+    void ast_writer::write(const id_token &tk)
+    {
+        const auto [it, added] = idx.emplace(&tk.id, ids.size());
+        if (added)
+            ids.push_back(&tk.id);
+        write_uint(it->second);
+        write_uint(tk.line);
+        write_uint(tk.start_pos);
+        write_uint(tk.end_pos);
+    }
+    void ast_writer::write(const bool_token &tk)
+    {
+        write_bool(tk.value);
+        write_uint(tk.line);
+        write_uint(tk.start_pos);
+        write_uint(tk.end_pos);
+    }
+    void ast_writer::write(const int_token &tk)
+    {
+        write_int(tk.value);
+        write_uint(tk.line);
+        write_uint(tk.start_pos);
+        write_uint(tk.end_pos);
+    }
+    void ast_writer::write(const real_token &tk)
+    {
+        write_int(tk.value.numerator());
+        write_int(tk.value.denominator());
+        write_uint(tk.line);
+        write_uint(tk.start_pos);
+        write_uint(tk.end_pos);
+    }
+    void ast_writer::write(const string_token &tk)
+    {
+        write_string(tk.value);
+        write_uint(tk.line);
+        write_uint(tk.start_pos);
+        write_uint(tk.end_pos);
+    }
+    void ast_writer::write(const std::vector<id_token> &c_ids)
+    {
+        write_uint(c_ids.size());
+        for (const auto &id : c_ids)
+            write(id);
+    }
+
+    void ast_writer::write(const expression *xpr)
+    {
+        if (xpr)
+            xpr->write(*this);
+        else
+            tag(null_node);
+    }
+    void ast_writer::write(const statement *stmt)
+    {
+        if (stmt)
+            stmt->write(*this);
+        else
+            tag(null_node);
+    }
+    void ast_writer::write(const type_declaration *td) { td->write(*this); }
+    void ast_writer::write(const field_declaration *fd) { fd->write(*this); }
+    void ast_writer::write(const constructor_declaration *cd) { cd->write(*this); }
+    void ast_writer::write(const method_declaration *md) { md->write(*this); }
+    void ast_writer::write(const predicate_declaration *pd) { pd->write(*this); }
+
+    std::string ast_writer::finish(std::uint64_t hash) const
+    {
+        ast_writer header;
+        header.body.append(magic, sizeof(magic));
+        header.write_uint(ast_format_version);
+        header.write_uint(sizeof(INT_TYPE));
+        header.write_uint(hash);
+        header.write_uint(ids.size());
+        for (const auto id : ids)
+            header.write_string(*id);
+        return header.body + body;
+    }
+
+    ast_reader::ast_reader(std::string_view data, std::uint64_t hash, symbol_table &symbols, arena *nodes) : data(data), nodes(nodes)
+    {
+        if (data.size() < sizeof(magic) || data.compare(0, sizeof(magic), std::string_view(magic, sizeof(magic))) != 0)
+            throw std::runtime_error("not AST data");
+        pos = sizeof(magic);
+        if (read_uint() != ast_format_version || read_uint() != sizeof(INT_TYPE))
+            throw std::runtime_error("incompatible AST data");
+        if (read_uint() != hash)
+            throw std::runtime_error("stale AST data");
+        const auto n_ids = read_uint();
+        if (n_ids > data.size() - pos) // every identifier takes at least one byte..
+            corrupted();
+        ids.resize(n_ids);
+        for (auto &id : ids)
+            id = &symbols.intern(read_string());
+    }
+
+    std::uint8_t ast_reader::read_byte()
+    {
+        if (pos == data.size())
+            corrupted();
+        return static_cast<std::uint8_t>(data[pos++]);
+    }
+    bool ast_reader::read_bool() { return read_byte() != 0; }
+    std::uint64_t ast_reader::read_uint()
+    {
+        std::uint64_t val = 0;
+        for (unsigned shift = 0;; shift += 7)
+        {
+            if (shift > 63)
+                corrupted();
+            const auto byte = read_byte();
+            val |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return val;
+        }
+    }
+    std::string_view ast_reader::read_string()
+    {
+        const auto size = read_uint();
+        if (size > data.size() - pos)
+            corrupted();
+        const auto str = data.substr(pos, size);
+        pos += size;
+        return str;
+    }
+
+    id_token ast_reader::read_id()
+    {
+        const auto id = read_uint();
+        if (id >= ids.size())
+            corrupted();
+        const auto line = read_uint(), start_pos = read_uint(), end_pos = read_uint();
+        return id_token(*ids[id], line, start_pos, end_pos);
+    }
+    std::vector<id_token> ast_reader::read_ids()
+    {
+        std::vector<id_token> c_ids;
+        for (auto n = read_uint(); n > 0; --n)
+            c_ids.emplace_back(read_id());
+        return c_ids;
+    }
+    bool_token ast_reader::read_bool_token()
+    {
+        const auto val = read_bool();
+        const auto line = read_uint(), start_pos = read_uint(), end_pos = read_uint();
+        return bool_token(val, line, start_pos, end_pos);
+    }
+    int_token ast_reader::read_int_token()
+    {
+        const auto val = static_cast<INT_TYPE>(read_int());
+        const auto line = read_uint(), start_pos = read_uint(), end_pos = read_uint();
+        return int_token(val, line, start_pos, end_pos);
+    }
+    real_token ast_reader::read_real_token()
+    {
+        const auto num = static_cast<INT_TYPE>(read_int()), den = static_cast<INT_TYPE>(read_int());
+        if (den == 0)
+            corrupted();
+        const auto line = read_uint(), start_pos = read_uint(), end_pos = read_uint();
+        return real_token(utils::rational(num, den), line, start_pos, end_pos);
+    }
+    string_token ast_reader::read_string_token()
+    {
+        std::string val(read_string());
+        const auto line = read_uint(), start_pos = read_uint(), end_pos = read_uint();
+        return string_token(std::move(val), line, start_pos, end_pos);
+    }
+
+    std::unique_ptr<expression> ast_reader::read_expression()
+    {
+        switch (read_byte())
+        {
+        case null_node:
+            return nullptr;
+        case bool_xpr:
+            return make_node<bool_expression>(read_bool_token());
+        case int_xpr:
+            return make_node<int_expression>(read_int_token());
+        case bounded_int_xpr:
+        {
+            auto lb = read_int_token();
+            return make_node<bounded_int_expression>(std::move(lb), read_int_token());
+        }
+        case uncertain_int_xpr:
+        {
+            auto lb = read_int_token();
+            return make_node<uncertain_int_expression>(std::move(lb), read_int_token());
+        }
+        case real_xpr:
+            return make_node<real_expression>(read_real_token());
+        case bounded_real_xpr:
+        {
+            auto lb = read_real_token();
+            return make_node<bounded_real_expression>(std::move(lb), read_real_token());
+        }
+        case uncertain_real_xpr:
+        {
+            auto lb = read_real_token();
+            return make_node<uncertain_real_expression>(std::move(lb), read_real_token());
+        }
+        case string_xpr:
+            return make_node<string_expression>(read_string_token());
+        case id_xpr:
+            return make_node<id_expression>(read_ids());
+        case and_xpr:
+            return make_node<and_expression>(read_expressions());
+        case or_xpr:
+            return make_node<or_expression>(read_expressions());
+        case xor_xpr:
+            return make_node<xor_expression>(read_expressions());
+        case not_xpr:
+            return make_node<not_expression>(read_expression());
+        case minus_xpr:
+            return make_node<minus_expression>(read_expression());
+        case sum_xpr:
+            return make_node<sum_expression>(read_expressions());
+        case subtraction_xpr:
+            return make_node<subtraction_expression>(read_expressions());
+        case product_xpr:
+            return make_node<product_expression>(read_expressions());
+        case division_xpr:
+            return make_node<division_expression>(read_expressions());
+        case lt_xpr:
+        {
+            auto lhs = read_expression();
+            return make_node<lt_expression>(std::move(lhs), read_expression());
+        }
+        case le_xpr:
+        {
+            auto lhs = read_expression();
+            return make_node<le_expression>(std::move(lhs), read_expression());
+        }
+        case gt_xpr:
+        {
+            auto lhs = read_expression();
+            return make_node<gt_expression>(std::move(lhs), read_expression());
+        }
+        case ge_xpr:
+        {
+            auto lhs = read_expression();
+            return make_node<ge_expression>(std::move(lhs), read_expression());
+        }
+        case eq_xpr:
+        {
+            auto lhs = read_expression();
+            return make_node<eq_expression>(std::move(lhs), read_expression());
+        }
+        case constructor_xpr:
+        {
+            auto tp_id = read_ids();
+            return make_node<constructor_expression>(std::move(tp_id), read_expressions());
+        }
+        case call_xpr:
+        {
+            auto obj_id = read_ids();
+            auto fn_id = read_id();
+            return make_node<call_expression>(std::move(obj_id), std::move(fn_id), read_expressions());
+        }
+        default:
+            corrupted();
+        }
+    }
+    std::vector<std::unique_ptr<expression>> ast_reader::read_expressions()
+    {
+        std::vector<std::unique_ptr<expression>> xprs;
+        for (auto n = read_uint(); n > 0; --n)
+            xprs.emplace_back(read_expression());
+        return xprs;
+    }
+
+    std::unique_ptr<statement> ast_reader::read_statement()
+    {
+        switch (read_byte())
+        {
+        case null_node:
+            return nullptr;
+        case local_field_stmt:
+        {
+            auto field_type = read_ids();
+            return make_node<local_field_statement>(std::move(field_type), read_inits());
+        }
+        case assignment_stmt:
+        {
+            auto object_id = read_ids();
+            auto field_id = read_id();
+            return make_node<assignment_statement>(std::move(object_id), std::move(field_id), read_expression());
+        }
+        case expression_stmt:
+            return make_node<expression_statement>(read_expression());
+        case conjunction_stmt:
+        {
+            auto stmts = read_statements();
+            return make_node<conjunction_statement>(std::move(stmts), read_expression());
+        }
+        case disjunction_stmt:
+        {
+            std::vector<std::unique_ptr<conjunction_statement>> blocks;
+            for (auto n = read_uint(); n > 0; --n)
+                blocks.emplace_back(read_conjunction());
+            return make_node<disjunction_statement>(std::move(blocks));
+        }
+        case for_all_stmt:
+        {
+            auto enum_type = read_ids();
+            auto enum_id = read_id();
+            return make_node<for_all_statement>(std::move(enum_type), std::move(enum_id), read_statements());
+        }
+        case return_stmt:
+            return make_node<return_statement>(read_expression());
+        case formula_stmt:
+        {
+            const auto is_fact = read_bool();
+            auto id = read_id();
+            auto tau = read_ids();
+            auto predicate_name = read_id();
+            return make_node<formula_statement>(is_fact, std::move(id), std::move(tau), std::move(predicate_name), read_inits());
+        }
+        default:
+            corrupted();
+        }
+    }
+    std::vector<std::unique_ptr<statement>> ast_reader::read_statements()
+    {
+        std::vector<std::unique_ptr<statement>> stmts;
+        for (auto n = read_uint(); n > 0; --n)
+            stmts.emplace_back(read_statement());
+        return stmts;
+    }
+    std::unique_ptr<conjunction_statement> ast_reader::read_conjunction()
+    {
+        if (read_byte() != conjunction_stmt)
+            corrupted();
+        auto stmts = read_statements();
+        return make_node<conjunction_statement>(std::move(stmts), read_expression());
+    }
+
+    std::unique_ptr<type_declaration> ast_reader::read_type_declaration()
+    {
+        switch (read_byte())
+        {
+        case enum_decl:
+        {
+            auto name = read_id();
+            std::vector<string_token> values;
+            for (auto n = read_uint(); n > 0; --n)
+                values.emplace_back(read_string_token());
+            std::vector<std::vector<id_token>> enum_refs;
+            for (auto n = read_uint(); n > 0; --n)
+                enum_refs.emplace_back(read_ids());
+            return make_node<enum_declaration>(std::move(name), std::move(values), std::move(enum_refs));
+        }
+        case class_decl:
+        {
+            auto name = read_id();
+            std::vector<std::vector<id_token>> base_classes;
+            for (auto n = read_uint(); n > 0; --n)
+                base_classes.emplace_back(read_ids());
+            std::vector<std::unique_ptr<field_declaration>> fields;
+            for (auto n = read_uint(); n > 0; --n)
+                fields.emplace_back(read_field_declaration());
+            std::vector<std::unique_ptr<constructor_declaration>> constructors;
+            for (auto n = read_uint(); n > 0; --n)
+                constructors.emplace_back(read_constructor_declaration());
+            std::vector<std::unique_ptr<method_declaration>> methods;
+            for (auto n = read_uint(); n > 0; --n)
+                methods.emplace_back(read_method_declaration());
+            std::vector<std::unique_ptr<predicate_declaration>> predicates;
+            for (auto n = read_uint(); n > 0; --n)
+                predicates.emplace_back(read_predicate_declaration());
+            std::vector<std::unique_ptr<type_declaration>> types;
+            for (auto n = read_uint(); n > 0; --n)
+                types.emplace_back(read_type_declaration());
+            return make_node<class_declaration>(std::move(name), std::move(base_classes), std::move(fields), std::move(constructors), std::move(methods), std::move(predicates), std::move(types));
+        }
+        default:
+            corrupted();
+        }
+    }
+    std::unique_ptr<field_declaration> ast_reader::read_field_declaration()
+    {
+        auto tp = read_ids();
+        return make_node<field_declaration>(std::move(tp), read_inits());
+    }
+    std::unique_ptr<constructor_declaration> ast_reader::read_constructor_declaration()
+    {
+        auto params = read_params();
+        std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> inits;
+        for (auto n = read_uint(); n > 0; --n)
+        {
+            auto id = read_id();
+            inits.emplace_back(std::move(id), read_expressions());
+        }
+        return make_node<constructor_declaration>(std::move(params), std::move(inits), read_statements());
+    }
+    std::unique_ptr<method_declaration> ast_reader::read_method_declaration()
+    {
+        auto rt = read_ids();
+        auto name = read_id();
+        auto params = read_params();
+        return make_node<method_declaration>(std::move(rt), std::move(name), std::move(params), read_statements());
+    }
+    std::unique_ptr<predicate_declaration> ast_reader::read_predicate_declaration()
+    {
+        auto name = read_id();
+        auto params = read_params();
+        std::vector<std::vector<id_token>> base_predicates;
+        for (auto n = read_uint(); n > 0; --n)
+            base_predicates.emplace_back(read_ids());
+        return make_node<predicate_declaration>(std::move(name), std::move(params), std::move(base_predicates), read_statements());
+    }
+
+    std::vector<std::pair<std::vector<id_token>, id_token>> ast_reader::read_params()
+    {
+        std::vector<std::pair<std::vector<id_token>, id_token>> params;
+        for (auto n = read_uint(); n > 0; --n)
+        {
+            auto tp = read_ids();
+            params.emplace_back(std::move(tp), read_id());
+        }
+        return params;
+    }
+    std::vector<std::pair<id_token, std::unique_ptr<expression>>> ast_reader::read_inits()
+    {
+        std::vector<std::pair<id_token, std::unique_ptr<expression>>> inits;
+        for (auto n = read_uint(); n > 0; --n)
+        {
+            auto id = read_id();
+            inits.emplace_back(std::move(id), read_expression());
+        }
+        return inits;
+    }
+
+    static void write_inits(ast_writer &w, const std::vector<std::pair<id_token, std::unique_ptr<expression>>> &inits)
+    {
+        w.write_uint(inits.size());
+        for (const auto &[id, xpr] : inits)
+        {
+            w.write(id);
+            w.write(xpr.get());
+        }
+    }
+    static void write_params(ast_writer &w, const std::vector<std::pair<std::vector<id_token>, id_token>> &params)
+    {
+        w.write_uint(params.size());
+        for (const auto &[tp, id] : params)
+        {
+            w.write(tp);
+            w.write(id);
+        }
+    }
+
+    void bool_expression::write(ast_writer &w) const
+    {
+        w.tag(bool_xpr);
+        w.write(l);
+    }
+    void int_expression::write(ast_writer &w) const
+    {
+        w.tag(int_xpr);
+        w.write(l);
+    }
+    void bounded_int_expression::write(ast_writer &w) const
+    {
+        w.tag(bounded_int_xpr);
+        w.write(lb);
+        w.write(ub);
+    }
+    void uncertain_int_expression::write(ast_writer &w) const
+    {
+        w.tag(uncertain_int_xpr);
+        w.write(lb);
+        w.write(ub);
+    }
+    void real_expression::write(ast_writer &w) const
+    {
+        w.tag(real_xpr);
+        w.write(l);
+    }
+    void bounded_real_expression::write(ast_writer &w) const
+    {
+        w.tag(bounded_real_xpr);
+        w.write(lb);
+        w.write(ub);
+    }
+    void uncertain_real_expression::write(ast_writer &w) const
+    {
+        w.tag(uncertain_real_xpr);
+        w.write(lb);
+        w.write(ub);
+    }
+    void string_expression::write(ast_writer &w) const
+    {
+        w.tag(string_xpr);
+        w.write(l);
+    }
+    void id_expression::write(ast_writer &w) const
+    {
+        w.tag(id_xpr);
+        w.write(object_id);
+    }
+    void and_expression::write(ast_writer &w) const
+    {
+        w.tag(and_xpr);
+        w.write(xprs);
+    }
+    void or_expression::write(ast_writer &w) const
+    {
+        w.tag(or_xpr);
+        w.write(xprs);
+    }
+    void xor_expression::write(ast_writer &w) const
+    {
+        w.tag(xor_xpr);
+        w.write(xprs);
+    }
+    void not_expression::write(ast_writer &w) const
+    {
+        w.tag(not_xpr);
+        w.write(xpr.get());
+    }
+    void minus_expression::write(ast_writer &w) const
+    {
+        w.tag(minus_xpr);
+        w.write(xpr.get());
+    }
+    void sum_expression::write(ast_writer &w) const
+    {
+        w.tag(sum_xpr);
+        w.write(xprs);
+    }
+    void subtraction_expression::write(ast_writer &w) const
+    {
+        w.tag(subtraction_xpr);
+        w.write(xprs);
+    }
+    void product_expression::write(ast_writer &w) const
+    {
+        w.tag(product_xpr);
+        w.write(xprs);
+    }
+    void division_expression::write(ast_writer &w) const
+    {
+        w.tag(division_xpr);
+        w.write(xprs);
+    }
+    void lt_expression::write(ast_writer &w) const
+    {
+        w.tag(lt_xpr);
+        w.write(lhs.get());
+        w.write(rhs.get());
+    }
+    void le_expression::write(ast_writer &w) const
+    {
+        w.tag(le_xpr);
+        w.write(lhs.get());
+        w.write(rhs.get());
+    }
+    void gt_expression::write(ast_writer &w) const
+    {
+        w.tag(gt_xpr);
+        w.write(lhs.get());
+        w.write(rhs.get());
+    }
+    void ge_expression::write(ast_writer &w) const
+    {
+        w.tag(ge_xpr);
+        w.write(lhs.get());
+        w.write(rhs.get());
+    }
+    void eq_expression::write(ast_writer &w) const
+    {
+        w.tag(eq_xpr);
+        w.write(lhs.get());
+        w.write(rhs.get());
+    }
+    void constructor_expression::write(ast_writer &w) const
+    {
+        w.tag(constructor_xpr);
+        w.write(type_id);
+        w.write(arguments);
+    }
+    void call_expression::write(ast_writer &w) const
+    {
+        w.tag(call_xpr);
+        w.write(object_id);
+        w.write(function_id);
+        w.write(arguments);
+    }
+
+    void local_field_statement::write(ast_writer &w) const
+    {
+        w.tag(local_field_stmt);
+        w.write(field_type);
+        write_inits(w, fields);
+    }
+    void assignment_statement::write(ast_writer &w) const
+    {
+        w.tag(assignment_stmt);
+        w.write(object_id);
+        w.write(field_id);
+        w.write(value.get());
+    }
+    void expression_statement::write(ast_writer &w) const
+    {
+        w.tag(expression_stmt);
+        w.write(xpr.get());
+    }
+    void conjunction_statement::write(ast_writer &w) const
+    {
+        w.tag(conjunction_stmt);
+        w.write(stmts);
+        w.write(cst.get());
+    }
+    void disjunction_statement::write(ast_writer &w) const
+    {
+        w.tag(disjunction_stmt);
+        w.write(blocks);
+    }
+    void for_all_statement::write(ast_writer &w) const
+    {
+        w.tag(for_all_stmt);
+        w.write(enum_type);
+        w.write(enum_id);
+        w.write(stmts);
+    }
+    void return_statement::write(ast_writer &w) const
+    {
+        w.tag(return_stmt);
+        w.write(xpr.get());
+    }
+    void formula_statement::write(ast_writer &w) const
+    {
+        w.tag(formula_stmt);
+        w.write_bool(is_fact);
+        w.write(id);
+        w.write(tau);
+        w.write(predicate_name);
+        write_inits(w, args);
+    }
+
+    void enum_declaration::write(ast_writer &w) const
+    {
+        w.tag(enum_decl);
+        w.write(name);
+        w.write_uint(values.size());
+        for (const auto &val : values)
+            w.write(val);
+        w.write_uint(enum_refs.size());
+        for (const auto &ref : enum_refs)
+            w.write(ref);
+    }
+    void class_declaration::write(ast_writer &w) const
+    {
+        w.tag(class_decl);
+        w.write(name);
+        w.write_uint(base_classes.size());
+        for (const auto &base : base_classes)
+            w.write(base);
+        w.write(fields);
+        w.write(constructors);
+        w.write(methods);
+        w.write(predicates);
+        w.write(types);
+    }
+    void field_declaration::write(ast_writer &w) const
+    {
+        w.write(tp);
+        write_inits(w, fields);
+    }
+    void constructor_declaration::write(ast_writer &w) const
+    {
+        write_params(w, params);
+        w.write_uint(inits.size());
+        for (const auto &[id, xprs] : inits)
+        {
+            w.write(id);
+            w.write(xprs);
+        }
+        w.write(stmts);
+    }
+    void method_declaration::write(ast_writer &w) const
+    {
+        w.write(rt);
+        w.write(name);
+        write_params(w, params);
+        w.write(stmts);
+    }
+    void predicate_declaration::write(ast_writer &w) const
+    {
+        w.write(name);
+        write_params(w, params);
+        w.write_uint(base_predicates.size());
+        for (const auto &base : base_predicates)
+            w.write(base);
+        w.write(body);
+    }
+
+    void compilation_unit::write(ast_writer &w) const
+    {
+        w.write(types);
+        w.write(methods);
+        w.write(predicates);
+        w.write(body);
+    }
+
+    std::string serialize(const compilation_unit &cu, std::uint64_t hash)
+    {
+        ast_writer w;
+        cu.write(w);
+        return w.finish(hash);
+    }
+
+    std::unique_ptr<compilation_unit> deserialize(std::string_view data, std::uint64_t hash, symbol_table &symbols)
+    {
+        auto nodes = std::make_shared<arena>();
+        try
+        {
+            ast_reader r(data, hash, symbols, nodes.get()); // the nodes are allocated from the arena of the compilation unit..
+            std::vector<std::unique_ptr<type_declaration>> types;
+            for (auto n = r.read_uint(); n > 0; --n)
+                types.emplace_back(r.read_type_declaration());
+            std::vector<std::unique_ptr<method_declaration>> methods;
+            for (auto n = r.read_uint(); n > 0; --n)
+                methods.emplace_back(r.read_method_declaration());
+            std::vector<std::unique_ptr<predicate_declaration>> predicates;
+            for (auto n = r.read_uint(); n > 0; --n)
+                predicates.emplace_back(r.read_predicate_declaration());
+            auto statements = r.read_statements();
+            if (!r.done())
+                return nullptr;
+            return std::make_unique<compilation_unit>(std::move(types), std::move(methods), std::move(predicates), std::move(statements), std::move(nodes));
+        }
+        catch (const std::exception &)
+        { // the data is stale or corrupted..
+            return nullptr;
+        }
+    }
+} // namespace riddle
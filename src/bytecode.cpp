@@ -0,0 +1,501 @@
+#include "bytecode.hpp"
+#include "core.hpp"
+#include "conjunction.hpp"
+#include <cassert>
+
+namespace riddle
+{
+    std::uint32_t program_compiler::emit(opcode op, std::uint32_t a, std::uint32_t b, std::uint32_t c)
+    {
+        prog.code.push_back({op, a, b, c});
+        return static_cast<std::uint32_t>(prog.code.size() - 1);
+    }
+
+    std::uint32_t program_compiler::add_int(INT_TYPE val)
+    {
+        prog.ints.push_back(val);
+        return static_cast<std::uint32_t>(prog.ints.size() - 1);
+    }
+    std::uint32_t program_compiler::add_real(const utils::rational &val)
+    {
+        prog.reals.push_back(val);
+        return static_cast<std::uint32_t>(prog.reals.size() - 1);
+    }
+    std::uint32_t program_compiler::add_name(std::string_view name)
+    {
+        for (std::size_t i = 0; i < prog.names.size(); ++i)
+            if (prog.names[i] == name)
+                return static_cast<std::uint32_t>(i); // the name is already in the pool..
+        prog.names.push_back(name);
+        return static_cast<std::uint32_t>(prog.names.size() - 1);
+    }
+    std::uint32_t program_compiler::add_type(const std::vector<id_token> &tp_id, type *const &resolved)
+    {
+        prog.types.push_back({&tp_id, &resolved});
+        return static_cast<std::uint32_t>(prog.types.size() - 1);
+    }
+    std::uint32_t program_compiler::add_formula(bool is_fact, bool qualified, std::string_view predicate_name, std::vector<std::string_view> &&args, predicate *const &resolved)
+    {
+        prog.formulas.push_back({is_fact, qualified, predicate_name, std::move(args), &resolved});
+        return static_cast<std::uint32_t>(prog.formulas.size() - 1);
+    }
+    std::uint32_t program_compiler::add_statement(const statement &stmt)
+    {
+        prog.statements.push_back(&stmt);
+        return static_cast<std::uint32_t>(prog.statements.size() - 1);
+    }
+    std::uint32_t program_compiler::add_cache(overload_cache<constructor> &cache)
+    {
+        prog.constructor_caches.push_back(&cache);
+        return static_cast<std::uint32_t>(prog.constructor_caches.size() - 1);
+    }
+    std::uint32_t program_compiler::add_cache(overload_cache<method> &cache)
+    {
+        prog.method_caches.push_back(&cache);
+        return static_cast<std::uint32_t>(prog.method_caches.size() - 1);
+    }
+    std::uint32_t program_compiler::add_block(const std::vector<std::unique_ptr<statement>> &stmts)
+    {
+        prog.blocks.push_back(program::compile(stmts));
+        return static_cast<std::uint32_t>(prog.blocks.size() - 1);
+    }
+
+    void bool_expression::compile(program_compiler &c) const { c.emit(opcode::push_bool, l.value ? 1 : 0); }
+    void int_expression::compile(program_compiler &c) const { c.emit(opcode::push_int, c.add_int(l.value)); }
+    void bounded_int_expression::compile(program_compiler &c) const { c.emit(opcode::push_bounded_int, c.add_int(lb.value), c.add_int(ub.value)); }
+    void uncertain_int_expression::compile(program_compiler &c) const { c.emit(opcode::push_uncertain_int, c.add_int(lb.value), c.add_int(ub.value)); }
+    void real_expression::compile(program_compiler &c) const { c.emit(opcode::push_real, c.add_real(l.value)); }
+    void bounded_real_expression::compile(program_compiler &c) const { c.emit(opcode::push_bounded_real, c.add_real(lb.value), c.add_real(ub.value)); }
+    void uncertain_real_expression::compile(program_compiler &c) const { c.emit(opcode::push_uncertain_real, c.add_real(lb.value), c.add_real(ub.value)); }
+    void string_expression::compile(program_compiler &c) const { c.emit(opcode::push_string, c.add_name(l.value)); }
+
+    void id_expression::compile(program_compiler &c) const
+    {
+        assert(slot != unbound_slot);
+        c.emit(opcode::load, static_cast<std::uint32_t>(slot));
+        for (size_t i = 1; i < object_id.size(); ++i)
+            c.emit(opcode::get_item, c.add_name(object_id[i].id));
+    }
+
+    void and_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::bool_and, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void or_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::bool_or, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void xor_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::bool_xor, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void not_expression::compile(program_compiler &c) const
+    {
+        c.compile(*xpr);
+        c.emit(opcode::bool_not);
+    }
+    void minus_expression::compile(program_compiler &c) const
+    {
+        c.compile(*xpr);
+        c.emit(opcode::minus);
+    }
+    void sum_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::sum, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void subtraction_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::subtraction, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void product_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::product, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void division_expression::compile(program_compiler &c) const
+    {
+        for (const auto &xpr : xprs)
+            c.compile(*xpr);
+        c.emit(opcode::division, static_cast<std::uint32_t>(xprs.size()));
+    }
+    void lt_expression::compile(program_compiler &c) const
+    {
+        c.compile(*lhs);
+        c.compile(*rhs);
+        c.emit(opcode::lt);
+    }
+    void le_expression::compile(program_compiler &c) const
+    {
+        c.compile(*lhs);
+        c.compile(*rhs);
+        c.emit(opcode::le);
+    }
+    void gt_expression::compile(program_compiler &c) const
+    {
+        c.compile(*lhs);
+        c.compile(*rhs);
+        c.emit(opcode::gt);
+    }
+    void ge_expression::compile(program_compiler &c) const
+    {
+        c.compile(*lhs);
+        c.compile(*rhs);
+        c.emit(opcode::ge);
+    }
+    void eq_expression::compile(program_compiler &c) const
+    {
+        c.compile(*lhs);
+        c.compile(*rhs);
+        c.emit(opcode::eq);
+    }
+    void constructor_expression::compile(program_compiler &c) const
+    {
+        for (const auto &arg : arguments)
+            c.compile(*arg);
+        c.emit(opcode::instantiate, c.add_type(type_id, resolved_type), static_cast<std::uint32_t>(arguments.size()), c.add_cache(cache));
+    }
+    void call_expression::compile(program_compiler &c) const
+    {
+        if (!object_id.empty())
+        { // the object the method is invoked on..
+            assert(slot != unbound_slot);
+            c.emit(opcode::load, static_cast<std::uint32_t>(slot));
+            for (size_t i = 1; i < object_id.size(); ++i)
+                c.emit(opcode::get_item, c.add_name(object_id[i].id));
+        }
+        else
+            c.emit(opcode::push_null);
+        for (const auto &arg : arguments)
+            c.compile(*arg);
+        c.emit(opcode::invoke, c.add_name(function_id.id), static_cast<std::uint32_t>(arguments.size()), c.add_cache(cache));
+    }
+
+    void local_field_statement::compile(program_compiler &c) const
+    {
+        assert(slots.size() == fields.size());
+        const auto tp = c.add_type(field_type, resolved_type);
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (fields[i].second)
+                c.compile(*fields[i].second);
+            c.emit(opcode::declare, tp, static_cast<std::uint32_t>(slots[i]), fields[i].second ? 1 : 0);
+        }
+    }
+    void assignment_statement::compile(program_compiler &c) const { c.emit(opcode::execute, c.add_statement(*this)); }
+    void expression_statement::compile(program_compiler &c) const
+    {
+        c.compile(*xpr);
+        c.emit(opcode::assert_constraint);
+    }
+    void conjunction_statement::compile(program_compiler &c) const
+    {
+        for (const auto &stmt : stmts)
+            c.compile(*stmt);
+    }
+    void disjunction_statement::compile(program_compiler &c) const
+    {
+        assert(bound);
+        std::uint32_t first = 0;
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            if (blocks[i]->cst)
+                c.compile(*blocks[i]->cst);
+            else
+                c.emit(opcode::push_null);
+            const auto block = c.add_block(blocks[i]->stmts);
+            if (i == 0)
+                first = block;
+        }
+        c.emit(opcode::disjunction, first, static_cast<std::uint32_t>(blocks.size()));
+    }
+    void for_all_statement::compile(program_compiler &c) const
+    {
+        assert(slot != unbound_slot);
+        c.emit(opcode::for_all_begin, c.add_type(enum_type, resolved_type));
+        const auto next = c.emit(opcode::for_all_next, static_cast<std::uint32_t>(slot));
+        for (const auto &stmt : stmts)
+            c.compile(*stmt);
+        c.emit(opcode::jump, next);
+        c.patch(next);
+    }
+    void return_statement::compile(program_compiler &c) const
+    {
+        assert(slot != unbound_slot);
+        c.compile(*xpr);
+        c.emit(opcode::store_return, static_cast<std::uint32_t>(slot));
+    }
+    void formula_statement::compile(program_compiler &c) const
+    {
+        assert(slot != unbound_slot);
+        std::vector<std::string_view> c_args;
+        for (const auto &[id, xpr] : args)
+            if (xpr)
+            {
+                c.compile(*xpr);
+                c_args.emplace_back(id.id);
+            }
+        if (tau.empty())
+            c.emit(opcode::try_load, static_cast<std::uint32_t>(tau_slot));
+        else
+        {
+            c.emit(opcode::load, static_cast<std::uint32_t>(tau_slot));
+            for (size_t i = 1; i < tau.size(); ++i)
+                c.emit(opcode::get_item, c.add_name(tau[i].id));
+        }
+        c.emit(opcode::new_atom, c.add_formula(is_fact, !tau.empty(), predicate_name.id, std::move(c_args), resolved_predicate), static_cast<std::uint32_t>(slot));
+    }
+
+    program program::compile(const std::vector<std::unique_ptr<statement>> &stmts)
+    {
+        program_compiler c;
+        for (const auto &stmt : stmts)
+            c.compile(*stmt);
+        return c.finish();
+    }
+
+    void lazy_program::run(const scope &scp, frame &ctx) const
+    {
+        std::call_once(compiled, [this]
+                       { code = std::make_unique<program>(program::compile(stmts)); });
+        code->run(scp, ctx);
+    }
+
+    namespace
+    {
+        // moves the top `n` items of the stack into a vector of terms of the given kind..
+        template <typename T>
+        std::vector<std::shared_ptr<T>> pop_terms(std::vector<expr> &stack, std::size_t n)
+        {
+            std::vector<std::shared_ptr<T>> terms;
+            terms.reserve(n);
+            for (auto it = stack.end() - n; it != stack.end(); ++it)
+            {
+                assert(!*it || dynamic_cast<T *>(it->get()));
+                terms.emplace_back(std::static_pointer_cast<T>(std::move(*it)));
+            }
+            stack.resize(stack.size() - n);
+            return terms;
+        }
+
+        template <typename T>
+        std::shared_ptr<T> pop_term(std::vector<expr> &stack)
+        {
+            assert(!stack.back() || dynamic_cast<T *>(stack.back().get()));
+            auto term = std::static_pointer_cast<T>(std::move(stack.back()));
+            stack.pop_back();
+            return term;
+        }
+    } // namespace
+
+    void program::run(const scope &scp, frame &ctx) const
+    {
+        auto &cr = scp.get_core();
+        std::vector<expr> stack;
+        std::vector<std::pair<const component_type *, std::size_t>> iterations; // the iterated types and the next instance of each of them..
+        for (std::size_t pc = 0; pc < code.size(); ++pc)
+        {
+            const auto &ins = code[pc];
+            switch (ins.op)
+            {
+            case opcode::push_null:
+                stack.emplace_back();
+                break;
+            case opcode::push_bool:
+                stack.emplace_back(cr.new_bool(ins.a != 0));
+                break;
+            case opcode::push_int:
+                stack.emplace_back(cr.new_int(ints[ins.a]));
+                break;
+            case opcode::push_bounded_int:
+                stack.emplace_back(cr.new_int(ints[ins.a], ints[ins.b]));
+                break;
+            case opcode::push_uncertain_int:
+                stack.emplace_back(cr.new_uncertain_int(ints[ins.a], ints[ins.b]));
+                break;
+            case opcode::push_real:
+                stack.emplace_back(cr.new_real(utils::rational(reals[ins.a])));
+                break;
+            case opcode::push_bounded_real:
+                stack.emplace_back(cr.new_real(utils::rational(reals[ins.a]), utils::rational(reals[ins.b])));
+                break;
+            case opcode::push_uncertain_real:
+                stack.emplace_back(cr.new_uncertain_real(utils::rational(reals[ins.a]), utils::rational(reals[ins.b])));
+                break;
+            case opcode::push_string:
+                stack.emplace_back(cr.new_string(std::string(names[ins.a])));
+                break;
+            case opcode::load:
+                stack.emplace_back(ctx.load(ins.a));
+                break;
+            case opcode::try_load:
+                try
+                {
+                    stack.emplace_back(ctx.load(ins.a));
+                }
+                catch (const std::exception &)
+                { // the item is not found..
+                    stack.emplace_back();
+                }
+                break;
+            case opcode::get_item:
+                stack.back() = riddle::get_item(stack.back(), names[ins.a]);
+                break;
+            case opcode::bool_and:
+                stack.emplace_back(cr.new_and(pop_terms<bool_term>(stack, ins.a)));
+                break;
+            case opcode::bool_or:
+                stack.emplace_back(cr.new_or(pop_terms<bool_term>(stack, ins.a)));
+                break;
+            case opcode::bool_xor:
+                stack.emplace_back(cr.new_xor(pop_terms<bool_term>(stack, ins.a)));
+                break;
+            case opcode::bool_not:
+                stack.emplace_back(cr.new_not(pop_term<bool_term>(stack)));
+                break;
+            case opcode::minus:
+                stack.emplace_back(cr.new_negation(pop_term<arith_term>(stack)));
+                break;
+            case opcode::sum:
+                stack.emplace_back(cr.new_sum(pop_terms<arith_term>(stack, ins.a)));
+                break;
+            case opcode::subtraction:
+                stack.emplace_back(cr.new_subtraction(pop_terms<arith_term>(stack, ins.a)));
+                break;
+            case opcode::product:
+                stack.emplace_back(cr.new_product(pop_terms<arith_term>(stack, ins.a)));
+                break;
+            case opcode::division:
+                stack.emplace_back(cr.new_division(pop_terms<arith_term>(stack, ins.a)));
+                break;
+            case opcode::lt:
+            {
+                auto rhs = pop_term<arith_term>(stack);
+                auto lhs = pop_term<arith_term>(stack);
+                stack.emplace_back(cr.new_lt(std::move(lhs), std::move(rhs)));
+                break;
+            }
+            case opcode::le:
+            {
+                auto rhs = pop_term<arith_term>(stack);
+                auto lhs = pop_term<arith_term>(stack);
+                stack.emplace_back(cr.new_le(std::move(lhs), std::move(rhs)));
+                break;
+            }
+            case opcode::gt:
+            {
+                auto rhs = pop_term<arith_term>(stack);
+                auto lhs = pop_term<arith_term>(stack);
+                stack.emplace_back(cr.new_gt(std::move(lhs), std::move(rhs)));
+                break;
+            }
+            case opcode::ge:
+            {
+                auto rhs = pop_term<arith_term>(stack);
+                auto lhs = pop_term<arith_term>(stack);
+                stack.emplace_back(cr.new_ge(std::move(lhs), std::move(rhs)));
+                break;
+            }
+            case opcode::eq:
+            {
+                auto rhs = pop_term<term>(stack);
+                auto lhs = pop_term<term>(stack);
+                stack.emplace_back(cr.new_eq(std::move(lhs), std::move(rhs)));
+                break;
+            }
+            case opcode::instantiate:
+            {
+                auto &tp = resolve_type(scp, *types[ins.a].tp_id, *types[ins.a].resolved);
+                auto args = pop_terms<term>(stack, ins.b);
+                stack.emplace_back(constructor_expression::instantiate(tp, std::move(args), *constructor_caches[ins.c]));
+                break;
+            }
+            case opcode::invoke:
+            {
+                auto args = pop_terms<term>(stack, ins.b);
+                auto obj = pop_term<term>(stack);
+                stack.emplace_back(riddle::invoke(obj, names[ins.a], std::move(args), *method_caches[ins.c]));
+                break;
+            }
+            case opcode::declare:
+            {
+                auto &tp = resolve_type(scp, *types[ins.a].tp_id, *types[ins.a].resolved);
+                if (ins.c)
+                { // initialize with an item..
+                    auto val = pop_term<term>(stack);
+                    if (!tp.is_assignable_from(val->get_type()))
+                        throw std::runtime_error("Invalid assignment");
+                    ctx[ins.b] = std::move(val);
+                }
+                else
+                    ctx[ins.b] = local_field_statement::new_local(ctx, tp);
+                break;
+            }
+            case opcode::assert_constraint:
+                expression_statement::assert_constraint(scp, pop_term<term>(stack));
+                break;
+            case opcode::disjunction:
+            { // the frame is copied, so that each conjunction retains the current items..
+                auto csts = pop_terms<arith_term>(stack, ins.b);
+                std::vector<std::unique_ptr<conjunction>> conjs;
+                for (std::uint32_t i = 0; i < ins.b; ++i)
+                    conjs.emplace_back(std::make_unique<conjunction>(scp, frame(ctx), csts[i] ? cr.arith_value(*csts[i]).get_rational() : utils::rational::one, blocks[ins.a + i]));
+                cr.new_disjunction(std::move(conjs));
+                break;
+            }
+            case opcode::for_all_begin:
+                iterations.emplace_back(&static_cast<component_type &>(resolve_type(scp, *types[ins.a].tp_id, *types[ins.a].resolved)), 0); // the type has been checked to be a component type..
+                break;
+            case opcode::for_all_next:
+            {
+                auto &[ct, next] = iterations.back();
+                if (next < ct->get_instances().size())
+                    ctx[ins.a] = ct->get_instances()[next++];
+                else
+                { // the iteration is over..
+                    iterations.pop_back();
+                    pc = ins.b - 1;
+                }
+                break;
+            }
+            case opcode::jump:
+                pc = ins.a - 1;
+                break;
+            case opcode::store_return:
+            {
+                auto val = pop_term<term>(stack);
+                if (auto &ret = ctx[ins.a]; !ret) // the first returned value is retained..
+                    ret = std::move(val);
+                break;
+            }
+            case opcode::new_atom:
+            {
+                const auto &f = formulas[ins.a];
+                item_map args;
+                if (auto tau = pop_term<term>(stack))
+                    args.emplace(tau_kw, std::move(tau));
+                auto it = stack.end() - f.args.size();
+                for (const auto &arg : f.args)
+                    args.emplace(arg, std::move(*it++));
+                stack.resize(stack.size() - f.args.size());
+                ctx[ins.b] = formula_statement::new_atom(scp, ctx, f.is_fact, f.predicate_name, f.qualified, *f.resolved, std::move(args));
+                break;
+            }
+            case opcode::execute:
+                statements[ins.a]->execute(scp, ctx);
+                break;
+            }
+        }
+        assert(stack.empty() && iterations.empty());
+    }
+} // namespace riddle
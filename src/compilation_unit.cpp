@@ -1,4 +1,5 @@
 #include "compilation_unit.hpp"
+#include "type_context.hpp"
 #include <stdexcept>
 
 namespace riddle
@@ -30,6 +31,24 @@ namespace riddle
         for (const auto &t : types)
             t->refine_predicates(scp);
     }
+    void compilation_unit::check_statements(type_context &globals) const
+    {
+        // we check the statements..
+        for (const auto &stmt : body)
+            stmt->check(globals);
+    }
+    void compilation_unit::check(const scope &scp, const type_context &globals) const
+    {
+        // we check the types..
+        for (const auto &t : types)
+            t->check(scp, globals);
+        // we check the methods..
+        for (const auto &m : methods)
+            m->check(scp, globals);
+        // we check the predicates..
+        for (const auto &p : predicates)
+            p->check(scp, globals);
+    }
     void compilation_unit::execute(const scope &scp, env &ctx) const
     {
         // we execute the statements..
@@ -1,11 +1,20 @@
 #include "conjunction.hpp"
+#include "bytecode.hpp"
 
 namespace riddle
 {
-    conjunction::conjunction(const scope &scp, env &&ctx, const utils::rational cst, const std::vector<std::unique_ptr<statement>> &body) noexcept : scp(scp), ctx(std::move(ctx)), cst(cst), body(body) {}
+    static const std::vector<std::unique_ptr<statement>> no_body; // the body of the conjunctions compiled into bytecode..
+
+    conjunction::conjunction(const scope &scp, frame &&ctx, const utils::rational cst, const std::vector<std::unique_ptr<statement>> &body) noexcept : scp(scp), ctx(std::move(ctx)), cst(cst), body(body) {}
+    conjunction::conjunction(const scope &scp, frame &&ctx, const utils::rational cst, const program &code) noexcept : scp(scp), ctx(std::move(ctx)), cst(cst), body(no_body), code(&code) {}
 
     void conjunction::execute()
     {
+        if (code)
+        {
+            code->run(scp, ctx);
+            return;
+        }
         for (auto &stmt : body)
             stmt->execute(scp, ctx);
     }
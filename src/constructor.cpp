@@ -1,10 +1,11 @@
 #include "core.hpp"
+#include "bytecode.hpp"
 #include "exceptions.hpp"
 #include <algorithm>
 
 namespace riddle
 {
-    constructor::constructor(scope &scp, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &inits, const std::vector<std::unique_ptr<statement>> &body) noexcept : scope(scp.get_core(), scp), inits(inits), body(body)
+    constructor::constructor(scope &scp, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &inits, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept : scope(scp.get_core(), scp), inits(inits), body(body), layout(layout), code(code)
     {
         for (auto &arg : args)
         {
@@ -23,12 +24,13 @@ namespace riddle
 
         auto &tp = static_cast<component_type &>(get_parent());
         // the context in which the constructor is invoked..
-        env ctx(get_core(), *self);
-        ctx.items.emplace(this_kw, self); // the current instance
+        frame ctx(get_core(), *self, &layout);
+        ctx[0] = self; // the current instance
         for (size_t i = 0; i < args.size(); ++i)
-            ctx.items.emplace(this->args[i], args[i]); // the arguments
+            ctx[i + 1] = args[i]; // the arguments
 
         // we initialize the instance
+        self->items.reserve(self->items.size() + tp.fields.size());
         for (const auto &init : inits)
             if (auto f = tp.fields.find(init.first.id); f != tp.fields.end())
             {
@@ -108,7 +110,10 @@ namespace riddle
             }
 
         // we execute the body of the constructor
-        for (const auto &stmt : body)
-            stmt->execute(*this, ctx);
+        if (get_core().uses_bytecode())
+            code.run(*this, ctx);
+        else
+            for (const auto &stmt : body)
+                stmt->execute(*this, ctx);
     }
 } // namespace riddle
@@ -1,13 +1,27 @@
 #include "core.hpp"
 #include "flaw.hpp"
 #include "timeline.hpp"
-#include <sstream>
+#include "ast_cache.hpp"
+#include "mapped_file.hpp"
+#include "type_context.hpp"
 #include <fstream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
 #include <queue>
 #include <set>
 #include <algorithm>
+#include <random>
 #include <cassert>
 
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define RIDDLE_GETPID ::getpid
+#elif __has_include(<process.h>)
+#include <process.h>
+#define RIDDLE_GETPID ::_getpid
+#endif
+
 #ifdef COMPUTE_NAMES
 #include <unordered_map>
 
@@ -18,7 +32,7 @@
 
 namespace riddle
 {
-    core::core(std::string_view name) noexcept : scope(*this, *this), env(*this, *this), name(name)
+    core::core(std::string_view name) noexcept : scope(*this, *this), env(*this, *this), name(name), parse_threads(std::max(std::thread::hardware_concurrency(), 1u))
     {
         add_type(std::make_unique<bool_type>(*this));
         add_type(std::make_unique<int_type>(*this));
@@ -29,29 +43,307 @@ namespace riddle
 
     void core::read(std::string_view script)
     {
-        std::stringstream ss(script.data());
-        parser p(ss);
+        parser p(script, symbols);
         auto cu = p.parse_compilation_unit();
         cu->declare(*this);
         cu->refine(*this);
         cu->refine_predicates(*this);
+        type_context globals(*this);
+        cu->check_statements(globals);
+        cu->check(*this, globals);
         cu->execute(*this, *this);
         cus.push_back(std::move(cu)); // add the compilation unit to the list of compilation units
         RECOMPUTE_NAMES();
     }
 
-    void core::read(const std::vector<std::filesystem::path> &files)
+    void core::read(std::istream &is)
     {
-        std::vector<std::unique_ptr<compilation_unit>> c_cus;
-        c_cus.reserve(files.size());
-        for (const auto &file : files)
-            if (std::ifstream ifs(file); ifs.is_open())
+        class reader final : public compilation_unit_listener
+        {
+        public:
+            reader(core &cr, const parser &p) noexcept : cr(cr), p(p) {}
+
+            [[nodiscard]] bool element_arenas() const noexcept override { return true; }
+
+            void parsed(std::unique_ptr<type_declaration> &&td) override
+            {
+                types.emplace_back(std::move(td));
+                nodes.push_back(p.get_arena());
+            }
+            void parsed(std::unique_ptr<method_declaration> &&md) override
+            {
+                methods.emplace_back(std::move(md));
+                nodes.push_back(p.get_arena());
+            }
+            void parsed(std::unique_ptr<predicate_declaration> &&pd) override
+            {
+                predicates.emplace_back(std::move(pd));
+                nodes.push_back(p.get_arena());
+            }
+            void parsed(std::unique_ptr<statement> &&stmt) override
             {
-                parser p(ifs);
-                c_cus.push_back(p.parse_compilation_unit());
+                flush();
+                type_context globals(cr);
+                stmt->check(globals);
+                stmt->execute(cr, cr);
+                if (stmt->is_referred())
+                { // the terms created by the statement refer to it, hence we retain it together with its nodes..
+                    std::vector<std::unique_ptr<statement>> stmts;
+                    stmts.emplace_back(std::move(stmt));
+                    cr.cus.push_back(std::make_unique<compilation_unit>(std::vector<std::unique_ptr<type_declaration>>(), std::vector<std::unique_ptr<method_declaration>>(), std::vector<std::unique_ptr<predicate_declaration>>(), std::move(stmts), p.get_arena()));
+                } // otherwise the statement is dropped and its nodes are released as soon as the parser moves to the next element..
+            }
+
+            void flush()
+            { // we process the declarations read so far..
+                if (types.empty() && methods.empty() && predicates.empty())
+                    return;
+                auto cu = std::make_unique<compilation_unit>(std::move(types), std::move(methods), std::move(predicates), std::vector<std::unique_ptr<statement>>(), std::move(nodes));
+                cu->declare(cr);
+                cu->refine(cr);
+                cu->refine_predicates(cr);
+                cu->check(cr, type_context(cr));
+                cr.cus.push_back(std::move(cu));
+                types.clear();
+                methods.clear();
+                predicates.clear();
+                nodes.clear();
             }
-            else
-                throw std::runtime_error("file `" + file.string() + "` not found");
+
+        private:
+            core &cr;
+            const parser &p;
+            std::vector<std::unique_ptr<type_declaration>> types;           // the type declarations not yet processed..
+            std::vector<std::unique_ptr<method_declaration>> methods;       // the method declarations not yet processed..
+            std::vector<std::unique_ptr<predicate_declaration>> predicates; // the predicate declarations not yet processed..
+            std::vector<std::shared_ptr<arena>> nodes;                      // the arenas the declarations not yet processed are allocated from..
+        };
+
+        parser p(is, symbols);
+        reader r(*this, p);
+        p.parse_compilation_unit(r);
+        r.flush();
+        RECOMPUTE_NAMES();
+    }
+
+    /**
+     * @brief Returns a suffix for the name of a temporary file which is unique across the threads and the processes writing to the same directory.
+     */
+    static std::string temp_suffix()
+    {
+#ifdef RIDDLE_GETPID
+        const auto pid = static_cast<long long>(RIDDLE_GETPID());
+#else
+        const long long pid = 0;
+#endif
+        static std::atomic<std::uint64_t> counter = 0; // tells apart the files of the same process, should the random numbers collide..
+        thread_local std::mt19937_64 gen(std::random_device{}() ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        char suffix[64];
+        std::snprintf(suffix, sizeof(suffix), "%lld.%016llx.%llu", pid, static_cast<unsigned long long>(gen()), static_cast<unsigned long long>(counter++));
+        return suffix;
+    }
+
+    /**
+     * @brief Parses the given file into a compilation unit.
+     */
+    static std::unique_ptr<compilation_unit> parse_file(const std::filesystem::path &file, symbol_table &symbols, const std::optional<std::filesystem::path> &cache_dir, std::uint64_t &hash, std::optional<std::uint64_t> known_hash)
+    {
+        const mapped_file mf(file); // the file is lexed in place, straight from the mapped memory..
+        const auto src = mf.content();
+        hash = content_hash(src);
+        if (hash == known_hash) // the file has not changed since it was last read..
+            return nullptr;
+        if (!cache_dir)
+            return parser(src, symbols).parse_compilation_unit();
+
+        std::filesystem::path cache_file;
+        if (cache_dir->empty())
+            cache_file = std::filesystem::path(file) += ".ast";
+        else
+        {
+            char name[21];
+            std::snprintf(name, sizeof(name), "%016llx.ast", static_cast<unsigned long long>(hash));
+            cache_file = *cache_dir / name;
+        }
+
+        if (std::error_code ec; std::filesystem::is_regular_file(cache_file, ec))
+            try
+            { // we try to load the cached trees, falling back to parsing if they are stale or corrupted..
+                const mapped_file cf(cache_file);
+                if (auto cu = deserialize(cf.content(), hash, symbols))
+                    return cu;
+            }
+            catch (const std::exception &)
+            { // the cache file has been removed meanwhile, or cannot be read..
+            }
+
+        auto cu = parser(src, symbols).parse_compilation_unit();
+        // we write the trees to a temporary file which is then renamed, so that concurrent readers never see a partial cache. failing to write the cache is not an error..
+        std::error_code ec;
+        if (!cache_dir->empty())
+            std::filesystem::create_directories(*cache_dir, ec);
+        auto tmp_file = cache_file;
+        tmp_file += "." + temp_suffix() + ".tmp";
+        if (std::ofstream ofs(tmp_file, std::ios::binary | std::ios::trunc); ofs.is_open())
+        {
+            const auto data = serialize(*cu, hash);
+            ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+            ofs.close();
+            if (ofs)
+                std::filesystem::rename(tmp_file, cache_file, ec);
+            if (!ofs || ec)
+                std::filesystem::remove(tmp_file, ec);
+        }
+        return cu;
+    }
+
+    /**
+     * @brief Returns the key identifying the given file among the files read by a core.
+     */
+    static std::filesystem::path file_key(const std::filesystem::path &file)
+    {
+        std::error_code ec;
+        auto key = std::filesystem::weakly_canonical(file, ec);
+        return ec ? file.lexically_normal() : key;
+    }
+
+    std::vector<std::unique_ptr<compilation_unit>> core::parse_files(const std::vector<std::filesystem::path> &files, std::vector<std::uint64_t> &hashes, bool incremental)
+    {
+        std::vector<std::unique_ptr<compilation_unit>> c_cus(files.size());
+        std::vector<std::optional<std::uint64_t>> known_hashes(files.size());
+        if (incremental)
+            for (size_t i = 0; i < files.size(); ++i)
+                if (const auto it = loaded_files.find(file_key(files[i])); it != loaded_files.cend())
+                    known_hashes[i] = it->second.hash;
+        hashes.assign(files.size(), 0);
+        std::vector<std::exception_ptr> errors(files.size());
+        std::atomic<size_t> next_file = 0;
+        const auto parse = [&]()
+        { // we parse the files which have not been taken by other threads yet..
+            for (size_t i = next_file++; i < files.size(); i = next_file++)
+                try
+                {
+                    c_cus[i] = parse_file(files[i], symbols, ast_cache_dir, hashes[i], known_hashes[i]);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+        };
+
+        if (const auto n_threads = std::min(files.size(), parse_threads); n_threads > 1)
+        { // files are parsed concurrently, so the symbol table must be protected..
+            symbols.set_concurrent(true);
+            std::vector<std::thread> workers;
+            workers.reserve(n_threads - 1);
+            try
+            {
+                while (workers.size() < n_threads - 1)
+                    workers.emplace_back(parse);
+            }
+            catch (const std::system_error &)
+            { // we could not create more threads, so we go on with the ones we have..
+            }
+            parse(); // the calling thread parses files as well..
+            for (auto &worker : workers)
+                worker.join();
+            symbols.set_concurrent(false);
+        }
+        else
+            parse();
+
+        for (const auto &error : errors) // we report the error of the first failing file, as a sequential read would..
+            if (error)
+                std::rethrow_exception(error);
+        return c_cus;
+    }
+
+    void core::execute(loaded_file &file, const compilation_unit &cu)
+    {
+        file.retractable = true;
+        file.cu = &cu;
+        file.items.clear();
+        file.terms.clear();
+        if (!cu.has_statements())
+            return;
+        c_file = &file; // the items, the instances, the atoms and the asserted terms are recorded into the file..
+        try
+        {
+            cu.execute(*this, *this);
+        }
+        catch (...)
+        {
+            c_file = nullptr;
+            throw;
+        }
+        c_file = nullptr;
+    }
+
+    void core::retract(const std::vector<expr> &) { throw std::runtime_error("the backend does not support reloading files"); }
+
+    void core::retract_file(loaded_file &file)
+    {
+        // the terms asserted by other statements as well are still asserted, hash-consing having posted them once..
+        std::map<assertion, std::size_t, assertion_less> assertions;
+        for (const auto &[res, xpr] : file.assertions)
+            ++assertions[assertion{res, xpr}];
+        std::vector<expr> c_terms = file.terms;
+        for (const auto &[key, count] : assertions)
+            if (const auto it = asserted.find(key); it == asserted.end() || it->second <= count)
+                c_terms.push_back(key.second.lock()); // the file keeps the terms it asserted alive..
+
+        retract(c_terms); // the backend retracts the terms first, so that the core is left untouched should it fail..
+
+        for (const auto &id : file.items)
+        { // the items defined by the file, and their global fields, are removed..
+            items.erase(id);
+            fields.erase(id);
+        }
+
+        std::unordered_set<const term *> terms;
+        terms.reserve(file.terms.size());
+        for (const auto &xpr : file.terms)
+            terms.insert(xpr.get());
+        const auto retracted = [&terms](const auto &xpr)
+        { return terms.count(xpr.get()) > 0; };
+        const auto remove_atoms = [&retracted](predicate &p)
+        { p.atoms.erase(std::remove_if(p.atoms.begin(), p.atoms.end(), retracted), p.atoms.end()); };
+
+        // we remove the instances and the atoms of the file from the types and the predicates they have been stored in..
+        std::queue<component_type *> q;
+        for (const auto &[name, tp] : types)
+            if (auto ct = dynamic_cast<component_type *>(tp.get()))
+                q.push(ct);
+        for (const auto &[name, p] : predicates)
+            remove_atoms(*p);
+        while (!q.empty())
+        {
+            auto ct = q.front();
+            q.pop();
+            ct->instances.erase(std::remove_if(ct->instances.begin(), ct->instances.end(), retracted), ct->instances.end());
+            ct->atoms.erase(std::remove_if(ct->atoms.begin(), ct->atoms.end(), retracted), ct->atoms.end());
+            for (const auto &[name, p] : ct->predicates)
+                remove_atoms(*p);
+            for (const auto &[name, tp] : ct->types)
+                if (auto nested = dynamic_cast<component_type *>(tp.get()))
+                    q.push(nested);
+        }
+        for (const auto &[key, count] : assertions) // the terms no longer asserted by any statement can be asserted again..
+            if (const auto it = asserted.find(key); it != asserted.end())
+            {
+                it->second -= std::min(it->second, count);
+                if (!it->second)
+                    asserted.erase(it);
+            }
+
+        file.terms.clear();
+        file.assertions.clear();
+    }
+
+    void core::read(const std::vector<std::filesystem::path> &files)
+    {
+        std::vector<std::uint64_t> hashes;
+        auto c_cus = parse_files(files, hashes, false);
 
         for (auto &cu : c_cus)
             cu->declare(*this);
@@ -59,133 +351,338 @@ namespace riddle
             cu->refine(*this);
         for (auto &cu : c_cus)
             cu->refine_predicates(*this);
+        type_context globals(*this); // the statements are checked first, since the bodies might refer to the global items they declare..
+        for (auto &cu : c_cus)
+            cu->check_statements(globals);
         for (auto &cu : c_cus)
-            cu->execute(*this, *this);
+            cu->check(*this, globals);
+        for (size_t i = 0; i < c_cus.size(); ++i)
+        { // the problems of the files are not recorded, since they are not meant to be retracted..
+            auto &file = loaded_files[file_key(files[i])];
+            file.hash = hashes[i];
+            file.domain = c_cus[i]->has_declarations();
+            file.retractable = false;
+            file.cu = c_cus[i].get();
+            c_cus[i]->execute(*this, *this);
+        }
 
         cus.insert(cus.end(), std::make_move_iterator(c_cus.begin()), std::make_move_iterator(c_cus.end())); // add the compilation units to the list of compilation units
         RECOMPUTE_NAMES();
     }
 
+    void core::reload(const std::vector<std::filesystem::path> &files)
+    {
+        std::vector<std::uint64_t> hashes;
+        auto c_cus = parse_files(files, hashes, true);
+
+        // the declarations of the files which have already been read cannot be replaced, nor can the problems which have not been recorded, so we check them before changing anything..
+        for (size_t i = 0; i < files.size(); ++i)
+            if (c_cus[i])
+                if (const auto it = loaded_files.find(file_key(files[i])); it != loaded_files.cend())
+                {
+                    if (it->second.domain || c_cus[i]->has_declarations())
+                        throw std::runtime_error("file `" + files[i].string() + "` changed its declarations and cannot be reloaded");
+                    if (!it->second.retractable)
+                        throw std::runtime_error("file `" + files[i].string() + "` has not been read through `reload` and cannot be reloaded");
+                }
+
+        for (auto &cu : c_cus)
+            if (cu)
+                cu->declare(*this);
+        for (auto &cu : c_cus)
+            if (cu)
+                cu->refine(*this);
+        for (auto &cu : c_cus)
+            if (cu)
+                cu->refine_predicates(*this);
+        type_context globals(*this); // the statements are checked first, since the bodies might refer to the global items they declare..
+        for (auto &cu : c_cus)
+            if (cu)
+                cu->check_statements(globals);
+        for (auto &cu : c_cus)
+            if (cu)
+                cu->check(*this, globals);
+        for (size_t i = 0; i < c_cus.size(); ++i)
+            if (c_cus[i])
+            {
+                auto [it, added] = loaded_files.try_emplace(file_key(files[i]));
+                auto &file = it->second;
+                if (!added)
+                { // the previous version of the file is retracted and its compilation unit replaced..
+                    retract_file(file);
+                    const auto prev = std::find_if(cus.begin(), cus.end(), [&file](const auto &cu)
+                                                   { return cu.get() == file.cu; });
+                    assert(prev != cus.end());
+                    *prev = std::move(c_cus[i]);
+                    file.hash = hashes[i];
+                    execute(file, **prev);
+                }
+                else
+                {
+                    file.hash = hashes[i];
+                    file.domain = c_cus[i]->has_declarations();
+                    execute(file, *c_cus[i]);
+                    cus.push_back(std::move(c_cus[i]));
+                }
+            }
+
+        RECOMPUTE_NAMES();
+    }
+
+    std::size_t core::cons_key_hash::operator()(const cons_key &key) const noexcept
+    {
+        auto h = static_cast<std::size_t>(key.kind);
+        for (const auto arg : key.args)
+            h ^= std::hash<const term *>{}(arg) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    template <typename Make>
+    bool_expr core::cons(cons_kind kind, std::vector<const term *> &&args, Make &&make)
+    {
+        if (!hash_consing)
+            return make();
+        // the operands of a live term are kept alive by it, so their identities cannot be reused..
+        auto &c_term = consed[cons_key{kind, std::move(args)}];
+        if (auto xpr = c_term.lock())
+            return xpr;
+        bool_expr xpr = make();
+        c_term = xpr;
+        if (consed.size() > consed_purge)
+        { // we purge the dead terms..
+            for (auto it = consed.begin(); it != consed.end();)
+                if (it->second.expired())
+                    it = consed.erase(it);
+                else
+                    ++it;
+            consed_purge = std::max<std::size_t>(1024, 2 * consed.size());
+        }
+        return xpr;
+    }
+
+    /**
+     * @brief Returns the identities of the given terms.
+     */
+    template <typename Expr>
+    static std::vector<const term *> identities(const std::vector<Expr> &exprs)
+    {
+        std::vector<const term *> ids;
+        ids.reserve(exprs.size());
+        for (const auto &xpr : exprs)
+            ids.push_back(xpr.get());
+        return ids;
+    }
+
     bool_expr core::new_and(std::vector<bool_expr> &&exprs)
     {
         assert(!exprs.empty());
-        return std::make_shared<and_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs));
+        return cons(cons_kind::and_kind, identities(exprs), [this, &exprs]
+                    { return new_term<and_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs)); });
     }
 
     bool_expr core::new_or(std::vector<bool_expr> &&exprs)
     {
         assert(!exprs.empty());
-        return std::make_shared<or_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs));
+        return cons(cons_kind::or_kind, identities(exprs), [this, &exprs]
+                    { return new_term<or_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs)); });
     }
 
     bool_expr core::new_xor(std::vector<bool_expr> &&exprs)
     {
         assert(!exprs.empty());
-        return std::make_shared<xor_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs));
+        return cons(cons_kind::xor_kind, identities(exprs), [this, &exprs]
+                    { return new_term<xor_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(exprs)); });
     }
 
-    bool_expr core::new_not(bool_expr expr) { return std::make_shared<bool_not>(static_cast<bool_type &>(get_type(bool_kw)), std::move(expr)); }
+    bool_expr core::new_not(bool_expr expr)
+    {
+        return cons(cons_kind::not_kind, {expr.get()}, [this, &expr]
+                    { return new_term<bool_not>(static_cast<bool_type &>(get_type(bool_kw)), std::move(expr)); });
+    }
 
-    bool_expr core::new_lt(arith_expr lhs, arith_expr rhs) { return std::make_shared<lt_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); }
-    bool_expr core::new_le(arith_expr lhs, arith_expr rhs) { return std::make_shared<le_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); }
-    bool_expr core::new_eq(expr lhs, expr rhs) { return std::make_shared<eq_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); }
-    bool_expr core::new_gt(arith_expr lhs, arith_expr rhs) { return std::make_shared<gt_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); }
-    bool_expr core::new_ge(arith_expr lhs, arith_expr rhs) { return std::make_shared<ge_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); }
+    bool_expr core::new_lt(arith_expr lhs, arith_expr rhs)
+    {
+        return cons(cons_kind::lt_kind, {lhs.get(), rhs.get()}, [this, &lhs, &rhs]
+                    { return new_term<lt_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); });
+    }
+    bool_expr core::new_le(arith_expr lhs, arith_expr rhs)
+    {
+        return cons(cons_kind::le_kind, {lhs.get(), rhs.get()}, [this, &lhs, &rhs]
+                    { return new_term<le_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); });
+    }
+    bool_expr core::new_eq(expr lhs, expr rhs)
+    {
+        return cons(cons_kind::eq_kind, {lhs.get(), rhs.get()}, [this, &lhs, &rhs]
+                    { return new_term<eq_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); });
+    }
+    bool_expr core::new_gt(arith_expr lhs, arith_expr rhs)
+    {
+        return cons(cons_kind::gt_kind, {lhs.get(), rhs.get()}, [this, &lhs, &rhs]
+                    { return new_term<gt_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); });
+    }
+    bool_expr core::new_ge(arith_expr lhs, arith_expr rhs)
+    {
+        return cons(cons_kind::ge_kind, {lhs.get(), rhs.get()}, [this, &lhs, &rhs]
+                    { return new_term<ge_term>(static_cast<bool_type &>(get_type(bool_kw)), std::move(lhs), std::move(rhs)); });
+    }
 
     bool core::assert_expr(bool_expr xpr) noexcept
     {
-        if (auto n_xpr = std::dynamic_pointer_cast<bool_not>(xpr))
+        if (c_file) // the term is retracted together with the file asserting it..
+            c_file->assertions.emplace_back(c_res, xpr);
+        if (!hash_consing)
+            return post_expr(std::move(xpr));
+        if (!add_assertion(xpr))
+            return true;
+        if (post_expr(xpr))
+            return true;
+        asserted.erase(assertion{c_res, xpr});
+        return false;
+    }
+
+    bool core::add_assertion(const bool_expr &xpr)
+    { // the constraints are posted within the current resolver, hence the same term might be asserted again within a different one..
+        if (const auto it = asserted.find(assertion{c_res, xpr}); it != asserted.end())
+        { // the term is posted once, however many times it is asserted..
+            ++it->second;
+            return false;
+        }
+        if (asserted.size() > asserted_purge)
+        { // we purge the assertions of the dead terms..
+            for (auto it = asserted.begin(); it != asserted.end();)
+                if (it->first.second.expired())
+                    it = asserted.erase(it);
+                else
+                    ++it;
+            asserted_purge = std::max<std::size_t>(1024, 2 * asserted.size());
+        }
+        asserted.emplace(assertion{c_res, xpr}, 1);
+        return true;
+    }
+
+    bool core::post_expr(bool_expr xpr) noexcept
+    {
+        switch (xpr->get_kind())
+        {
+        case term_kind::not_kind:
         { // we are dealing with a negation..
-            if (auto lt_xpr = std::dynamic_pointer_cast<lt_term>(n_xpr->get_arg()))
-                return mk_le(lt_xpr->get_rhs(), lt_xpr->get_lhs());
-            else if (auto le_xpr = std::dynamic_pointer_cast<le_term>(n_xpr->get_arg()))
-                return mk_lt(le_xpr->get_rhs(), le_xpr->get_lhs());
-            else if (auto eq_xpr = std::dynamic_pointer_cast<eq_term>(n_xpr->get_arg()))
+            const auto &arg = static_cast<const bool_not &>(*xpr).get_arg();
+            switch (arg->get_kind())
+            {
+            case term_kind::lt_kind:
+            {
+                const auto &lt_xpr = static_cast<const lt_term &>(*arg);
+                return mk_le(lt_xpr.get_rhs(), lt_xpr.get_lhs());
+            }
+            case term_kind::le_kind:
             {
-                if (eq_xpr->get_lhs() == eq_xpr->get_rhs()) // the terms are the same, so they are equal..
+                const auto &le_xpr = static_cast<const le_term &>(*arg);
+                return mk_lt(le_xpr.get_rhs(), le_xpr.get_lhs());
+            }
+            case term_kind::eq_kind:
+            {
+                const auto &lhs = static_cast<const eq_term &>(*arg).get_lhs();
+                const auto &rhs = static_cast<const eq_term &>(*arg).get_rhs();
+                if (lhs == rhs) // the terms are the same, so they are equal..
                     return false;
-                else if (&eq_xpr->get_lhs()->get_type() != &eq_xpr->get_lhs()->get_type()) // the types are different, so the constraint is always false..
+                else if (&lhs->get_type() != &lhs->get_type()) // the types are different, so the constraint is always false..
                     return true;
-                else if (auto lhs_xpr = std::dynamic_pointer_cast<arith_term>(eq_xpr->get_lhs())) // we are dealing with an arithmetic constraint..
-                    return mk_neq(lhs_xpr, std::static_pointer_cast<arith_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_sxpr = std::dynamic_pointer_cast<string_term>(eq_xpr->get_lhs())) // we are dealing with a string constraint..
-                    return mk_neq(lhs_sxpr, std::static_pointer_cast<string_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_bxpr = std::dynamic_pointer_cast<bool_term>(eq_xpr->get_lhs())) // we are dealing with a boolean constraint..
-                    return mk_neq(lhs_bxpr, std::static_pointer_cast<bool_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_lhs())) // we are dealing with an enum constraint..
+                switch (lhs->get_kind())
                 {
-                    if (auto rhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_rhs())) // both sides are enum items..
-                        return mk_neq(lhs_enum_xpr, rhs_enum_xpr);
+                case term_kind::arith_kind: // we are dealing with an arithmetic constraint..
+                    return mk_neq(std::static_pointer_cast<arith_term>(lhs), std::static_pointer_cast<arith_term>(rhs));
+                case term_kind::string_kind: // we are dealing with a string constraint..
+                    return mk_neq(std::static_pointer_cast<string_term>(lhs), std::static_pointer_cast<string_term>(rhs));
+                case term_kind::enum_kind: // we are dealing with an enum constraint..
+                    if (rhs->get_kind() == term_kind::enum_kind) // both sides are enum items..
+                        return mk_neq(std::static_pointer_cast<enum_term>(lhs), std::static_pointer_cast<enum_term>(rhs));
                     else // right side is an enum value..
-                        return mk_forbid(lhs_enum_xpr, static_cast<utils::enum_val &>(*(eq_xpr->get_rhs())));
-                }
-                else if (auto rhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_rhs())) // left side is an enum value..
-                    return mk_forbid(rhs_enum_xpr, static_cast<utils::enum_val &>(*(eq_xpr->get_lhs())));
-                else if (auto lhs_atm = std::dynamic_pointer_cast<atom_term>(eq_xpr->get_lhs()))
-                {
-                    auto rhs_atm = std::static_pointer_cast<atom_term>(eq_xpr->get_rhs());
-                    std::vector<bool_expr> clause_exprs;
-                    std::queue<predicate *> q;
-                    q.push(static_cast<predicate *>(&lhs_xpr->get_type()));
-                    while (!q.empty())
+                        return mk_forbid(std::static_pointer_cast<enum_term>(lhs), static_cast<utils::enum_val &>(*rhs));
+                default:
+                    if (is_bool_kind(lhs->get_kind())) // we are dealing with a boolean constraint..
+                        return mk_neq(std::static_pointer_cast<bool_term>(lhs), std::static_pointer_cast<bool_term>(rhs));
+                    else if (rhs->get_kind() == term_kind::enum_kind) // left side is an enum value..
+                        return mk_forbid(std::static_pointer_cast<enum_term>(rhs), static_cast<utils::enum_val &>(*lhs));
+                    else if (lhs->get_kind() == term_kind::atom_kind)
                     {
-                        for (const auto &[f_name, f] : q.front()->get_fields())
-                            clause_exprs.push_back(new_not(new_eq(lhs_atm->get(f_name), rhs_atm->get(f_name))));
-                        for (const auto &pp : q.front()->get_parents())
-                            q.push(&pp.get());
-                        q.pop();
+                        auto &lhs_atm = static_cast<atom_term &>(*lhs);
+                        auto &rhs_atm = static_cast<atom_term &>(*rhs);
+                        std::vector<bool_expr> clause_exprs;
+                        std::queue<predicate *> q;
+                        q.push(static_cast<predicate *>(&lhs_atm.get_type()));
+                        while (!q.empty())
+                        {
+                            for (const auto &[f_name, f] : q.front()->get_fields())
+                                clause_exprs.push_back(new_not(new_eq(lhs_atm.get(f_name), rhs_atm.get(f_name))));
+                            for (const auto &pp : q.front()->get_parents())
+                                q.push(&pp.get());
+                            q.pop();
+                        }
+                        new_clause(std::move(clause_exprs));
+                        return true;
                     }
-                    new_clause(std::move(clause_exprs));
-                    return true;
+                    else
+                        return true;
                 }
-                else
-                    return true;
             }
-            else if (auto ge_xpr = std::dynamic_pointer_cast<ge_term>(n_xpr->get_arg()))
-                return mk_gt(ge_xpr->get_lhs(), ge_xpr->get_rhs());
-            else if (auto gt_xpr = std::dynamic_pointer_cast<gt_term>(n_xpr->get_arg()))
-                return mk_ge(gt_xpr->get_lhs(), gt_xpr->get_rhs());
-            else if (auto b_xpr = std::dynamic_pointer_cast<bool_term>(n_xpr->get_arg()))
-                return mk_assign(b_xpr, utils::False);
-            else
-                return false; // unsupported expression, just return false..
+            case term_kind::ge_kind:
+            {
+                const auto &ge_xpr = static_cast<const ge_term &>(*arg);
+                return mk_gt(ge_xpr.get_lhs(), ge_xpr.get_rhs());
+            }
+            case term_kind::gt_kind:
+            {
+                const auto &gt_xpr = static_cast<const gt_term &>(*arg);
+                return mk_ge(gt_xpr.get_lhs(), gt_xpr.get_rhs());
+            }
+            default:
+                return mk_assign(arg, utils::False);
+            }
         }
-        else
+        case term_kind::lt_kind:
         {
-            if (auto lt_xpr = std::dynamic_pointer_cast<lt_term>(xpr))
-                return mk_lt(lt_xpr->get_lhs(), lt_xpr->get_rhs());
-            else if (auto le_xpr = std::dynamic_pointer_cast<le_term>(xpr))
-                return mk_le(le_xpr->get_lhs(), le_xpr->get_rhs());
-            else if (auto eq_xpr = std::dynamic_pointer_cast<eq_term>(xpr))
+            const auto &lt_xpr = static_cast<const lt_term &>(*xpr);
+            return mk_lt(lt_xpr.get_lhs(), lt_xpr.get_rhs());
+        }
+        case term_kind::le_kind:
+        {
+            const auto &le_xpr = static_cast<const le_term &>(*xpr);
+            return mk_le(le_xpr.get_lhs(), le_xpr.get_rhs());
+        }
+        case term_kind::eq_kind:
+        {
+            const auto &lhs = static_cast<const eq_term &>(*xpr).get_lhs();
+            const auto &rhs = static_cast<const eq_term &>(*xpr).get_rhs();
+            if (lhs == rhs) // the terms are the same, so they are equal..
+                return true;
+            else if (&lhs->get_type() != &lhs->get_type()) // the types are different, so the constraint is always false..
+                return false;
+            switch (lhs->get_kind())
             {
-                if (eq_xpr->get_lhs() == eq_xpr->get_rhs()) // the terms are the same, so they are equal..
-                    return true;
-                else if (&eq_xpr->get_lhs()->get_type() != &eq_xpr->get_lhs()->get_type()) // the types are different, so the constraint is always false..
-                    return false;
-                else if (auto lhs_xpr = std::dynamic_pointer_cast<arith_term>(eq_xpr->get_lhs())) // we are dealing with an arithmetic constraint..
-                    return mk_eq(lhs_xpr, std::static_pointer_cast<arith_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_sxpr = std::dynamic_pointer_cast<string_term>(eq_xpr->get_lhs())) // we are dealing with a string constraint..
-                    return mk_eq(lhs_sxpr, std::static_pointer_cast<string_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_bxpr = std::dynamic_pointer_cast<bool_term>(eq_xpr->get_lhs())) // we are dealing with a boolean constraint..
-                    return mk_eq(lhs_bxpr, std::static_pointer_cast<bool_term>(eq_xpr->get_rhs()));
-                else if (auto lhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_lhs())) // we are dealing with an enum constraint..
+            case term_kind::arith_kind: // we are dealing with an arithmetic constraint..
+                return mk_eq(std::static_pointer_cast<arith_term>(lhs), std::static_pointer_cast<arith_term>(rhs));
+            case term_kind::string_kind: // we are dealing with a string constraint..
+                return mk_eq(std::static_pointer_cast<string_term>(lhs), std::static_pointer_cast<string_term>(rhs));
+            case term_kind::enum_kind: // we are dealing with an enum constraint..
+                if (rhs->get_kind() == term_kind::enum_kind) // both sides are enum items..
+                    return mk_eq(std::static_pointer_cast<enum_term>(lhs), std::static_pointer_cast<enum_term>(rhs));
+                else // right side is an enum value..
+                    return mk_assign(std::static_pointer_cast<enum_term>(lhs), static_cast<utils::enum_val &>(*rhs));
+            default:
+                if (is_bool_kind(lhs->get_kind())) // we are dealing with a boolean constraint..
+                    return mk_eq(std::static_pointer_cast<bool_term>(lhs), std::static_pointer_cast<bool_term>(rhs));
+                else if (rhs->get_kind() == term_kind::enum_kind) // left side is an enum value..
+                    return mk_assign(std::static_pointer_cast<enum_term>(rhs), static_cast<utils::enum_val &>(*lhs));
+                else if (lhs->get_kind() == term_kind::atom_kind)
                 {
-                    if (auto rhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_rhs())) // both sides are enum items..
-                        return mk_eq(lhs_enum_xpr, rhs_enum_xpr);
-                    else // right side is an enum value..
-                        return mk_assign(lhs_enum_xpr, static_cast<utils::enum_val &>(*(eq_xpr->get_rhs())));
-                }
-                else if (auto rhs_enum_xpr = std::dynamic_pointer_cast<enum_term>(eq_xpr->get_rhs())) // left side is an enum value..
-                    return mk_assign(rhs_enum_xpr, static_cast<utils::enum_val &>(*(eq_xpr->get_lhs())));
-                else if (auto lhs_atm = std::dynamic_pointer_cast<atom_term>(eq_xpr->get_lhs()))
-                {
-                    auto rhs_atm = std::static_pointer_cast<atom_term>(eq_xpr->get_rhs());
+                    auto &lhs_atm = static_cast<atom_term &>(*lhs);
+                    auto &rhs_atm = static_cast<atom_term &>(*rhs);
                     std::queue<predicate *> q;
-                    q.push(static_cast<predicate *>(&lhs_atm->get_type()));
+                    q.push(static_cast<predicate *>(&lhs_atm.get_type()));
                     while (!q.empty())
                     {
                         for (const auto &[f_name, f] : q.front()->get_fields())
-                            if (!assert_expr(new_eq(lhs_atm->get(f_name), rhs_atm->get(f_name))))
+                            if (!assert_expr(new_eq(lhs_atm.get(f_name), rhs_atm.get(f_name))))
                                 return false;
                         for (const auto &pp : q.front()->get_parents())
                             q.push(&pp.get());
@@ -196,20 +693,27 @@ namespace riddle
                 else
                     return false;
             }
-            else if (auto ge_xpr = std::dynamic_pointer_cast<ge_term>(xpr))
-                return mk_ge(ge_xpr->get_lhs(), ge_xpr->get_rhs());
-            else if (auto gt_xpr = std::dynamic_pointer_cast<gt_term>(xpr))
-                return mk_gt(gt_xpr->get_lhs(), gt_xpr->get_rhs());
-            else if (auto b_xpr = std::dynamic_pointer_cast<bool_term>(xpr))
-                return mk_assign(b_xpr, utils::True);
-            else
-                return false; // unsupported expression, just return false..
+        }
+        case term_kind::ge_kind:
+        {
+            const auto &ge_xpr = static_cast<const ge_term &>(*xpr);
+            return mk_ge(ge_xpr.get_lhs(), ge_xpr.get_rhs());
+        }
+        case term_kind::gt_kind:
+        {
+            const auto &gt_xpr = static_cast<const gt_term &>(*xpr);
+            return mk_gt(gt_xpr.get_lhs(), gt_xpr.get_rhs());
+        }
+        default:
+            return mk_assign(xpr, utils::True);
         }
     }
 
-    atom_expr core::new_atom(bool is_fact, predicate &pred, std::map<std::string, expr, std::less<>> &&args)
+    atom_expr core::new_atom(bool is_fact, predicate &pred, item_map &&args)
     {
         auto atm = create_atom(is_fact, pred, std::move(args));
+        if (c_file) // the atom is retracted together with the file creating it..
+            c_file->terms.push_back(atm);
 
         // we add the atom to the predicate and to its parents..
         std::queue<predicate *> q;
@@ -1,6 +1,7 @@
 #include "declaration.hpp"
 #include "core.hpp"
 #include "type.hpp"
+#include "type_context.hpp"
 
 namespace riddle
 {
@@ -55,6 +56,26 @@ namespace riddle
                 throw std::runtime_error("Invalid scope type");
     }
 
+    void field_declaration::check(type_context &ctx) const
+    {
+        auto &c_tp = resolve_type(ctx.get_scope(), tp);
+        for (const auto &[id, xpr] : fields)
+            if (xpr && !c_tp.is_assignable_from(xpr->check(ctx)))
+                throw std::runtime_error("Invalid assignment");
+    }
+
+    constructor_declaration::constructor_declaration(std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> &&inits, std::vector<std::unique_ptr<statement>> &&stmts) : params(std::move(params)), inits(std::move(inits)), stmts(std::move(stmts)), code(this->stmts)
+    { // the instance and the arguments occupy the leading slots of the frames..
+        layout.declare(this_kw);
+        for (const auto &param : this->params)
+            layout.declare(param.second.id);
+        for (auto &init : this->inits)
+            for (auto &xpr : init.second)
+                xpr->bind(layout);
+        for (auto &stmt : this->stmts)
+            stmt->bind(layout);
+    }
+
     void constructor_declaration::refine(scope &scp) const
     {
         std::vector<std::unique_ptr<field>> args; // the parameters of the constructor..
@@ -71,11 +92,34 @@ namespace riddle
         }
 
         if (auto tp = dynamic_cast<component_type *>(&scp))
-            tp->add_constructor(std::make_unique<constructor>(*tp, std::move(args), inits, stmts));
+            tp->add_constructor(std::make_unique<constructor>(*tp, std::move(args), inits, stmts, layout, code));
         else
             throw std::runtime_error("Invalid scope type");
     }
 
+    void constructor_declaration::check(const scope &scp, const type_context &globals) const
+    {
+        auto &ct = static_cast<const component_type &>(scp);
+        type_context ctx(scp, &globals, &ct);
+        ctx.declare(this_kw, ct);
+        for (const auto &param : params)
+            ctx.declare(param.second.id, resolve_type(scp, param.first));
+        for (const auto &init : inits)
+            for (const auto &xpr : init.second)
+                xpr->check(ctx);
+        for (const auto &stmt : stmts)
+            stmt->check(ctx);
+    }
+
+    method_declaration::method_declaration(std::vector<id_token> &&rt, id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::unique_ptr<statement>> &&stmts) : rt(std::move(rt)), name(std::move(name)), params(std::move(params)), stmts(std::move(stmts)), code(this->stmts)
+    { // the instance and the arguments occupy the leading slots of the frames..
+        layout.declare(this_kw);
+        for (const auto &param : this->params)
+            layout.declare(param.second.id);
+        for (auto &stmt : this->stmts)
+            stmt->bind(layout);
+    }
+
     void method_declaration::refine(scope &scp) const
     {
         std::vector<std::unique_ptr<field>> args; // the parameters of the method..
@@ -103,7 +147,7 @@ namespace riddle
             rt = *c_tp;
         }
 
-        auto mthd = std::make_unique<method>(scp, rt, name.id, std::move(args), stmts);
+        auto mthd = std::make_unique<method>(scp, rt, name.id, std::move(args), stmts, layout, code);
         if (auto ct = dynamic_cast<component_type *>(&scp))
             ct->add_method(std::move(mthd));
         else if (auto cr = dynamic_cast<core *>(&scp))
@@ -112,9 +156,27 @@ namespace riddle
             throw std::runtime_error("Invalid scope type");
     }
 
+    void method_declaration::check(const scope &scp, const type_context &globals) const
+    {
+        auto ct = dynamic_cast<const component_type *>(&scp);
+        type_context ctx(scp, &globals, ct, rt.empty() ? nullptr : &resolve_type(scp, rt));
+        if (ct)
+            ctx.declare(this_kw, *ct);
+        for (const auto &param : params)
+            ctx.declare(param.second.id, resolve_type(scp, param.first));
+        for (const auto &stmt : stmts)
+            stmt->check(ctx);
+    }
+
+    predicate_declaration::predicate_declaration(id_token &&name, std::vector<std::pair<std::vector<id_token>, id_token>> &&params, std::vector<std::vector<id_token>> &&base_predicates, std::vector<std::unique_ptr<statement>> &&body) : name(std::move(name)), params(std::move(params)), base_predicates(std::move(base_predicates)), body(std::move(body)), code(this->body)
+    { // the arguments are imported from the atom the predicate is called on..
+        for (auto &stmt : this->body)
+            stmt->bind(layout);
+    }
+
     void predicate_declaration::declare(scope &scp) const
     {
-        auto pred = std::make_unique<predicate>(scp, std::string(name.id), std::vector<std::unique_ptr<field>>(), body);
+        auto pred = std::make_unique<predicate>(scp, std::string(name.id), std::vector<std::unique_ptr<field>>(), body, layout, code);
         if (auto ct = dynamic_cast<component_type *>(&scp))
             ct->add_predicate(std::move(pred));
         else if (auto cr = dynamic_cast<core *>(&scp))
@@ -159,6 +221,14 @@ namespace riddle
             }
     }
 
+    void predicate_declaration::check(const scope &scp, const type_context &globals) const
+    { // the body is executed within the environment of the atoms..
+        auto &pred = scp.get_predicate(name.id);
+        type_context ctx(pred, &globals, &pred);
+        for (const auto &stmt : body)
+            stmt->check(ctx);
+    }
+
     void class_declaration::declare(scope &scp) const
     { // we create the class and add it to the scope..
         auto new_ct = std::make_unique<component_type>(scp, std::string(name.id));
@@ -220,4 +290,25 @@ namespace riddle
         for (const auto &tp : types)
             tp->refine_predicates(ct);
     }
+    void class_declaration::check(const scope &scp, const type_context &globals) const
+    {
+        auto &ct = static_cast<const component_type &>(scp.get_type(name.id)); // we retrieve the class type.. we know it exists, because we declared it, so we can safely cast it..
+        // we check the default values of the fields, which are evaluated as the instances are constructed..
+        type_context ctx(ct, &globals, &ct);
+        ctx.declare(this_kw, ct);
+        for (const auto &field : fields)
+            field->check(ctx);
+        // we check the constructors..
+        for (const auto &constructor : constructors)
+            constructor->check(ct, globals);
+        // we check the methods..
+        for (const auto &method : methods)
+            method->check(ct, globals);
+        // we check the predicates..
+        for (const auto &predicate : predicates)
+            predicate->check(ct, globals);
+        // we check the (enclosed) types..
+        for (const auto &tp : types)
+            tp->check(ct, globals);
+    }
 } // namespace riddle
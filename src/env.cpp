@@ -3,7 +3,7 @@
 
 namespace riddle
 {
-    env::env(core &c, env &parent, std::map<std::string, expr, std::less<>> &&items) noexcept : cr(c), parent(parent), items(std::move(items)) {}
+    env::env(core &c, env &parent, item_map &&items) noexcept : cr(c), parent(parent), items(std::move(items)) {}
 
     expr env::get(std::string_view name)
     {
@@ -14,16 +14,9 @@ namespace riddle
 
     expr id_expression::evaluate(const scope &, env &ctx) const
     {
-        auto obj = ctx.get(object_id[0].id);
+        auto obj = slot == unbound_slot ? ctx.get(object_id[0].id) : static_cast<frame &>(ctx).load(slot);
         for (size_t i = 1; i < object_id.size(); ++i)
-            if (auto c = dynamic_cast<component *>(obj.get()))
-                obj = c->get(object_id[i].id);
-            else if (auto c = dynamic_cast<atom_term *>(obj.get()))
-                obj = c->get(object_id[i].id);
-            else if (auto c = dynamic_cast<enum_term *>(obj.get()))
-                obj = c->get(object_id[i].id);
-            else
-                throw std::runtime_error("Invalid object reference");
+            obj = get_item(obj, object_id[i].id);
         return obj;
     }
 
@@ -31,7 +24,7 @@ namespace riddle
     {
         std::vector<bool_expr> exprs;
         for (const auto &expr : xprs)
-            exprs.emplace_back(std::dynamic_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
+            exprs.emplace_back(std::static_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
         return ctx.get_core().new_and(std::move(exprs));
     }
 
@@ -39,7 +32,7 @@ namespace riddle
     {
         std::vector<bool_expr> exprs;
         for (const auto &expr : xprs)
-            exprs.emplace_back(std::dynamic_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
+            exprs.emplace_back(std::static_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
         return ctx.get_core().new_or(std::move(exprs));
     }
 
@@ -47,19 +40,19 @@ namespace riddle
     {
         std::vector<bool_expr> exprs;
         for (const auto &expr : xprs)
-            exprs.emplace_back(std::dynamic_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
+            exprs.emplace_back(std::static_pointer_cast<bool_term>(expr->evaluate(scp, ctx)));
         return ctx.get_core().new_xor(std::move(exprs));
     }
 
-    expr not_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_not(std::dynamic_pointer_cast<bool_term>(xpr->evaluate(scp, ctx))); }
+    expr not_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_not(std::static_pointer_cast<bool_term>(xpr->evaluate(scp, ctx))); }
 
-    expr minus_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_negation(std::dynamic_pointer_cast<arith_term>(xpr->evaluate(scp, ctx))); }
+    expr minus_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_negation(std::static_pointer_cast<arith_term>(xpr->evaluate(scp, ctx))); }
 
     expr sum_expression::evaluate(const scope &scp, env &ctx) const
     {
         std::vector<arith_expr> c_xprs;
         for (const auto &xpr : xprs)
-            c_xprs.emplace_back(std::dynamic_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
+            c_xprs.emplace_back(std::static_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
         return ctx.get_core().new_sum(std::move(c_xprs));
     }
 
@@ -67,7 +60,7 @@ namespace riddle
     {
         std::vector<arith_expr> c_xprs;
         for (const auto &xpr : xprs)
-            c_xprs.emplace_back(std::dynamic_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
+            c_xprs.emplace_back(std::static_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
         return ctx.get_core().new_subtraction(std::move(c_xprs));
     }
 
@@ -75,7 +68,7 @@ namespace riddle
     {
         std::vector<arith_expr> c_xprs;
         for (const auto &xpr : xprs)
-            c_xprs.emplace_back(std::dynamic_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
+            c_xprs.emplace_back(std::static_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
         return ctx.get_core().new_product(std::move(c_xprs));
     }
 
@@ -83,45 +76,29 @@ namespace riddle
     {
         std::vector<arith_expr> c_xprs;
         for (const auto &xpr : xprs)
-            c_xprs.emplace_back(std::dynamic_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
+            c_xprs.emplace_back(std::static_pointer_cast<arith_term>(xpr->evaluate(scp, ctx)));
         return ctx.get_core().new_division(std::move(c_xprs));
     }
 
-    expr lt_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_lt(std::dynamic_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::dynamic_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
+    expr lt_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_lt(std::static_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::static_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
 
-    expr le_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_le(std::dynamic_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::dynamic_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
+    expr le_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_le(std::static_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::static_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
 
-    expr gt_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_gt(std::dynamic_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::dynamic_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
+    expr gt_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_gt(std::static_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::static_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
 
-    expr ge_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_ge(std::dynamic_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::dynamic_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
+    expr ge_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_ge(std::static_pointer_cast<arith_term>(lhs->evaluate(scp, ctx)), std::static_pointer_cast<arith_term>(rhs->evaluate(scp, ctx))); }
 
     expr eq_expression::evaluate(const scope &scp, env &ctx) const { return ctx.get_core().new_eq(lhs->evaluate(scp, ctx), rhs->evaluate(scp, ctx)); }
 
     expr constructor_expression::evaluate(const scope &scp, env &ctx) const
     {
-        auto tp = &scp.get_type(type_id[0].id);
-        for (size_t i = 1; i < type_id.size(); ++i)
-            if (auto ct = dynamic_cast<component_type *>(tp))
-                tp = &ct->get_type(type_id[i].id);
-            else
-                throw std::runtime_error("Invalid type reference");
+        auto &tp = resolve_type(scp, type_id, resolved_type);
 
         std::vector<expr> args;
         for (const auto &arg : arguments)
             args.emplace_back(arg->evaluate(scp, ctx));
 
-        std::vector<std::reference_wrapper<const type>> argument_types;
-        for (const auto &arg : args)
-            argument_types.emplace_back(arg->get_type());
-
-        if (auto ct = dynamic_cast<component_type *>(tp))
-        {
-            auto instance = ct->new_instance();
-            ct->get_constructor(argument_types).invoke(std::dynamic_pointer_cast<component>(instance), std::move(args));
-            return instance;
-        }
-        else
-            throw std::runtime_error("Invalid type reference");
+        return instantiate(tp, std::move(args), cache);
     }
 
     expr call_expression::evaluate(const scope &scp, env &ctx) const
@@ -129,31 +106,145 @@ namespace riddle
         expr obj;
         if (!object_id.empty())
         {
-            obj = ctx.get(object_id[0].id);
+            obj = slot == unbound_slot ? ctx.get(object_id[0].id) : static_cast<frame &>(ctx).load(slot);
             for (size_t i = 1; i < object_id.size(); ++i)
-                if (auto c = dynamic_cast<component *>(obj.get()))
-                    obj = c->get(object_id[i].id);
-                else if (auto c = dynamic_cast<atom_term *>(obj.get()))
-                    obj = c->get(object_id[i].id);
-                else if (auto c = dynamic_cast<enum_term *>(obj.get()))
-                    obj = c->get(object_id[i].id);
-                else
-                    throw std::runtime_error("Invalid object reference");
+                obj = get_item(obj, object_id[i].id);
         }
 
         std::vector<expr> args;
         for (const auto &arg : arguments)
             args.emplace_back(arg->evaluate(scp, ctx));
 
-        std::vector<std::reference_wrapper<const type>> argument_types;
-        for (const auto &arg : args)
-            argument_types.emplace_back(arg->get_type());
+        return invoke(obj, function_id.id, std::move(args), cache);
+    }
+
+    type &resolve_type(const scope &scp, const std::vector<id_token> &tp_id)
+    {
+        auto tp = &scp.get_type(tp_id[0].id);
+        for (size_t i = 1; i < tp_id.size(); ++i)
+            if (auto ct = dynamic_cast<component_type *>(tp))
+                tp = &ct->get_type(tp_id[i].id);
+            else
+                throw std::runtime_error("Invalid type reference");
+        return *tp;
+    }
+
+    type &resolve_type(const scope &scp, const std::vector<id_token> &tp_id, type *resolved) { return resolved ? *resolved : resolve_type(scp, tp_id); }
 
-        if (auto c = dynamic_cast<component *>(&*obj))
-            return static_cast<component_type &>(c->get_type()).get_method(function_id.id, argument_types).invoke(std::dynamic_pointer_cast<component>(obj), std::move(args));
-        else if (auto c = dynamic_cast<core *>(&*obj))
-            return c->get_method(function_id.id, argument_types).invoke(std::dynamic_pointer_cast<component>(obj), std::move(args));
+    expr get_item(const expr &obj, std::string_view name)
+    {
+        if (auto c = dynamic_cast<component *>(obj.get()))
+            return c->get(name);
+        else if (auto c = dynamic_cast<atom_term *>(obj.get()))
+            return c->get(name);
+        else if (auto c = dynamic_cast<enum_term *>(obj.get()))
+            return c->get(name);
         else
             throw std::runtime_error("Invalid object reference");
     }
+
+    expr constructor_expression::instantiate(type &tp, std::vector<expr> &&args, overload_cache<constructor> &cache)
+    {
+        auto &ct = static_cast<component_type &>(tp); // the type has been checked to be a component type..
+        auto &c = cache.get(ct, args, [&ct](const auto &argument_types) -> constructor &
+                            { return ct.get_constructor(argument_types); });
+        auto instance = ct.new_instance();
+        c.invoke(std::static_pointer_cast<component>(instance), std::move(args));
+        return instance;
+    }
+
+    expr invoke(const expr &obj, std::string_view name, std::vector<expr> &&args, overload_cache<method> &cache)
+    {
+        if (auto c = dynamic_cast<component *>(obj.get()))
+        {
+            auto &ct = static_cast<component_type &>(c->get_type());
+            auto &m = cache.get(ct, args, [&ct, name](const auto &argument_types) -> method &
+                                { return ct.get_method(name, argument_types); });
+            return m.invoke(std::static_pointer_cast<component>(obj), std::move(args));
+        }
+        else if (auto c = dynamic_cast<core *>(obj.get()))
+        {
+            auto &m = cache.get(*c, args, [c, name](const auto &argument_types) -> method &
+                                { return c->get_method(name, argument_types); });
+            return m.invoke(std::dynamic_pointer_cast<component>(obj), std::move(args));
+        }
+        else
+            throw std::runtime_error("Invalid object reference");
+    }
+
+    void id_expression::bind(frame_layout &layout) { slot = layout.resolve(object_id[0].id); }
+    void and_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void or_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void xor_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void not_expression::bind(frame_layout &layout) { xpr->bind(layout); }
+    void minus_expression::bind(frame_layout &layout) { xpr->bind(layout); }
+    void sum_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void subtraction_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void product_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void division_expression::bind(frame_layout &layout)
+    {
+        for (auto &xpr : xprs)
+            xpr->bind(layout);
+    }
+    void lt_expression::bind(frame_layout &layout)
+    {
+        lhs->bind(layout);
+        rhs->bind(layout);
+    }
+    void le_expression::bind(frame_layout &layout)
+    {
+        lhs->bind(layout);
+        rhs->bind(layout);
+    }
+    void gt_expression::bind(frame_layout &layout)
+    {
+        lhs->bind(layout);
+        rhs->bind(layout);
+    }
+    void ge_expression::bind(frame_layout &layout)
+    {
+        lhs->bind(layout);
+        rhs->bind(layout);
+    }
+    void eq_expression::bind(frame_layout &layout)
+    {
+        lhs->bind(layout);
+        rhs->bind(layout);
+    }
+    void constructor_expression::bind(frame_layout &layout)
+    {
+        for (auto &arg : arguments)
+            arg->bind(layout);
+    }
+    void call_expression::bind(frame_layout &layout)
+    {
+        if (!object_id.empty())
+            slot = layout.resolve(object_id[0].id);
+        for (auto &arg : arguments)
+            arg->bind(layout);
+    }
 } // namespace riddle
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "frame.hpp"
+#include "lexer.hpp"
+
+namespace riddle
+{
+    std::size_t frame_layout::declare(std::string_view name)
+    {
+        slots.push_back({std::string(name), false});
+        visible.push_back(slots.size() - 1);
+        return slots.size() - 1;
+    }
+
+    std::size_t frame_layout::resolve(std::string_view name)
+    {
+        if (auto slot = find(name))
+            return *slot;
+        for (std::size_t slot = 0; slot < slots.size(); ++slot)
+            if (slots[slot].import && slots[slot].name == name)
+                return slot; // the name has already been imported..
+        slots.push_back({std::string(name), true});
+        return slots.size() - 1;
+    }
+
+    std::optional<std::size_t> frame_layout::find(std::string_view name) const noexcept
+    {
+        for (auto it = visible.rbegin(); it != visible.rend(); ++it)
+            if (slots[*it].name == name)
+                return *it;
+        return std::nullopt;
+    }
+
+    std::size_t frame_layout::return_slot()
+    {
+        if (!ret)
+        { // the returned value is not visible to the names of the body..
+            slots.push_back({return_kw, false});
+            ret = slots.size() - 1;
+        }
+        return *ret;
+    }
+
+    expr frame::get(std::string_view name)
+    {
+        for (std::size_t slot = slots.size(); slot-- > 0;)
+            if (slots[slot] && !layout->is_import(slot) && layout->get_name(slot) == name)
+                return slots[slot];
+        return env::get(name);
+    }
+} // namespace riddle
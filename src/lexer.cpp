@@ -1,1007 +1,447 @@
 #include "lexer.hpp"
+#include "scan.hpp"
 #include <stdexcept>
-#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <charconv>
+#include <limits>
+#include <array>
+#include <iterator>
 
 namespace riddle
 {
     std::vector<std::unique_ptr<const token>> lexer::parse(std::istream &is)
     {
-        std::vector<std::unique_ptr<const token>> tokens;
-
-        current_state = START;
-        line = 1;
-        start = 0;
-        text.clear();
+        const std::string src{std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()};
+        return parse(std::string_view(src));
+    }
 
-        while (is.good())
-        {
-            switch (auto c = is.get())
+    std::vector<std::unique_ptr<const token>> lexer::parse(std::string_view src)
+    {
+        auto ts = tokenize(src);
+        std::vector<std::unique_ptr<const token>> tokens;
+        tokens.reserve(ts.size());
+        for (size_t i = 0; i < ts.size(); ++i)
+            switch (const auto &tk = ts.records[i]; tk.sym)
             {
-            case '/':
-                switch (is.peek())
-                {
-                case '/': // single line comment
-                    is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                    ++line;
-                    start = 0;
-                    if (!is.good()) // end of file before `\n`
-                        tokens.push_back(std::make_unique<token>(EoF, line, start, start));
-                    break;
-                case '*': // multi-line comment
-                    is.ignore();
-                    while (is.good())
-                    {
-                        if (is.get() == '*' && is.peek() == '/')
-                        {
-                            is.ignore();
-                            break;
-                        }
-                        if (is.peek() == '\n')
-                            ++line;
-                    }
-                    start = 0;
-                    break;
-                default:
-                    text.push_back(c);
-                    current_state = SLASH;
-                    tokens.push_back(finish_token());
-                }
+            case ID:
+                tokens.push_back(std::make_unique<id_token>(ts.get_id(tk), tk.line, tk.start_pos, tk.end_pos));
                 break;
-            case 'b':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'o'))
-                        text.push_back('o');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'o'))
-                        text.push_back('o');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'l'))
-                        text.push_back('l');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = BOOL;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case Bool:
+                tokens.push_back(std::make_unique<bool_token>(ts.get_bool(tk), tk.line, tk.start_pos, tk.end_pos));
                 break;
-            case 'c':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'l'))
-                        text.push_back('l');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'a'))
-                        text.push_back('a');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 's'))
-                        text.push_back('s');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 's'))
-                        text.push_back('s');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = CLASS;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
-                break;
-            case 'e':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'n'))
-                        text.push_back('n');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'u'))
-                        text.push_back('u');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'm'))
-                        text.push_back('m');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = ENUM;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
-                break;
-            case 'f':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'a'))
-                    {
-                        text.push_back('a');
-                        if (match(is, 'c'))
-                        {
-                            text.push_back('c');
-                            if (match(is, 't'))
-                                text.push_back('t');
-                            else
-                            {
-                                current_state = ID;
-                                break;
-                            }
-                            if (is_id_part(is.peek()))
-                            {
-                                current_state = ID;
-                                break;
-                            }
-                            else
-                            {
-                                current_state = FACT;
-                                tokens.push_back(finish_token());
-                            }
-                        }
-                        else if (match(is, 'l'))
-                        {
-                            text.push_back('l');
-                            if (match(is, 's'))
-                                text.push_back('s');
-                            else
-                                break;
-                            if (match(is, 'e'))
-                                text.push_back('e');
-                            else
-                            {
-                                current_state = ID;
-                                break;
-                            }
-                            if (is_id_part(is.peek()))
-                            {
-                                current_state = ID;
-                                break;
-                            }
-                            else
-                            {
-                                current_state = Bool;
-                                tokens.push_back(finish_token());
-                            }
-                        }
-                        else
-                        {
-                            current_state = ID;
-                            text.push_back(c);
-                        }
-                    }
-                    else if (match(is, 'o'))
-                    {
-                        text.push_back('o');
-                        if (match(is, 'r'))
-                            text.push_back('r');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = FOR;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else
-                        current_state = ID;
-                }
-                else
-                    text.push_back(c);
-                break;
-            case 'g':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'o'))
-                        text.push_back('o');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'a'))
-                        text.push_back('a');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'l'))
-                        text.push_back('l');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = GOAL;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case Int:
+                tokens.push_back(std::make_unique<int_token>(ts.get_int(tk), tk.line, tk.start_pos, tk.end_pos));
                 break;
-            case 'i':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'n'))
-                        text.push_back('n');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 't'))
-                        text.push_back('t');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = INT;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case Real:
+                tokens.push_back(std::make_unique<real_token>(std::move(ts.reals[tk.payload]), tk.line, tk.start_pos, tk.end_pos));
                 break;
-            case 'n':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'e'))
-                        text.push_back('e');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'w'))
-                        text.push_back('w');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = NEW;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case String:
+                tokens.push_back(std::make_unique<string_token>(std::move(ts.strings[tk.payload]), tk.line, tk.start_pos, tk.end_pos));
                 break;
-            case 'o':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'r'))
-                        text.push_back('r');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = OR;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            default:
+                tokens.push_back(std::make_unique<token>(tk.sym, tk.line, tk.start_pos, tk.end_pos));
+            }
+        return tokens;
+    }
+
+    token_stream lexer::tokenize(std::string_view src)
+    {
+        auto ts = stream(src);
+        do
+            next_token(ts);
+        while (ts.records.back().sym != EoF);
+        ts.source = nullptr; // the stream is complete, so it does not depend on this lexer anymore..
+        return ts;
+    }
+
+    token_stream lexer::stream(std::string_view src)
+    {
+        input = nullptr;
+        reset(src);
+        return token_stream(this);
+    }
+
+    token_stream lexer::stream(std::istream &is)
+    {
+        input = &is;
+        window.resize(window_size);
+        reset(std::string_view(window.data(), 0));
+        return token_stream(this);
+    }
+
+    void lexer::reset(std::string_view src) noexcept
+    {
+        begin = cur = src.data();
+        end = begin + src.size();
+        offset = line_start = 0;
+        line = 1;
+    }
+
+    bool lexer::refill(const char *&keep)
+    {
+        if (!input || !input->good())
+            return false;
+
+        const auto keep_off = static_cast<size_t>(keep - begin), kept = static_cast<size_t>(end - keep), cur_off = static_cast<size_t>(cur - keep);
+        if (kept == window.size()) // the retained characters fill the whole window, so we enlarge it..
+            window.resize(window.size() * 2);
+        std::memmove(window.data(), window.data() + keep_off, kept);
+        offset += keep_off;
+
+        input->read(window.data() + kept, static_cast<std::streamsize>(window.size() - kept));
+        const auto read = static_cast<size_t>(input->gcount());
+        begin = keep = window.data();
+        cur = begin + cur_off;
+        end = begin + kept + read;
+        return read > 0;
+    }
+
+    bool lexer::available(size_t n)
+    {
+        while (static_cast<size_t>(end - cur) < n)
+            if (!refill(cur))
+                return false;
+        return true;
+    }
+
+    void lexer::new_line(const char *nl) noexcept
+    {
+        ++line;
+        line_start = offset + static_cast<size_t>(nl + 1 - begin);
+    }
+
+    void token_stream::release(size_t pos) noexcept
+    {
+        for (size_t i = records.begin_index(); i < pos && records.contains(i); ++i)
+            switch (const auto &tk = records[i]; tk.sym)
+            {
+            case ID:
+                ids.release(tk.payload + 1);
                 break;
-            case 'p':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'r'))
-                        text.push_back('r');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'e'))
-                        text.push_back('e');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'd'))
-                        text.push_back('d');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'i'))
-                        text.push_back('i');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'c'))
-                        text.push_back('c');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'a'))
-                        text.push_back('a');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 't'))
-                        text.push_back('t');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'e'))
-                        text.push_back('e');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = PREDICATE;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case Int:
+                ints.release(tk.payload + 1);
                 break;
-            case 'r':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'e'))
-                        text.push_back('e');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'a'))
-                    {
-                        text.push_back('a');
-                        if (match(is, 'l'))
-                            text.push_back('l');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = REAL;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else if (match(is, 't'))
-                    {
-                        text.push_back('t');
-                        if (match(is, 'u'))
-                            text.push_back('u');
-                        else
-                            break;
-                        if (match(is, 'r'))
-                            text.push_back('r');
-                        else
-                            break;
-                        if (match(is, 'n'))
-                            text.push_back('n');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = RETURN;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else
-                        current_state = ID;
-                }
-                else
-                    text.push_back(c);
+            case Real:
+                reals.release(tk.payload + 1);
                 break;
-            case 's':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 't'))
-                        text.push_back('t');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'r'))
-                        text.push_back('r');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'i'))
-                        text.push_back('i');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'n'))
-                        text.push_back('n');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'g'))
-                        text.push_back('g');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    else
-                    {
-                        current_state = STRING;
-                        tokens.push_back(finish_token());
-                    }
-                }
-                else
-                    text.push_back(c);
+            case String:
+                strings.release(tk.payload + 1);
                 break;
-            case 't':
-                if (current_state == START)
-                {
-                    text.push_back(c);
-                    if (match(is, 'h'))
-                    {
-                        text.push_back('h');
-                        if (match(is, 'i'))
-                            text.push_back('i');
-                        else
-                            break;
-                        if (match(is, 's'))
-                            text.push_back('s');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = THIS;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else if (match(is, 'i'))
-                    {
-                        text.push_back('i');
-                        if (match(is, 'm'))
-                            text.push_back('m');
-                        else
-                            break;
-                        if (match(is, 'e'))
-                            text.push_back('e');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = TIME;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else if (match(is, 'r'))
-                    {
-                        text.push_back('r');
-                        if (match(is, 'u'))
-                            text.push_back('u');
-                        else
-                            break;
-                        if (match(is, 'e'))
-                            text.push_back('e');
-                        else
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        if (is_id_part(is.peek()))
-                        {
-                            current_state = ID;
-                            break;
-                        }
-                        else
-                        {
-                            current_state = Bool;
-                            tokens.push_back(finish_token());
-                        }
-                    }
-                    else
-                        current_state = ID;
-                }
-                else
-                    text.push_back(c);
+            default:
                 break;
-            case 'v':
-                if (current_state == START)
+            }
+        records.release(pos);
+    }
+
+    const token_record &token_stream::pull(size_t pos)
+    {
+        while (source && pos >= records.end_index() && (records.end_index() == 0 || records.back().sym != EoF))
+            source->next_token(*this);
+        if (!records.contains(pos))
+            throw std::out_of_range("token " + std::to_string(pos) + " is not available");
+        return records[pos];
+    }
+
+    static inline bool is_digit(char ch) noexcept { return ch >= '0' && ch <= '9'; }
+
+    /**
+     * @brief Decodes the integer literal in `[first, last)`, which contains digits only.
+     *
+     * @throws std::runtime_error If the value does not fit in an `INT_TYPE`.
+     */
+    static INT_TYPE decode_int(const char *first, const char *last)
+    {
+        INT_TYPE val = 0;
+        if (std::from_chars(first, last, val).ec == std::errc::result_out_of_range)
+            throw std::runtime_error("Integer literal out of range: " + std::string(first, last));
+        return val;
+    }
+
+    /**
+     * @brief Decodes the real literal in `[first, last)`, whose integer and fractional digits are separated by `dot`.
+     *
+     * The literal is decoded into the fraction having the digits as numerator and the proper power of ten as denominator.
+     *
+     * @throws std::runtime_error If the numerator or the denominator does not fit in an `INT_TYPE`.
+     */
+    static utils::rational decode_real(const char *first, const char *dot, const char *last)
+    {
+        constexpr auto max = std::numeric_limits<INT_TYPE>::max();
+        const char *frac_end = last;
+        while (frac_end != dot + 1 && frac_end[-1] == '0') // trailing zeros do not change the value, so we skip them to widen the range..
+            --frac_end;
+
+        INT_TYPE num = 0, den = 1;
+        for (const char *p = first; p != frac_end; ++p)
+            if (p != dot)
+            {
+                const INT_TYPE digit = *p - '0';
+                if (num > (max - digit) / 10 || (p > dot && den > max / 10))
+                    throw std::runtime_error("Real literal out of range: " + std::string(first, last));
+                num = num * 10 + digit;
+                if (p > dot)
+                    den *= 10;
+            }
+        return utils::rational(num, den);
+    }
+
+    void lexer::skip_blanks()
+    {
+        while (cur != end || refill(cur))
+        {
+            if (*cur == '\n')
+                new_line(cur++);
+            else if (*cur == ' ' || *cur == '\t' || *cur == '\r')
+                cur = scan::skip_spaces(cur + 1, end);
+            else if (*cur == '/' && available(2) && cur[1] == '/')
+            { // single line comment..
+                for (cur = scan::find(cur + 2, end, '\n'); cur == end; cur = scan::find(cur, end, '\n'))
+                    if (!refill(cur))
+                        return;
+            }
+            else if (*cur == '/' && available(2) && cur[1] == '*')
+            { // multi-line comment..
+                cur += 2;
+                for (;;)
                 {
-                    text.push_back(c);
-                    if (match(is, 'o'))
-                        text.push_back('o');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'i'))
-                        text.push_back('i');
-                    else
-                    {
-                        current_state = ID;
-                        break;
-                    }
-                    if (match(is, 'd'))
-                        text.push_back('d');
-                    else
-                    {
-                        current_state = ID;
-                        break;
+                    cur = scan::find_either(cur, end, '*', '\n');
+                    if (cur == end || (*cur == '*' && cur + 1 == end))
+                    { // we retain the last character, which might be the `*` of the closing `*/`..
+                        if (!refill(cur))
+                            throw std::runtime_error("Unterminated comment");
                     }
-                    if (is_id_part(is.peek()))
-                    {
-                        current_state = ID;
+                    else if (*cur == '\n')
+                        new_line(cur++);
+                    else if (cur[1] == '/')
                         break;
-                    }
                     else
-                    {
-                        current_state = VOID;
-                        tokens.push_back(finish_token());
-                    }
+                        ++cur;
                 }
-                else
-                    text.push_back(c);
-                break;
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-                if (current_state == START)
-                    current_state = Int;
-                else if (current_state != ID && current_state != Int && current_state != Real)
-                    tokens.push_back(finish_token());
-                text.push_back(c);
+                cur += 2;
+            }
+            else
+                return;
+        }
+    }
+
+    void lexer::next_token(token_stream &ts)
+    {
+        // we skip whitespaces and comments..
+        skip_blanks();
+
+        if (cur == end)
+            return ts.push(EoF, line, column(cur), column(cur));
+
+        static_cast<void>(available(2)); // we make sure that a character of lookahead is available, if any..
+        const auto start_pos = column(cur);
+        switch (*cur)
+        {
+        case '.':
+            if (cur + 1 == end || !is_digit(cur[1]))
+            {
+                ++cur;
+                return ts.push(DOT, line, start_pos, start_pos);
+            }
+            [[fallthrough]];
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        {
+            const char *p, *dot;
+            do
+            { // we scan the literal until we are sure it is entirely within the buffer..
+                p = cur;
+                dot = nullptr;
+                while (p != end && is_digit(*p))
+                    ++p;
+                if (p + 1 < end && *p == '.' && is_digit(p[1]))
+                    for (dot = p++; p != end && is_digit(*p);)
+                        ++p;
+            } while (p + 1 >= end && refill(cur));
+
+            const char *tk_start = cur;
+            cur = p;
+            if (dot)
+            { // a real number..
+                return ts.push(Real, line, start_pos, start_pos + (cur - tk_start) - 1, ts.reals.push_back(decode_real(tk_start, dot, cur)));
+            }
+            return ts.push(Int, line, start_pos, start_pos + (cur - tk_start) - 1, ts.ints.push_back(decode_int(tk_start, cur)));
+        }
+        case '"':
+        {
+            const char *close;
+            while ((close = scan::find(cur + 1, end, '"')) == end)
+                if (!refill(cur))
+                    throw std::runtime_error("Unterminated string literal");
+            const char *tk_start = cur;
+            const auto tk_line = line;
+            for (const char *nl = scan::find(tk_start + 1, close, '\n'); nl != close; nl = scan::find(nl + 1, close, '\n'))
+                new_line(nl);
+            cur = close + 1;
+            return ts.push(String, tk_line, start_pos, start_pos + (cur - tk_start) - 1, ts.strings.push_back(std::string(tk_start + 1, close)));
+        }
+        case '=':
+        case '>':
+        case '<':
+        case '!':
+        {
+            const bool eq = cur + 1 != end && cur[1] == '=';
+            symbol sym;
+            switch (*cur)
+            {
+            case '=':
+                sym = eq ? EQEQ : EQ;
                 break;
-            case '.':
-                if ((current_state == START && std::isdigit(is.peek())) || current_state == Int)
-                {
-                    current_state = Real;
-                    text.push_back(c);
-                }
-                else
-                {
-                    if (!text.empty())
-                        tokens.push_back(finish_token());
-                    current_state = DOT;
-                    text.push_back(c);
-                    tokens.push_back(finish_token());
-                }
+            case '>':
+                sym = eq ? GTEQ : GT;
                 break;
-            case '"':
-                switch (current_state)
-                {
-                case START:
-                    current_state = String;
-                    text.push_back(c);
-                    break;
-                case String:
-                    text.push_back(c);
-                    tokens.push_back(finish_token());
-                    break;
-                default:
-                    throw std::runtime_error("Unexpected character: " + std::string(1, c));
-                }
+            case '<':
+                sym = eq ? LTEQ : LT;
                 break;
+            default:
+                sym = eq ? BANGEQ : BANG;
+            }
+            cur += eq ? 2 : 1;
+            return ts.push(sym, line, start_pos, start_pos + (eq ? 1 : 0));
+        }
+        default:
+        {
+            symbol sym;
+            switch (*cur)
+            {
             case '(':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = LPAREN;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = LPAREN;
                 break;
             case ')':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = RPAREN;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = RPAREN;
                 break;
             case '{':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = LBRACE;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = LBRACE;
                 break;
             case '}':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = RBRACE;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = RBRACE;
                 break;
             case '[':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = LBRACKET;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = LBRACKET;
                 break;
             case ']':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = RBRACKET;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = RBRACKET;
                 break;
             case ',':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = COMMA;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = COMMA;
                 break;
             case ':':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = COLON;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = COLON;
                 break;
             case ';':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = SEMICOLON;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = SEMICOLON;
                 break;
             case '+':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = PLUS;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = PLUS;
                 break;
             case '-':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = MINUS;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = MINUS;
                 break;
             case '*':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = STAR;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = STAR;
+                break;
+            case '/':
+                sym = SLASH;
                 break;
             case '&':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = AMP;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = AMP;
                 break;
             case '|':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = BAR;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = BAR;
                 break;
             case '?':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = QUESTION;
-                text.push_back(c);
-                tokens.push_back(finish_token());
-                break;
-            case '=':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = EQ;
-                text.push_back(c);
-                if (is.peek() == '=')
-                {
-                    is.ignore();
-                    current_state = EQEQ;
-                    text.push_back('=');
-                }
-                tokens.push_back(finish_token());
-                break;
-            case '>':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = GT;
-                text.push_back(c);
-                if (is.peek() == '=')
-                {
-                    is.ignore();
-                    current_state = GTEQ;
-                    text.push_back('=');
-                }
-                tokens.push_back(finish_token());
-                break;
-            case '<':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = LT;
-                text.push_back(c);
-                if (is.peek() == '=')
-                {
-                    is.ignore();
-                    current_state = LTEQ;
-                    text.push_back('=');
-                }
-                tokens.push_back(finish_token());
-                break;
-            case '!':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = BANG;
-                text.push_back(c);
-                if (is.peek() == '=')
-                {
-                    is.ignore();
-                    current_state = BANGEQ;
-                    text.push_back('=');
-                }
-                tokens.push_back(finish_token());
+                sym = QUESTION;
                 break;
             case '^':
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                current_state = CARET;
-                text.push_back(c);
-                tokens.push_back(finish_token());
+                sym = CARET;
                 break;
-            case '\r':
-                if (current_state == String)
-                    text.push_back(c);
-                else
-                {
-                    if (!text.empty())
-                        tokens.push_back(finish_token());
-                    start = 0;
-                }
-                break;
-            case '\n':
-                if (current_state == String)
-                    text.push_back(c);
-                else
-                {
-                    if (!text.empty())
-                        tokens.push_back(finish_token());
-                    start = 0;
-                    ++line;
-                }
-                break;
-            case ' ':
-            case '\t':
-                if (current_state == String)
-                    text.push_back(c);
-                else
+            default:
+            {
+                if (!scan::is_id_char(*cur))
+                    throw std::runtime_error("Unexpected character: " + std::string(1, *cur));
+                // an identifier or a keyword..
+                const char *p;
+                do
+                { // we scan the identifier until we are sure it is entirely within the buffer..
+                    p = scan::skip_id(cur, end);
+                } while (p == end && refill(cur));
+
+                const std::string_view id(cur, p - cur);
+                cur = p;
+                const auto end_pos = start_pos + id.size() - 1;
+                switch (sym = keyword(id))
                 {
-                    if (!text.empty())
-                        tokens.push_back(finish_token());
-                    ++start;
+                case ID:
+                    return ts.push(ID, line, start_pos, end_pos, ts.ids.push_back(&symbols.intern(id)));
+                case Bool:
+                    return ts.push(Bool, line, start_pos, end_pos, id.front() == 't');
+                default:
+                    return ts.push(sym, line, start_pos, end_pos);
                 }
-                break;
-            case EOF:
-                if (!text.empty())
-                    tokens.push_back(finish_token());
-                tokens.push_back(std::make_unique<token>(EoF, line, start, start));
-                break;
-            default:
-                if (current_state == START)
-                    current_state = ID;
-                text.push_back(c);
             }
+            }
+            ++cur;
+            return ts.push(sym, line, start_pos, start_pos);
         }
-
-        return tokens;
-    }
-
-    bool lexer::match(std::istream &is, char expected) noexcept
-    {
-        if (is.peek() == expected)
-        {
-            is.ignore();
-            return true;
         }
-        return false;
     }
 
-    std::unique_ptr<const token> lexer::finish_token() noexcept
+    namespace
     {
-        std::unique_ptr<token> tok;
-        auto end = start + text.size() - 1;
-        switch (current_state)
+        struct keyword_entry
         {
-        case Bool:
-            tok = std::make_unique<bool_token>(text == "true", line, start, end);
-            break;
-        case Int:
-            tok = std::make_unique<int_token>(std::stoll(text), line, start, end);
-            break;
-        case Real:
+            std::string_view id;
+            symbol sym = ID;
+        };
+
+        constexpr keyword_entry keywords[] = {{bool_kw, BOOL}, {int_kw, INT}, {real_kw, REAL}, {time_kw, TIME}, {string_kw, STRING}, {"enum", ENUM}, {"class", CLASS}, {"predicate", PREDICATE}, {"new", NEW}, {"for", FOR}, {this_kw, THIS}, {"void", VOID}, {return_kw, RETURN}, {"fact", FACT}, {"goal", GOAL}, {"or", OR}, {"true", Bool}, {"false", Bool}};
+        constexpr size_t min_keyword_size = 2, max_keyword_size = 9;
+        constexpr size_t keyword_slots = 32;
+
+        /**
+         * @brief Hashes an identifier of at least two characters into a slot of the keyword table.
+         *
+         * The coefficients are chosen so that no two keywords share a slot.
+         */
+        constexpr size_t keyword_hash(std::string_view id) noexcept { return (id.size() + 5u * static_cast<unsigned char>(id[0]) + 4u * static_cast<unsigned char>(id[1]) + 4u * static_cast<unsigned char>(id.back())) & (keyword_slots - 1); }
+
+        constexpr std::array<keyword_entry, keyword_slots> make_keyword_table() noexcept
         {
-            size_t dot_pos = text.find('.');
-            std::string intgr = text.substr(0, dot_pos);
-            std::string dec = text.substr(dot_pos + 1);
-            tok = std::make_unique<real_token>(utils::rational(static_cast<INT_TYPE>(std::stol(intgr + dec)), static_cast<INT_TYPE>(std::pow(10, dec.size()))), line, start, end);
-            break;
+            std::array<keyword_entry, keyword_slots> table{};
+            for (const auto &kw : keywords)
+                table[keyword_hash(kw.id)] = kw;
+            return table;
         }
-        case String:
-            tok = std::make_unique<string_token>(text.substr(1, text.size() - 2), line, start, end);
-            break;
-        case ID:
-            tok = std::make_unique<id_token>(std::move(text), line, start, end);
-            break;
-        default:
-            tok = std::make_unique<token>(current_state, line, start, end);
+        constexpr auto keyword_table = make_keyword_table();
+
+        constexpr bool is_perfect() noexcept
+        {
+            for (const auto &kw : keywords)
+                if (kw.id.size() < min_keyword_size || kw.id.size() > max_keyword_size || keyword_table[keyword_hash(kw.id)].id != kw.id)
+                    return false;
+            return true;
         }
-        start = end + 1;
-        current_state = START;
-        text.clear();
-        return tok;
+        static_assert(is_perfect(), "the keyword hash has collisions: the coefficients of `keyword_hash` must be changed");
+    } // namespace
+
+    symbol lexer::keyword(std::string_view id) noexcept
+    {
+        if (id.size() < min_keyword_size || id.size() > max_keyword_size)
+            return ID;
+        const auto &kw = keyword_table[keyword_hash(id)];
+        return kw.id == id ? kw.sym : ID;
     }
 } // namespace riddle
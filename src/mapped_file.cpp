@@ -0,0 +1,93 @@
+#include "mapped_file.hpp"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#define RIDDLE_MMAP
+#endif
+
+namespace riddle
+{
+#ifdef RIDDLE_MMAP
+    // files larger than this are read sequentially by the kernel, which reads ahead more aggressively and drops the pages already read..
+    static constexpr size_t sequential_size = 1 << 20;
+#endif
+
+    mapped_file::mapped_file(const std::filesystem::path &file)
+    {
+#ifdef RIDDLE_MMAP
+        if (const int fd = ::open(file.c_str(), O_RDONLY); fd >= 0)
+        {
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+            {
+                size = static_cast<size_t>(st.st_size);
+                if (size == 0)
+                { // empty files cannot be mapped, but there is nothing to read either..
+                    ::close(fd);
+                    return;
+                }
+                if (void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); addr != MAP_FAILED)
+                {
+                    ::close(fd); // the mapping keeps the file alive..
+                    if (size >= sequential_size)
+                        ::madvise(addr, size, MADV_SEQUENTIAL);
+                    data = static_cast<const char *>(addr);
+                    mapped = true;
+                    return;
+                }
+            }
+            else if (S_ISFIFO(st.st_mode) || S_ISCHR(st.st_mode))
+            { // pipes cannot be mapped nor reopened without losing what has been written to them, so we read them through the descriptor we have..
+                char chunk[1 << 16];
+                ssize_t n;
+                while ((n = ::read(fd, chunk, sizeof(chunk))) > 0 || (n < 0 && errno == EINTR))
+                    if (n > 0)
+                        buffer.append(chunk, static_cast<size_t>(n));
+                ::close(fd);
+                if (n < 0)
+                    throw std::runtime_error("file `" + file.string() + "` could not be read");
+                data = buffer.data();
+                size = buffer.size();
+                return;
+            }
+            ::close(fd);
+        }
+#endif
+        // we read the whole file into the buffer..
+        std::ifstream ifs(file, std::ios::binary);
+        if (!ifs.is_open())
+            throw std::runtime_error("file `" + file.string() + "` not found");
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(file, ec) && ifs.seekg(0, std::ios::end))
+            if (const auto end = ifs.tellg(); end >= 0 && ifs.seekg(0, std::ios::beg))
+            { // the size of the file is known, so we read it in one go..
+                buffer.resize(static_cast<size_t>(end));
+                if (!ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+                    throw std::runtime_error("file `" + file.string() + "` could not be read");
+            }
+        if (buffer.empty())
+        { // the size of the file is not known, so we read until its end..
+            ifs.clear();
+            buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            if (ifs.bad())
+                throw std::runtime_error("file `" + file.string() + "` could not be read");
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    mapped_file::~mapped_file()
+    {
+#ifdef RIDDLE_MMAP
+        if (mapped)
+            ::munmap(const_cast<char *>(data), size);
+#endif
+    }
+} // namespace riddle
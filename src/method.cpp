@@ -1,8 +1,10 @@
 #include "method.hpp"
+#include "core.hpp"
+#include "bytecode.hpp"
 
 namespace riddle
 {
-    method::method(scope &scp, std::optional<std::reference_wrapper<type>> return_type, std::string_view name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body) noexcept : scope(scp.get_core(), scp), return_type(return_type), name(name), body(body)
+    method::method(scope &scp, std::optional<std::reference_wrapper<type>> return_type, std::string_view name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept : scope(scp.get_core(), scp), return_type(return_type), name(name), body(body), layout(layout), code(code)
     {
         for (auto &arg : args)
         {
@@ -14,18 +16,20 @@ namespace riddle
     expr method::invoke(std::shared_ptr<component> self, std::vector<expr> &&args) const
     {
         // the context in which the method is invoked..
-        env ctx(get_core(), *self);
-        if (self)
-            ctx.items.emplace(this_kw, self); // the current instance
+        frame ctx(get_core(), self ? static_cast<env &>(*self) : static_cast<env &>(get_core()), &layout);
+        ctx[0] = self; // the current instance
         for (size_t i = 0; i < this->args.size(); ++i)
-            ctx.items.emplace(this->args[i], args[i]); // the arguments
+            ctx[i + 1] = args[i]; // the arguments
 
         // we execute the body of the method
-        for (const auto &stmt : body)
-            stmt->execute(*this, ctx);
+        if (get_core().uses_bytecode())
+            code.run(*this, ctx);
+        else
+            for (const auto &stmt : body)
+                stmt->execute(*this, ctx);
 
-        if (auto it = ctx.items.find("return"); it != ctx.items.end())
-            return it->second;
+        if (auto ret = layout.find_return_slot())
+            return ctx[*ret];
         return nullptr;
     }
 } // namespace riddle
@@ -1,32 +1,75 @@
 #include "parser.hpp"
+#include <algorithm>
+#include <iterator>
 #include <cassert>
 
 namespace riddle
 {
-    parser::parser(std::istream &is) : lex(), tokens(lex.parse(is)), pos(0) {}
+    parser::parser(std::istream &is, symbol_table &symbols) : symbols(symbols), lex(symbols), tokens(lex.stream(is)), nodes(std::make_shared<arena>()) {}
+    parser::parser(std::string_view src, symbol_table &symbols) : symbols(symbols), lex(symbols), tokens(lex.stream(src)), nodes(std::make_shared<arena>()) {}
+
+    namespace
+    {
+        constexpr size_t element_chunk_size = 1 << 12; // the size of the chunks of the arenas of single elements, which are usually small..
+
+        class collector final : public compilation_unit_listener
+        {
+        public:
+            void parsed(std::unique_ptr<type_declaration> &&td) override { types.emplace_back(std::move(td)); }
+            void parsed(std::unique_ptr<method_declaration> &&md) override { methods.emplace_back(std::move(md)); }
+            void parsed(std::unique_ptr<predicate_declaration> &&pd) override { predicates.emplace_back(std::move(pd)); }
+            void parsed(std::unique_ptr<statement> &&stmt) override { statements.emplace_back(std::move(stmt)); }
+
+            std::vector<std::unique_ptr<type_declaration>> types;           // the type declarations..
+            std::vector<std::unique_ptr<method_declaration>> methods;       // the method declarations..
+            std::vector<std::unique_ptr<predicate_declaration>> predicates; // the predicate declarations..
+            std::vector<std::unique_ptr<statement>> statements;             // the statements..
+        };
+
+        /**
+         * @brief Makes the nodes built by the parser come from the heap again once the compilation unit has been parsed, even if parsing fails.
+         */
+        class node_source final
+        {
+        public:
+            node_source(arena *&c_nodes) noexcept : c_nodes(c_nodes) {}
+            node_source(const node_source &) = delete;
+            ~node_source() { c_nodes = nullptr; }
+
+        private:
+            arena *&c_nodes;
+        };
+    } // namespace
 
     std::unique_ptr<compilation_unit> parser::parse_compilation_unit()
     {
-        std::vector<std::unique_ptr<type_declaration>> types;           // the type declarations..
-        std::vector<std::unique_ptr<predicate_declaration>> predicates; // the predicate declarations..
-        std::vector<std::unique_ptr<method_declaration>> methods;       // the method declarations..
-        std::vector<std::unique_ptr<statement>> statements;             // the statements..
+        collector c;
+        parse_compilation_unit(c);
+        return std::make_unique<compilation_unit>(std::move(c.types), std::move(c.methods), std::move(c.predicates), std::move(c.statements), nodes);
+    }
 
+    void parser::parse_compilation_unit(compilation_unit_listener &listener)
+    {
+        node_source src(c_nodes);
         while (!match(EoF))
         {
-            switch (tokens.at(pos)->sym)
+            tokens.release(pos); // the tokens of the previous elements are not needed anymore..
+            if (listener.element_arenas() && nodes->allocated())
+                nodes = std::make_shared<arena>(element_chunk_size); // the arena of the previous element is released together with its nodes..
+            c_nodes = nodes.get();                                   // the nodes are allocated from the arena of the parser..
+            switch (tokens.at(pos).sym)
             {
             case ENUM:
-                types.emplace_back(parse_enum_declaration());
+                listener.parsed(std::unique_ptr<type_declaration>(parse_enum_declaration()));
                 break;
             case CLASS:
-                types.emplace_back(parse_class_declaration());
+                listener.parsed(std::unique_ptr<type_declaration>(parse_class_declaration()));
                 break;
             case PREDICATE:
-                predicates.emplace_back(parse_predicate_declaration());
+                listener.parsed(parse_predicate_declaration());
                 break;
             case VOID:
-                methods.emplace_back(parse_method_declaration());
+                listener.parsed(parse_method_declaration());
                 break;
             case BOOL:
             case INT:
@@ -41,12 +84,12 @@ namespace riddle
                 if (match(LPAREN))
                 { // method declaration..
                     pos -= 2;
-                    methods.emplace_back(parse_method_declaration());
+                    listener.parsed(parse_method_declaration());
                 }
                 else
                 { // statement..
                     pos -= 2;
-                    statements.emplace_back(parse_statement());
+                    listener.parsed(parse_statement());
                 }
 
                 break;
@@ -60,12 +103,12 @@ namespace riddle
                 if (match(LPAREN))
                 { // method declaration..
                     pos = c_pos;
-                    methods.emplace_back(parse_method_declaration());
+                    listener.parsed(parse_method_declaration());
                 }
                 else
                 { // statement..
                     pos = c_pos;
-                    statements.emplace_back(parse_statement());
+                    listener.parsed(parse_statement());
                 }
                 break;
             }
@@ -78,14 +121,13 @@ namespace riddle
             case Real:
             case String:
             { // statement..
-                statements.emplace_back(parse_statement());
+                listener.parsed(parse_statement());
                 break;
             }
             default:
                 error("Unexpected token");
             }
         }
-        return std::make_unique<compilation_unit>(std::move(types), std::move(methods), std::move(predicates), std::move(statements));
     }
 
     std::unique_ptr<enum_declaration> parser::parse_enum_declaration()
@@ -95,13 +137,13 @@ namespace riddle
         if (!match(ID))
             error("Expected identifier after `enum` keyword");
 
-        id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+        auto id = id_at(pos - 1);
         std::vector<string_token> values;             // the values of the enum..
         std::vector<std::vector<id_token>> enum_refs; // the enum references..
 
         do
         {
-            switch (tokens.at(pos++)->sym)
+            switch (tokens.at(pos++).sym)
             {
             case LBRACE:
                 if (!match(RBRACE))
@@ -110,7 +152,7 @@ namespace riddle
                     {
                         if (!match(String))
                             error("Expected string literal");
-                        values.emplace_back(std::string(static_cast<const string_token &>(*tokens.at(pos - 1)).value), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                        values.emplace_back(string_at(pos - 1));
                     } while (match(COMMA));
                     if (!match(RBRACE))
                         error("Expected `}` after string literals");
@@ -119,12 +161,12 @@ namespace riddle
             case ID:
             {
                 std::vector<id_token> refs;
-                refs.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                refs.emplace_back(id_at(pos - 1));
                 while (match(DOT))
                 {
                     if (!match(ID))
                         error("Expected identifier after `.`");
-                    refs.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    refs.emplace_back(id_at(pos - 1));
                 }
                 enum_refs.emplace_back(std::move(refs));
                 break;
@@ -137,7 +179,7 @@ namespace riddle
         if (!match(SEMICOLON))
             error("Expected `;` after enum declaration");
 
-        return std::make_unique<enum_declaration>(std::move(id), std::move(values), std::move(enum_refs));
+        return make_node<enum_declaration>(std::move(id), std::move(values), std::move(enum_refs));
     }
 
     std::unique_ptr<class_declaration> parser::parse_class_declaration()
@@ -155,7 +197,7 @@ namespace riddle
         if (!match(ID))
             error("Expected identifier after `class` keyword");
 
-        id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+        auto id = id_at(pos - 1);
 
         if (match(COLON))
             do
@@ -165,7 +207,7 @@ namespace riddle
                 {
                     if (!match(ID))
                         error("Expected identifier after `:`");
-                    base_class.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    base_class.emplace_back(id_at(pos - 1));
                 } while (match(DOT));
                 base_classes.emplace_back(std::move(base_class));
             } while (match(COMMA));
@@ -174,7 +216,7 @@ namespace riddle
             error("Expected `{` after class declaration");
 
         while (!match(RBRACE))
-            switch (tokens.at(pos++)->sym)
+            switch (tokens.at(pos++).sym)
             {
             case BOOL:
             case INT:
@@ -248,9 +290,9 @@ namespace riddle
             error("Expected `;` after class declaration");
 
         if (constructors.empty()) // default constructor..
-            constructors.emplace_back(std::make_unique<constructor_declaration>(std::vector<std::pair<std::vector<id_token>, id_token>>(), std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>>(), std::vector<std::unique_ptr<statement>>()));
+            constructors.emplace_back(make_node<constructor_declaration>(std::vector<std::pair<std::vector<id_token>, id_token>>(), std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>>(), std::vector<std::unique_ptr<statement>>()));
 
-        return std::make_unique<class_declaration>(std::move(id), std::move(base_classes), std::move(fields), std::move(constructors), std::move(methods), std::move(predicates), std::move(types));
+        return make_node<class_declaration>(std::move(id), std::move(base_classes), std::move(fields), std::move(constructors), std::move(methods), std::move(predicates), std::move(types));
     }
 
     std::unique_ptr<field_declaration> parser::parse_field_declaration()
@@ -258,31 +300,31 @@ namespace riddle
         std::vector<id_token> tp;
         std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-        switch (tokens.at(pos++)->sym)
+        switch (tokens.at(pos++).sym)
         {
         case BOOL:
-            tp.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(kw_at(pos - 1, bool_kw));
             break;
         case INT:
-            tp.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(kw_at(pos - 1, int_kw));
             break;
         case REAL:
-            tp.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(kw_at(pos - 1, real_kw));
             break;
         case TIME:
-            tp.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(kw_at(pos - 1, time_kw));
             break;
         case STRING:
-            tp.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(kw_at(pos - 1, string_kw));
             break;
         case ID:
         {
-            tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            tp.emplace_back(id_at(pos - 1));
             while (match(DOT))
             {
                 if (!match(ID))
                     error("Expected identifier after `.`");
-                tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                tp.emplace_back(id_at(pos - 1));
             }
             break;
         }
@@ -295,7 +337,7 @@ namespace riddle
             if (!match(ID))
                 error("Expected identifier");
 
-            id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            auto id = id_at(pos - 1);
 
             if (match(EQ))
                 fields.emplace_back(std::move(id), parse_expression());
@@ -314,8 +356,8 @@ namespace riddle
                 std::vector<id_token> f_tp;
                 f_tp.reserve(tp.size());
                 for (const auto &t : tp)
-                    f_tp.emplace_back(std::string(t.id), t.line, t.start_pos, t.end_pos);
-                fields.emplace_back(std::move(id), std::make_unique<constructor_expression>(std::move(f_tp), std::move(args)));
+                    f_tp.emplace_back(t.id, t.line, t.start_pos, t.end_pos);
+                fields.emplace_back(std::move(id), make_node<constructor_expression>(std::move(f_tp), std::move(args)));
             }
             else
                 fields.emplace_back(std::move(id), nullptr);
@@ -324,7 +366,7 @@ namespace riddle
         if (!match(SEMICOLON))
             error("Expected `;` after field declaration");
 
-        return std::make_unique<field_declaration>(std::move(tp), std::move(fields));
+        return make_node<field_declaration>(std::move(tp), std::move(fields));
     }
 
     std::unique_ptr<method_declaration> parser::parse_method_declaration()
@@ -333,33 +375,33 @@ namespace riddle
         std::vector<std::pair<std::vector<id_token>, id_token>> params;
         std::vector<std::unique_ptr<statement>> stmts;
 
-        switch (tokens.at(pos++)->sym)
+        switch (tokens.at(pos++).sym)
         {
         case VOID:
             break;
         case BOOL:
-            rt.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(kw_at(pos - 1, bool_kw));
             break;
         case INT:
-            rt.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(kw_at(pos - 1, int_kw));
             break;
         case REAL:
-            rt.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(kw_at(pos - 1, real_kw));
             break;
         case TIME:
-            rt.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(kw_at(pos - 1, time_kw));
             break;
         case STRING:
-            rt.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(kw_at(pos - 1, string_kw));
             break;
         case ID:
         {
-            rt.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            rt.emplace_back(id_at(pos - 1));
             while (match(DOT))
             {
                 if (!match(ID))
                     error("Expected identifier after `.`");
-                rt.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                rt.emplace_back(id_at(pos - 1));
             }
             break;
         }
@@ -370,7 +412,7 @@ namespace riddle
         if (!match(ID)) // method name..
             error("Expected identifier");
 
-        id_token name(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+        auto name = id_at(pos - 1);
 
         if (!match(LPAREN))
             error("Expected `(` after method name");
@@ -380,31 +422,31 @@ namespace riddle
             do
             {
                 std::vector<id_token> tp;
-                switch (tokens.at(pos++)->sym)
+                switch (tokens.at(pos++).sym)
                 {
                 case BOOL:
-                    tp.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, bool_kw));
                     break;
                 case INT:
-                    tp.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, int_kw));
                     break;
                 case REAL:
-                    tp.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, real_kw));
                     break;
                 case TIME:
-                    tp.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, time_kw));
                     break;
                 case STRING:
-                    tp.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, string_kw));
                     break;
                 case ID:
                 {
-                    tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(id_at(pos - 1));
                     while (match(DOT))
                     {
                         if (!match(ID))
                             error("Expected identifier after `.`");
-                        tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                        tp.emplace_back(id_at(pos - 1));
                     }
                     break;
                 }
@@ -414,7 +456,7 @@ namespace riddle
 
                 if (!match(ID))
                     error("Expected identifier");
-                params.emplace_back(std::move(tp), id_token(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
+                params.emplace_back(std::move(tp), id_at(pos - 1));
             } while (match(COMMA));
 
             if (!match(RPAREN))
@@ -427,7 +469,7 @@ namespace riddle
         while (!match(RBRACE))
             stmts.emplace_back(parse_statement());
 
-        return std::make_unique<method_declaration>(std::move(rt), std::move(name), std::move(params), std::move(stmts));
+        return make_node<method_declaration>(std::move(rt), std::move(name), std::move(params), std::move(stmts));
     }
 
     std::unique_ptr<constructor_declaration> parser::parse_constructor_declaration()
@@ -447,31 +489,31 @@ namespace riddle
             do
             {
                 std::vector<id_token> tp;
-                switch (tokens.at(pos++)->sym)
+                switch (tokens.at(pos++).sym)
                 {
                 case BOOL:
-                    tp.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, bool_kw));
                     break;
                 case INT:
-                    tp.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, int_kw));
                     break;
                 case REAL:
-                    tp.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, real_kw));
                     break;
                 case TIME:
-                    tp.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, time_kw));
                     break;
                 case STRING:
-                    tp.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, string_kw));
                     break;
                 case ID:
                 {
-                    tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(id_at(pos - 1));
                     while (match(DOT))
                     {
                         if (!match(ID))
                             error("Expected identifier after `.`");
-                        tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                        tp.emplace_back(id_at(pos - 1));
                     }
                     break;
                 }
@@ -481,7 +523,7 @@ namespace riddle
 
                 if (!match(ID))
                     error("Expected identifier");
-                params.emplace_back(std::move(tp), id_token(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
+                params.emplace_back(std::move(tp), id_at(pos - 1));
             } while (match(COMMA));
 
             if (!match(RPAREN))
@@ -494,7 +536,7 @@ namespace riddle
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (!match(LPAREN))
                     error("Expected `(` after identifier");
@@ -519,7 +561,7 @@ namespace riddle
         while (!match(RBRACE))
             stmts.emplace_back(parse_statement());
 
-        return std::make_unique<constructor_declaration>(std::move(params), std::move(inits), std::move(stmts));
+        return make_node<constructor_declaration>(std::move(params), std::move(inits), std::move(stmts));
     }
 
     std::unique_ptr<predicate_declaration> parser::parse_predicate_declaration()
@@ -530,7 +572,7 @@ namespace riddle
         if (!match(ID)) // predicate name..
             error("Expected identifier after `predicate` keyword");
 
-        id_token name(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+        auto name = id_at(pos - 1);
         std::vector<std::pair<std::vector<id_token>, id_token>> params;
         std::vector<std::vector<id_token>> base_predicates;
         std::vector<std::unique_ptr<statement>> body;
@@ -543,31 +585,31 @@ namespace riddle
             do
             {
                 std::vector<id_token> tp;
-                switch (tokens.at(pos++)->sym)
+                switch (tokens.at(pos++).sym)
                 {
                 case BOOL:
-                    tp.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, bool_kw));
                     break;
                 case INT:
-                    tp.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, int_kw));
                     break;
                 case REAL:
-                    tp.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, real_kw));
                     break;
                 case TIME:
-                    tp.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, time_kw));
                     break;
                 case STRING:
-                    tp.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(kw_at(pos - 1, string_kw));
                     break;
                 case ID:
                 {
-                    tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    tp.emplace_back(id_at(pos - 1));
                     while (match(DOT))
                     {
                         if (!match(ID))
                             error("Expected identifier after `.`");
-                        tp.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                        tp.emplace_back(id_at(pos - 1));
                     }
                     break;
                 }
@@ -577,7 +619,7 @@ namespace riddle
 
                 if (!match(ID))
                     error("Expected identifier");
-                params.emplace_back(std::move(tp), id_token(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
+                params.emplace_back(std::move(tp), id_at(pos - 1));
             } while (match(COMMA));
 
             if (!match(RPAREN))
@@ -592,7 +634,7 @@ namespace riddle
                 {
                     if (!match(ID))
                         error("Expected identifier");
-                    base_predicate.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    base_predicate.emplace_back(id_at(pos - 1));
                 } while (match(DOT));
                 base_predicates.emplace_back(std::move(base_predicate));
             } while (match(COMMA));
@@ -603,26 +645,26 @@ namespace riddle
         while (!match(RBRACE))
             body.emplace_back(parse_statement());
 
-        return std::make_unique<predicate_declaration>(std::move(name), std::move(params), std::move(base_predicates), std::move(body));
+        return make_node<predicate_declaration>(std::move(name), std::move(params), std::move(base_predicates), std::move(body));
     }
 
     std::unique_ptr<statement> parser::parse_statement()
     {
-        switch (tokens.at(pos++)->sym)
+        switch (tokens.at(pos++).sym)
         {
         case BOOL:
         { // a local field having a bool type..
             std::vector<id_token> field_type;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-            field_type.emplace_back(std::string(bool_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            field_type.emplace_back(kw_at(pos - 1, bool_kw));
 
             do
             {
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (match(EQ))
                     fields.emplace_back(std::move(id), parse_expression());
@@ -633,21 +675,21 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after local field declaration");
 
-            return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+            return make_node<local_field_statement>(std::move(field_type), std::move(fields));
         }
         case INT:
         { // a local field having a int type..
             std::vector<id_token> field_type;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-            field_type.emplace_back(std::string(int_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            field_type.emplace_back(kw_at(pos - 1, int_kw));
 
             do
             {
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (match(EQ))
                     fields.emplace_back(std::move(id), parse_expression());
@@ -658,21 +700,21 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after local field declaration");
 
-            return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+            return make_node<local_field_statement>(std::move(field_type), std::move(fields));
         }
         case REAL:
         { // a local field having a real type..
             std::vector<id_token> field_type;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-            field_type.emplace_back(std::string(real_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            field_type.emplace_back(kw_at(pos - 1, real_kw));
 
             do
             {
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (match(EQ))
                     fields.emplace_back(std::move(id), parse_expression());
@@ -683,21 +725,21 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after local field declaration");
 
-            return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+            return make_node<local_field_statement>(std::move(field_type), std::move(fields));
         }
         case TIME:
         { // a local field having a time type..
             std::vector<id_token> field_type;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-            field_type.emplace_back(std::string(time_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            field_type.emplace_back(kw_at(pos - 1, time_kw));
 
             do
             {
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (match(EQ))
                     fields.emplace_back(std::move(id), parse_expression());
@@ -708,21 +750,21 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after local field declaration");
 
-            return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+            return make_node<local_field_statement>(std::move(field_type), std::move(fields));
         }
         case STRING:
         { // a local field having a string type..
             std::vector<id_token> field_type;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> fields;
 
-            field_type.emplace_back(std::string(string_kw), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            field_type.emplace_back(kw_at(pos - 1, string_kw));
 
             do
             {
                 if (!match(ID))
                     error("Expected identifier");
 
-                id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                auto id = id_at(pos - 1);
 
                 if (match(EQ))
                     fields.emplace_back(std::move(id), parse_expression());
@@ -733,7 +775,7 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after local field declaration");
 
-            return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+            return make_node<local_field_statement>(std::move(field_type), std::move(fields));
         }
         case ID:
         { // either a local field, an assignment or an expression..
@@ -742,7 +784,7 @@ namespace riddle
                 if (!match(ID))
                     error("Expected identifier after `.`");
 
-            switch (tokens.at(pos)->sym)
+            switch (tokens.at(pos).sym)
             {
             case ID: // a local field..
             {
@@ -752,11 +794,11 @@ namespace riddle
 
                 if (!match(ID))
                     error("Expected identifier");
-                field_type.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                field_type.emplace_back(id_at(pos - 1));
 
                 while (match(DOT))
                     if (match(ID))
-                        field_type.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                        field_type.emplace_back(id_at(pos - 1));
                     else
                         error("Expected identifier after `.`");
 
@@ -765,7 +807,7 @@ namespace riddle
                     if (!match(ID))
                         error("Expected identifier");
 
-                    id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    auto id = id_at(pos - 1);
 
                     if (match(EQ))
                         fields.emplace_back(std::move(id), parse_expression());
@@ -776,18 +818,18 @@ namespace riddle
                 if (!match(SEMICOLON))
                     error("Expected `;` after local field declaration");
 
-                return std::make_unique<local_field_statement>(std::move(field_type), std::move(fields));
+                return make_node<local_field_statement>(std::move(field_type), std::move(fields));
             }
             case EQ: // an assignment..
             {
                 pos = c_pos - 1;
                 std::vector<id_token> object_id;
-                object_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(c_pos)).id), tokens.at(c_pos)->line, tokens.at(c_pos)->start_pos, tokens.at(c_pos)->end_pos);
+                object_id.emplace_back(id_at(c_pos));
                 while (match(DOT))
                 {
                     if (!match(ID))
                         error("Expected identifier after `.`");
-                    object_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    object_id.emplace_back(id_at(pos - 1));
                 }
 
                 id_token field_id = std::move(object_id.back());
@@ -801,7 +843,7 @@ namespace riddle
                 if (!match(SEMICOLON))
                     error("Expected `;` after assignment");
 
-                return std::make_unique<assignment_statement>(std::move(object_id), std::move(field_id), std::move(xpr));
+                return make_node<assignment_statement>(std::move(object_id), std::move(field_id), std::move(xpr));
             }
             default: // an expression..
                 pos = c_pos - 1;
@@ -810,7 +852,7 @@ namespace riddle
                 if (!match(SEMICOLON))
                     error("Expected `;` after expression");
 
-                return std::make_unique<expression_statement>(std::move(xpr));
+                return make_node<expression_statement>(std::move(xpr));
             }
         }
         case LBRACE:
@@ -827,18 +869,18 @@ namespace riddle
 
                 if (match(LBRACKET))
                 { // a priced conjunction..
-                    conjuncts.emplace_back(std::make_unique<conjunction_statement>(std::move(stmts), parse_expression()));
+                    conjuncts.emplace_back(make_node<conjunction_statement>(std::move(stmts), parse_expression()));
                     if (!match(RBRACKET))
                         error("Expected `]` after priced conjunction");
                 }
                 else // a simple conjunction..
-                    conjuncts.emplace_back(std::make_unique<conjunction_statement>(std::move(stmts)));
+                    conjuncts.emplace_back(make_node<conjunction_statement>(std::move(stmts)));
             } while (match(OR));
 
             if (conjuncts.size() == 1) // a simple conjunction..
                 return std::move(conjuncts.front());
             else // a disjunction..
-                return std::make_unique<disjunction_statement>(std::move(conjuncts));
+                return make_node<disjunction_statement>(std::move(conjuncts));
         }
         case FOR:
         { // a for loop..
@@ -850,13 +892,13 @@ namespace riddle
             {
                 if (!match(ID))
                     error("Expected identifier");
-                enum_type.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                enum_type.emplace_back(id_at(pos - 1));
             } while (match(DOT));
 
             if (!match(ID))
                 error("Expected identifier");
 
-            id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            auto id = id_at(pos - 1);
 
             if (!match(RPAREN))
                 error("Expected `)` after for loop");
@@ -867,26 +909,26 @@ namespace riddle
             while (!match(RBRACE))
                 stmts.emplace_back(parse_statement());
 
-            return std::make_unique<for_all_statement>(std::move(enum_type), std::move(id), std::move(stmts));
+            return make_node<for_all_statement>(std::move(enum_type), std::move(id), std::move(stmts));
         }
         case RETURN:
         { // a return statement..
             auto xpr = parse_expression();
             if (!match(SEMICOLON))
                 error("Expected `;` after return statement");
-            return std::make_unique<return_statement>(std::move(xpr));
+            return make_node<return_statement>(std::move(xpr));
         }
         case FACT:
         case GOAL:
         { // a fact or a goal..
-            bool is_fact = tokens.at(pos - 1)->sym == FACT;
+            bool is_fact = tokens.at(pos - 1).sym == FACT;
             std::vector<id_token> tau;
             std::vector<std::pair<id_token, std::unique_ptr<expression>>> args;
 
             if (!match(ID))
                 error("Expected identifier");
 
-            id_token name(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+            auto name = id_at(pos - 1);
 
             if (!match(EQ))
                 error("Expected `=` after atom name");
@@ -898,7 +940,7 @@ namespace riddle
             {
                 if (!match(ID))
                     error("Expected identifier");
-                tau.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                tau.emplace_back(id_at(pos - 1));
             } while (match(DOT));
 
             auto predicate_name = std::move(tau.back());
@@ -914,7 +956,7 @@ namespace riddle
                     if (!match(ID))
                         error("Expected identifier");
 
-                    id_token id(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
+                    auto id = id_at(pos - 1);
 
                     if (match(COLON))
                         args.emplace_back(std::move(id), parse_expression());
@@ -929,7 +971,7 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after fact or goal");
 
-            return std::make_unique<formula_statement>(is_fact, std::move(name), std::move(tau), std::move(predicate_name), std::move(args));
+            return make_node<formula_statement>(is_fact, std::move(name), std::move(tau), std::move(predicate_name), std::move(args));
         }
         default:
             pos--;
@@ -938,312 +980,369 @@ namespace riddle
             if (!match(SEMICOLON))
                 error("Expected `;` after expression");
 
-            return std::make_unique<expression_statement>(std::move(xpr));
+            return make_node<expression_statement>(std::move(xpr));
         }
     }
 
-    std::unique_ptr<expression> parser::parse_expression(std::size_t precedence)
+    namespace
     {
-        std::unique_ptr<expression> expr;
-        switch (tokens.at(pos++)->sym)
+        /**
+         * @brief Returns the precedence of the given binary operator, or -1 if the symbol is not a binary operator.
+         */
+        constexpr int precedence(symbol sym) noexcept
         {
-        case Bool:
-            expr = std::make_unique<bool_expression>(bool_token(static_cast<const bool_token &>(*tokens.at(pos - 1)).value, tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
-            break;
-        case Int:
-            expr = std::make_unique<int_expression>(int_token(static_cast<const int_token &>(*tokens.at(pos - 1)).value, tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
-            break;
-        case Real:
-            expr = std::make_unique<real_expression>(real_token(utils::rational(static_cast<const real_token &>(*tokens.at(pos - 1)).value), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
-            break;
-        case String:
-            expr = std::make_unique<string_expression>(string_token(std::string(static_cast<const string_token &>(*tokens.at(pos - 1)).value), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos));
-            break;
-        case LBRACKET:
-            switch (tokens.at(pos++)->sym)
-            {
-            case Int:
-                if (!match(COMMA))
-                    error("Expected `,` after int literal");
-                if (!match(Int))
-                    error("Expected int literal after `,`");
-                if (!match(RBRACKET))
-                    error("Expected `]` after int literal");
-                expr = std::make_unique<bounded_int_expression>(int_token(static_cast<const int_token &>(*tokens.at(pos - 4)).value, tokens.at(pos - 4)->line, tokens.at(pos - 4)->start_pos, tokens.at(pos - 4)->end_pos), int_token(static_cast<const int_token &>(*tokens.at(pos - 2)).value, tokens.at(pos - 2)->line, tokens.at(pos - 2)->start_pos, tokens.at(pos - 2)->end_pos));
-                break;
-            case Real:
-                if (!match(COMMA))
-                    error("Expected `,` after real literal");
-                if (!match(Real))
-                    error("Expected real literal after `,`");
-                if (!match(RBRACKET))
-                    error("Expected `]` after real literal");
-                expr = std::make_unique<bounded_real_expression>(real_token(utils::rational(static_cast<const real_token &>(*tokens.at(pos - 4)).value), tokens.at(pos - 4)->line, tokens.at(pos - 4)->start_pos, tokens.at(pos - 4)->end_pos), real_token(utils::rational(static_cast<const real_token &>(*tokens.at(pos - 2)).value), tokens.at(pos - 2)->line, tokens.at(pos - 2)->start_pos, tokens.at(pos - 2)->end_pos));
-                break;
-            default:
-                error("Expected int literal or real literal after `[`");
-            }
-            break;
-        case QUESTION:
-            if (!match(LBRACKET))
-                error("Expected `[` after `?`");
-            switch (tokens.at(pos++)->sym)
+            switch (sym)
             {
-            case Int:
-                if (!match(COMMA))
-                    error("Expected `,` after int literal");
-                if (!match(Int))
-                    error("Expected int literal after `,`");
-                if (!match(RBRACKET))
-                    error("Expected `]` after int literal");
-                expr = std::make_unique<uncertain_int_expression>(int_token(static_cast<const int_token &>(*tokens.at(pos - 4)).value, tokens.at(pos - 4)->line, tokens.at(pos - 4)->start_pos, tokens.at(pos - 4)->end_pos), int_token(static_cast<const int_token &>(*tokens.at(pos - 2)).value, tokens.at(pos - 2)->line, tokens.at(pos - 2)->start_pos, tokens.at(pos - 2)->end_pos));
-                break;
-            case Real:
-                if (!match(COMMA))
-                    error("Expected `,` after real literal");
-                if (!match(Real))
-                    error("Expected real literal after `,`");
-                if (!match(RBRACKET))
-                    error("Expected `]` after real literal");
-                expr = std::make_unique<uncertain_real_expression>(real_token(utils::rational(static_cast<const real_token &>(*tokens.at(pos - 4)).value), tokens.at(pos - 4)->line, tokens.at(pos - 4)->start_pos, tokens.at(pos - 4)->end_pos), real_token(utils::rational(static_cast<const real_token &>(*tokens.at(pos - 2)).value), tokens.at(pos - 2)->line, tokens.at(pos - 2)->start_pos, tokens.at(pos - 2)->end_pos));
-                break;
+            case EQEQ:
+            case BANGEQ:
+                return 0;
+            case IMPLICATION:
+            case BAR:
+            case AMP:
+            case CARET:
+                return 1;
+            case LT:
+            case LTEQ:
+            case GTEQ:
+            case GT:
+                return 2;
+            case PLUS:
+            case MINUS:
+                return 3;
+            case STAR:
+            case SLASH:
+                return 4;
             default:
-                error("Expected int literal or real literal after `[`");
-            }
-            break;
-        case MINUS:
-            expr = std::make_unique<minus_expression>(parse_expression());
-            break;
-        case BANG:
-            expr = std::make_unique<not_expression>(parse_expression());
-            break;
-        case ID:
-        {
-            std::vector<id_token> object_id;
-            object_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            while (match(DOT))
-            {
-                if (!match(ID))
-                    error("Expected identifier after `.`");
-                object_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            }
-            if (match(LPAREN))
-            { // call expression..
-                id_token fn_id = std::move(object_id.back());
-                object_id.pop_back();
-
-                std::vector<std::unique_ptr<expression>> args;
-                if (!match(RPAREN))
-                {
-                    do
-                    {
-                        args.emplace_back(parse_expression());
-                    } while (match(COMMA));
-                    if (!match(RPAREN))
-                        error("Expected `)` after arguments");
-                }
-                expr = std::make_unique<call_expression>(std::move(object_id), std::move(fn_id), std::move(args));
+                return -1;
             }
-            else // id expression..
-                expr = std::make_unique<id_expression>(std::move(object_id));
-            break;
         }
-        case THIS:
-        {
-            std::vector<id_token> object_id;
-            object_id.emplace_back(this_kw, tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            while (match(DOT))
-            {
-                if (!match(ID))
-                    error("Expected identifier after `.`");
-                object_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            }
-            if (match(LPAREN))
-            { // call expression..
-                id_token fn_id = std::move(object_id.back());
-                object_id.pop_back();
 
-                std::vector<std::unique_ptr<expression>> args;
-                if (!match(RPAREN))
-                {
-                    do
-                    {
-                        args.emplace_back(parse_expression());
-                    } while (match(COMMA));
-                    if (!match(RPAREN))
-                        error("Expected `)` after arguments");
-                }
-                expr = std::make_unique<call_expression>(std::move(object_id), std::move(fn_id), std::move(args));
-            }
-            else // id expression..
-                expr = std::make_unique<id_expression>(std::move(object_id));
-            break;
-        }
-        case NEW:
+        /**
+         * @brief Checks whether the given binary operator builds n-ary nodes, so that chains like `a + b + c` become a single node.
+         */
+        constexpr bool is_nary(symbol sym) noexcept { return sym != EQEQ && sym != BANGEQ && sym != IMPLICATION && precedence(sym) != 2; }
+
+        /**
+         * @brief An operator waiting for its right operands.
+         */
+        struct pending_operator
         {
-            std::vector<id_token> type_id;
-            if (!match(ID))
-                error("Expected identifier after `new`");
-            type_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            while (match(DOT))
-            {
-                if (!match(ID))
-                    error("Expected identifier after `.`");
-                type_id.emplace_back(std::string(static_cast<const id_token &>(*tokens.at(pos - 1)).id), tokens.at(pos - 1)->line, tokens.at(pos - 1)->start_pos, tokens.at(pos - 1)->end_pos);
-            }
-            if (!match(LPAREN))
-                error("Expected `(` after type");
-            std::vector<std::unique_ptr<expression>> args;
-            if (!match(RPAREN))
+            symbol sym;   // the operator..
+            size_t first; // the index of the first operand of the operator..
+        };
+
+        /**
+         * @brief The kinds of the contexts an expression can be parsed in.
+         */
+        enum class frame_kind
+        {
+            top,        // the expression being parsed..
+            minus,      // the operand of a unary `-`..
+            negation,   // the operand of a unary `!`..
+            group,      // an expression between parentheses..
+            call,       // the arguments of a method call..
+            constructor // the arguments of a constructor call..
+        };
+
+        /**
+         * @brief The state of an expression being parsed.
+         *
+         * Rather than recursing on nested expressions, the parser pushes a frame for each of them, so that the native stack does not grow with the nesting depth of the source.
+         */
+        struct parse_frame
+        {
+            parse_frame(arena *nodes, frame_kind kind, std::vector<id_token> &&ids = {}) noexcept : nodes(nodes), kind(kind), ids(std::move(ids)) {}
+
+            /**
+             * @brief Builds the node of the topmost pending operator, out of its operands.
+             */
+            void reduce()
             {
-                do
+                const auto op = ops.back();
+                ops.pop_back();
+                std::vector<std::unique_ptr<expression>> xprs(std::make_move_iterator(operands.begin() + op.first), std::make_move_iterator(operands.end()));
+                operands.erase(operands.begin() + op.first, operands.end());
+                std::unique_ptr<expression> xpr;
+                switch (op.sym)
                 {
-                    args.emplace_back(parse_expression());
-                } while (match(COMMA));
-                if (!match(RPAREN))
-                    error("Expected `)` after arguments");
+                case EQEQ:
+                    xpr = make_node<eq_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]));
+                    break;
+                case BANGEQ:
+                    xpr = make_node<not_expression>(nodes, simplify(make_node<eq_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]))));
+                    break;
+                case IMPLICATION:
+                    xprs[0] = simplify(make_node<not_expression>(nodes, std::move(xprs[0])));
+                    xpr = make_node<or_expression>(nodes, std::move(xprs));
+                    break;
+                case BAR:
+                    xpr = make_node<or_expression>(nodes, std::move(xprs));
+                    break;
+                case AMP:
+                    xpr = make_node<and_expression>(nodes, std::move(xprs));
+                    break;
+                case CARET:
+                    xpr = make_node<xor_expression>(nodes, std::move(xprs));
+                    break;
+                case LT:
+                    xpr = make_node<lt_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]));
+                    break;
+                case LTEQ:
+                    xpr = make_node<le_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]));
+                    break;
+                case GTEQ:
+                    xpr = make_node<ge_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]));
+                    break;
+                case GT:
+                    xpr = make_node<gt_expression>(nodes, std::move(xprs[0]), std::move(xprs[1]));
+                    break;
+                case PLUS:
+                    xpr = make_node<sum_expression>(nodes, std::move(xprs));
+                    break;
+                case MINUS:
+                    xpr = make_node<subtraction_expression>(nodes, std::move(xprs));
+                    break;
+                case STAR:
+                    xpr = make_node<product_expression>(nodes, std::move(xprs));
+                    break;
+                case SLASH:
+                    xpr = make_node<division_expression>(nodes, std::move(xprs));
+                    break;
+                default:
+                    assert(false);
+                }
+                operands.emplace_back(simplify(std::move(xpr))); // the operands are simplified already..
             }
-            expr = std::make_unique<constructor_expression>(std::move(type_id), std::move(args));
-            break;
-        }
-        case LPAREN:
-            expr = parse_expression();
-            if (!match(RPAREN))
-                error("Expected `)` after expression");
-            break;
-        default:
-            error("Unexpected token");
-        }
 
-        while (
-            ((tokens.at(pos)->sym == EQEQ || tokens.at(pos)->sym == BANGEQ) && 0 >= precedence) ||
-            ((tokens.at(pos)->sym == IMPLICATION || tokens.at(pos)->sym == BAR || tokens.at(pos)->sym == AMP || tokens.at(pos)->sym == CARET) && 1 >= precedence) ||
-            ((tokens.at(pos)->sym == LT || tokens.at(pos)->sym == LTEQ || tokens.at(pos)->sym == GTEQ || tokens.at(pos)->sym == GT) && 2 >= precedence) ||
-            ((tokens.at(pos)->sym == PLUS || tokens.at(pos)->sym == MINUS) && 3 >= precedence) ||
-            ((tokens.at(pos)->sym == STAR || tokens.at(pos)->sym == SLASH) && 4 >= precedence))
-            switch (tokens.at(pos)->sym)
+            /**
+             * @brief Adds the given binary operator, building the nodes of the pending operators which bind at least as tightly.
+             */
+            void push(symbol sym)
             {
-            case EQEQ:
-                assert(0 >= precedence);
-                pos++; // we parse the `==` operator..
-                expr = std::make_unique<eq_expression>(std::move(expr), parse_expression(1));
-                break;
-            case BANGEQ:
-                assert(0 >= precedence);
-                pos++; // we parse the `!=` operator..
-                expr = std::make_unique<not_expression>(std::make_unique<eq_expression>(std::move(expr), parse_expression(1)));
-                break;
-            case IMPLICATION:
-            {
-                assert(1 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::make_unique<not_expression>(std::move(expr)));
-                pos++; // we parse the `=>` operator..
-                xprs.emplace_back(parse_expression(2));
-                expr = std::make_unique<or_expression>(std::move(xprs));
-                break;
-            }
-            case BAR:
-            {
-                assert(1 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(BAR))
-                    xprs.emplace_back(parse_expression(2));
-                expr = std::make_unique<or_expression>(std::move(xprs));
-                break;
+                const auto p = precedence(sym);
+                while (!ops.empty() && (precedence(ops.back().sym) > p || (precedence(ops.back().sym) == p && (ops.back().sym != sym || !is_nary(sym)))))
+                    reduce();
+                if (ops.empty() || ops.back().sym != sym || !is_nary(sym))
+                    ops.push_back({sym, operands.size() - 1});
+                // otherwise, the next operand is added to the pending n-ary operator..
             }
-            case AMP:
+
+            /**
+             * @brief Builds the nodes of all the pending operators, returning the parsed expression.
+             */
+            std::unique_ptr<expression> finish()
             {
-                assert(1 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(AMP))
-                    xprs.emplace_back(parse_expression(2));
-                expr = std::make_unique<and_expression>(std::move(xprs));
-                break;
+                while (!ops.empty())
+                    reduce();
+                assert(operands.size() == 1);
+                auto xpr = std::move(operands.back());
+                operands.clear();
+                return xpr;
             }
-            case CARET:
+
+            arena *const nodes;                                 // the arena the nodes are allocated from, if any..
+            const frame_kind kind;                              // the kind of the frame..
+            std::vector<std::unique_ptr<expression>> operands;  // the operands which have not been assigned to an operator node yet..
+            std::vector<pending_operator> ops;                  // the operators waiting for their right operands..
+            std::vector<id_token> ids;                          // the identifiers of the called method, or of the constructed type..
+            std::vector<std::unique_ptr<expression>> arguments; // the arguments parsed so far..
+        };
+    } // namespace
+
+    std::unique_ptr<expression> parser::parse_expression()
+    {
+        std::vector<parse_frame> frames;
+        frames.emplace_back(c_nodes, frame_kind::top);
+        while (true)
+        {
+            // we parse an operand..
+            std::unique_ptr<expression> expr;
+            switch (tokens.at(pos++).sym)
             {
-                assert(1 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(CARET))
-                    xprs.emplace_back(parse_expression(2));
-                expr = std::make_unique<xor_expression>(std::move(xprs));
-                break;
-            }
-            case LT:
-                assert(2 >= precedence);
-                pos++; // we parse the `<` operator..
-                expr = std::make_unique<lt_expression>(std::move(expr), parse_expression(3));
+            case Bool:
+                expr = make_node<bool_expression>(bool_at(pos - 1));
                 break;
-            case LTEQ:
-                assert(2 >= precedence);
-                pos++; // we parse the `<=` operator..
-                expr = std::make_unique<le_expression>(std::move(expr), parse_expression(3));
+            case Int:
+                expr = make_node<int_expression>(int_at(pos - 1));
                 break;
-            case GTEQ:
-                assert(2 >= precedence);
-                pos++; // we parse the `>=` operator..
-                expr = std::make_unique<ge_expression>(std::move(expr), parse_expression(3));
+            case Real:
+                expr = make_node<real_expression>(real_at(pos - 1));
                 break;
-            case GT:
-                assert(2 >= precedence);
-                pos++; // we parse the `>` operator..
-                expr = std::make_unique<gt_expression>(std::move(expr), parse_expression(3));
+            case String:
+                expr = make_node<string_expression>(string_at(pos - 1));
                 break;
-            case PLUS:
-            {
-                assert(3 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(PLUS))
-                    xprs.emplace_back(parse_expression(4));
-                expr = std::make_unique<sum_expression>(std::move(xprs));
+            case LBRACKET:
+                switch (tokens.at(pos++).sym)
+                {
+                case Int:
+                    if (!match(COMMA))
+                        error("Expected `,` after int literal");
+                    if (!match(Int))
+                        error("Expected int literal after `,`");
+                    if (!match(RBRACKET))
+                        error("Expected `]` after int literal");
+                    expr = make_node<bounded_int_expression>(int_at(pos - 4), int_at(pos - 2));
+                    break;
+                case Real:
+                    if (!match(COMMA))
+                        error("Expected `,` after real literal");
+                    if (!match(Real))
+                        error("Expected real literal after `,`");
+                    if (!match(RBRACKET))
+                        error("Expected `]` after real literal");
+                    expr = make_node<bounded_real_expression>(real_at(pos - 4), real_at(pos - 2));
+                    break;
+                default:
+                    error("Expected int literal or real literal after `[`");
+                }
                 break;
-            }
-            case MINUS:
-            {
-                assert(3 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(MINUS))
-                    xprs.emplace_back(parse_expression(4));
-                expr = std::make_unique<subtraction_expression>(std::move(xprs));
+            case QUESTION:
+                if (!match(LBRACKET))
+                    error("Expected `[` after `?`");
+                switch (tokens.at(pos++).sym)
+                {
+                case Int:
+                    if (!match(COMMA))
+                        error("Expected `,` after int literal");
+                    if (!match(Int))
+                        error("Expected int literal after `,`");
+                    if (!match(RBRACKET))
+                        error("Expected `]` after int literal");
+                    expr = make_node<uncertain_int_expression>(int_at(pos - 4), int_at(pos - 2));
+                    break;
+                case Real:
+                    if (!match(COMMA))
+                        error("Expected `,` after real literal");
+                    if (!match(Real))
+                        error("Expected real literal after `,`");
+                    if (!match(RBRACKET))
+                        error("Expected `]` after real literal");
+                    expr = make_node<uncertain_real_expression>(real_at(pos - 4), real_at(pos - 2));
+                    break;
+                default:
+                    error("Expected int literal or real literal after `[`");
+                }
                 break;
-            }
-            case STAR:
+            case MINUS: // the operand extends up to the end of the enclosing expression..
+                frames.emplace_back(c_nodes, frame_kind::minus);
+                continue;
+            case BANG: // the operand extends up to the end of the enclosing expression..
+                frames.emplace_back(c_nodes, frame_kind::negation);
+                continue;
+            case LPAREN:
+                frames.emplace_back(c_nodes, frame_kind::group);
+                continue;
+            case ID:
+            case THIS:
             {
-                assert(4 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(STAR))
-                    xprs.emplace_back(parse_expression(5));
-                expr = std::make_unique<product_expression>(std::move(xprs));
+                std::vector<id_token> object_id;
+                object_id.emplace_back(tokens.at(pos - 1).sym == THIS ? kw_at(pos - 1, this_kw) : id_at(pos - 1));
+                while (match(DOT))
+                {
+                    if (!match(ID))
+                        error("Expected identifier after `.`");
+                    object_id.emplace_back(id_at(pos - 1));
+                }
+                if (!match(LPAREN)) // id expression..
+                    expr = make_node<id_expression>(std::move(object_id));
+                else if (match(RPAREN))
+                { // call expression without arguments..
+                    id_token fn_id = std::move(object_id.back());
+                    object_id.pop_back();
+                    expr = make_node<call_expression>(std::move(object_id), std::move(fn_id), std::vector<std::unique_ptr<expression>>());
+                }
+                else
+                { // call expression, we parse the arguments..
+                    frames.emplace_back(c_nodes, frame_kind::call, std::move(object_id));
+                    continue;
+                }
                 break;
             }
-            case SLASH:
+            case NEW:
             {
-                assert(4 >= precedence);
-                std::vector<std::unique_ptr<expression>> xprs;
-                xprs.emplace_back(std::move(expr));
-                while (match(SLASH))
-                    xprs.emplace_back(parse_expression(5));
-                expr = std::make_unique<division_expression>(std::move(xprs));
+                std::vector<id_token> type_id;
+                if (!match(ID))
+                    error("Expected identifier after `new`");
+                type_id.emplace_back(id_at(pos - 1));
+                while (match(DOT))
+                {
+                    if (!match(ID))
+                        error("Expected identifier after `.`");
+                    type_id.emplace_back(id_at(pos - 1));
+                }
+                if (!match(LPAREN))
+                    error("Expected `(` after type");
+                if (match(RPAREN)) // constructor call without arguments..
+                    expr = make_node<constructor_expression>(std::move(type_id), std::vector<std::unique_ptr<expression>>());
+                else
+                { // constructor call, we parse the arguments..
+                    frames.emplace_back(c_nodes, frame_kind::constructor, std::move(type_id));
+                    continue;
+                }
                 break;
             }
-            break;
             default:
                 error("Unexpected token");
             }
+            frames.back().operands.emplace_back(std::move(expr));
+
+            // we parse the operator following the operand, closing the frames which end here..
+            while (true)
+            {
+                auto &f = frames.back();
+                if (const auto sym = tokens.at(pos).sym; precedence(sym) >= 0)
+                { // a binary operator, followed by another operand..
+                    pos++;
+                    f.push(sym);
+                    break;
+                }
 
-        return expr;
+                auto xpr = f.finish();
+                switch (f.kind)
+                {
+                case frame_kind::top:
+                    return xpr;
+                case frame_kind::minus:
+                    frames.pop_back();
+                    frames.back().operands.emplace_back(simplify(make_node<minus_expression>(std::move(xpr))));
+                    continue;
+                case frame_kind::negation:
+                    frames.pop_back();
+                    frames.back().operands.emplace_back(simplify(make_node<not_expression>(std::move(xpr))));
+                    continue;
+                case frame_kind::group:
+                    if (!match(RPAREN))
+                        error("Expected `)` after expression");
+                    frames.pop_back();
+                    frames.back().operands.emplace_back(std::move(xpr));
+                    continue;
+                case frame_kind::call:
+                case frame_kind::constructor:
+                    f.arguments.emplace_back(std::move(xpr));
+                    if (match(COMMA))
+                        break; // we parse the next argument..
+                    if (!match(RPAREN))
+                        error("Expected `)` after arguments");
+                    if (f.kind == frame_kind::call)
+                    {
+                        id_token fn_id = std::move(f.ids.back());
+                        f.ids.pop_back();
+                        xpr = make_node<call_expression>(std::move(f.ids), std::move(fn_id), std::move(f.arguments));
+                    }
+                    else
+                        xpr = make_node<constructor_expression>(std::move(f.ids), std::move(f.arguments));
+                    frames.pop_back();
+                    frames.back().operands.emplace_back(std::move(xpr));
+                    continue;
+                }
+                break;
+            }
+        }
     }
 
     bool parser::match(const symbol &sym)
     {
-        if (tokens.at(pos)->sym == sym)
+        if (tokens.at(pos).sym == sym)
         {
             pos++;
             return true;
@@ -1251,5 +1350,40 @@ namespace riddle
         return false;
     }
 
-    void parser::error(std::string &&err) { throw std::invalid_argument("[" + std::to_string(tokens.at(pos)->line) + ":" + std::to_string(tokens.at(pos)->start_pos) + "] " + std::move(err)); }
+    id_token parser::id_at(size_t p)
+    {
+        const auto &tk = tokens.at(p);
+        return id_token(tokens.get_id(tk), tk.line, tk.start_pos, tk.end_pos);
+    }
+    id_token parser::kw_at(size_t p, const char *kw)
+    {
+        const auto &tk = tokens.at(p);
+        return id_token(symbols.intern(kw), tk.line, tk.start_pos, tk.end_pos);
+    }
+    bool_token parser::bool_at(size_t p)
+    {
+        const auto &tk = tokens.at(p);
+        return bool_token(tokens.get_bool(tk), tk.line, tk.start_pos, tk.end_pos);
+    }
+    int_token parser::int_at(size_t p)
+    {
+        const auto &tk = tokens.at(p);
+        return int_token(tokens.get_int(tk), tk.line, tk.start_pos, tk.end_pos);
+    }
+    real_token parser::real_at(size_t p)
+    {
+        const auto &tk = tokens.at(p);
+        return real_token(tokens.take_real(tk), tk.line, tk.start_pos, tk.end_pos); // each literal is reduced once, so that it can be moved into the node..
+    }
+    string_token parser::string_at(size_t p)
+    {
+        const auto &tk = tokens.at(p);
+        return string_token(std::string(tokens.get_string(tk)), tk.line, tk.start_pos, tk.end_pos);
+    }
+
+    void parser::error(std::string &&err)
+    {
+        const auto &tk = tokens.at(std::min(pos, tokens.size() - 1));
+        throw std::invalid_argument("[" + std::to_string(tk.line) + ":" + std::to_string(tk.start_pos) + "] " + std::move(err));
+    }
 } // namespace riddle
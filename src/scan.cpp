@@ -0,0 +1,207 @@
+#include "scan.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RIDDLE_SCAN_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define RIDDLE_SCAN_AVX2
+#define RIDDLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace riddle::scan
+{
+    static const char *scalar_skip_spaces(const char *p, const char *end) noexcept
+    {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            ++p;
+        return p;
+    }
+    static const char *scalar_skip_id(const char *p, const char *end) noexcept
+    {
+        while (p != end && is_id_char(*p))
+            ++p;
+        return p;
+    }
+    static const char *scalar_find(const char *p, const char *end, char c) noexcept
+    {
+        while (p != end && *p != c)
+            ++p;
+        return p;
+    }
+    static const char *scalar_find_either(const char *p, const char *end, char c0, char c1) noexcept
+    {
+        while (p != end && *p != c0 && *p != c1)
+            ++p;
+        return p;
+    }
+
+#ifdef RIDDLE_SCAN_SSE2
+    static inline unsigned first_bit(unsigned mask) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return static_cast<unsigned>(idx);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    static const char *sse2_skip_spaces(const char *p, const char *end) noexcept
+    {
+        const auto sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), cr = _mm_set1_epi8('\r');
+        for (; end - p >= 16; p += 16)
+        {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const auto m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)), _mm_cmpeq_epi8(v, cr));
+            if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(m)) ^ 0xFFFFu)
+                return p + first_bit(mask);
+        }
+        return scalar_skip_spaces(p, end);
+    }
+    static const char *sse2_skip_id(const char *p, const char *end) noexcept
+    {
+        const auto case_bit = _mm_set1_epi8(0x20), a = _mm_set1_epi8('a' - 1), z = _mm_set1_epi8('z' + 1), d0 = _mm_set1_epi8('0' - 1), d9 = _mm_set1_epi8('9' + 1), us = _mm_set1_epi8('_');
+        for (; end - p >= 16; p += 16)
+        {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const auto lower = _mm_or_si128(v, case_bit); // letters are folded to lowercase..
+            const auto alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, a), _mm_cmplt_epi8(lower, z));
+            const auto digit = _mm_and_si128(_mm_cmpgt_epi8(v, d0), _mm_cmplt_epi8(v, d9));
+            // non-ASCII characters have their sign bit set, so they are part of the mask through `v` itself..
+            const auto m = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_or_si128(_mm_cmpeq_epi8(v, us), v));
+            if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(m)) ^ 0xFFFFu)
+                return p + first_bit(mask);
+        }
+        return scalar_skip_id(p, end);
+    }
+    static const char *sse2_find(const char *p, const char *end, char c) noexcept
+    {
+        const auto vc = _mm_set1_epi8(c);
+        for (; end - p >= 16; p += 16)
+            if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), vc))))
+                return p + first_bit(mask);
+        return scalar_find(p, end, c);
+    }
+    static const char *sse2_find_either(const char *p, const char *end, char c0, char c1) noexcept
+    {
+        const auto vc0 = _mm_set1_epi8(c0), vc1 = _mm_set1_epi8(c1);
+        for (; end - p >= 16; p += 16)
+        {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, vc0), _mm_cmpeq_epi8(v, vc1)))))
+                return p + first_bit(mask);
+        }
+        return scalar_find_either(p, end, c0, c1);
+    }
+#endif
+
+#ifdef RIDDLE_SCAN_AVX2
+    RIDDLE_TARGET_AVX2 static const char *avx2_skip_spaces(const char *p, const char *end) noexcept
+    {
+        const auto sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t'), cr = _mm256_set1_epi8('\r');
+        for (; end - p >= 32; p += 32)
+        {
+            const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const auto m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)), _mm256_cmpeq_epi8(v, cr));
+            if (const auto mask = ~static_cast<unsigned>(_mm256_movemask_epi8(m)))
+                return p + first_bit(mask);
+        }
+        return sse2_skip_spaces(p, end);
+    }
+    RIDDLE_TARGET_AVX2 static const char *avx2_skip_id(const char *p, const char *end) noexcept
+    {
+        const auto case_bit = _mm256_set1_epi8(0x20), a = _mm256_set1_epi8('a' - 1), z = _mm256_set1_epi8('z' + 1), d0 = _mm256_set1_epi8('0' - 1), d9 = _mm256_set1_epi8('9' + 1), us = _mm256_set1_epi8('_');
+        for (; end - p >= 32; p += 32)
+        {
+            const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const auto lower = _mm256_or_si256(v, case_bit); // letters are folded to lowercase..
+            const auto alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, a), _mm256_cmpgt_epi8(z, lower));
+            const auto digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, d0), _mm256_cmpgt_epi8(d9, v));
+            // non-ASCII characters have their sign bit set, so they are part of the mask through `v` itself..
+            const auto m = _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_or_si256(_mm256_cmpeq_epi8(v, us), v));
+            if (const auto mask = ~static_cast<unsigned>(_mm256_movemask_epi8(m)))
+                return p + first_bit(mask);
+        }
+        return sse2_skip_id(p, end);
+    }
+    RIDDLE_TARGET_AVX2 static const char *avx2_find(const char *p, const char *end, char c) noexcept
+    {
+        const auto vc = _mm256_set1_epi8(c);
+        for (; end - p >= 32; p += 32)
+            if (const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), vc))))
+                return p + first_bit(mask);
+        return sse2_find(p, end, c);
+    }
+    RIDDLE_TARGET_AVX2 static const char *avx2_find_either(const char *p, const char *end, char c0, char c1) noexcept
+    {
+        const auto vc0 = _mm256_set1_epi8(c0), vc1 = _mm256_set1_epi8(c1);
+        for (; end - p >= 32; p += 32)
+        {
+            const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            if (const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, vc0), _mm256_cmpeq_epi8(v, vc1)))))
+                return p + first_bit(mask);
+        }
+        return sse2_find_either(p, end, c0, c1);
+    }
+#endif
+
+    /**
+     * @brief The implementations of the scanning primitives for a given instruction set.
+     */
+    struct primitives
+    {
+        isa set;
+        const char *(*skip_spaces)(const char *, const char *) noexcept;
+        const char *(*skip_id)(const char *, const char *) noexcept;
+        const char *(*find)(const char *, const char *, char) noexcept;
+        const char *(*find_either)(const char *, const char *, char, char) noexcept;
+    };
+
+    static primitives primitives_for(isa set) noexcept
+    {
+        switch (set)
+        {
+#ifdef RIDDLE_SCAN_AVX2
+        case isa::avx2:
+            return {isa::avx2, avx2_skip_spaces, avx2_skip_id, avx2_find, avx2_find_either};
+#endif
+#ifdef RIDDLE_SCAN_SSE2
+        case isa::sse2:
+            return {isa::sse2, sse2_skip_spaces, sse2_skip_id, sse2_find, sse2_find_either};
+#endif
+        default:
+            return {isa::scalar, scalar_skip_spaces, scalar_skip_id, scalar_find, scalar_find_either};
+        }
+    }
+
+    static primitives &selected() noexcept
+    {
+        static primitives prims = primitives_for(supported());
+        return prims;
+    }
+
+    isa supported() noexcept
+    {
+#ifdef RIDDLE_SCAN_AVX2
+        if (__builtin_cpu_supports("avx2"))
+            return isa::avx2;
+#endif
+#ifdef RIDDLE_SCAN_SSE2
+        return isa::sse2;
+#else
+        return isa::scalar;
+#endif
+    }
+    isa current() noexcept { return selected().set; }
+    void use(isa set) noexcept { selected() = primitives_for(set <= supported() ? set : supported()); }
+
+    const char *skip_spaces(const char *p, const char *end) noexcept { return selected().skip_spaces(p, end); }
+    const char *skip_id(const char *p, const char *end) noexcept { return selected().skip_id(p, end); }
+    const char *find(const char *p, const char *end, char c) noexcept { return selected().find(p, end, c); }
+    const char *find_either(const char *p, const char *end, char c0, char c1) noexcept { return selected().find_either(p, end, c0, c1); }
+} // namespace riddle::scan
@@ -0,0 +1,310 @@
+#include "expression.hpp"
+#include <algorithm>
+
+namespace riddle
+{
+    /**
+     * @brief Returns whether the given bounds are those of a constant.
+     */
+    static bool is_constant(const literal_bounds &b) noexcept { return b.lb == b.ub; }
+    /**
+     * @brief Returns whether the given bounds are those of the given constant.
+     */
+    static bool is_constant(const literal_bounds &b, const utils::rational &val) noexcept { return b.lb == val && b.ub == val; }
+    /**
+     * @brief Returns whether the given bounds are those of the given identity, which can be dropped without turning a real expression into an integer one.
+     */
+    static bool is_identity(const literal_bounds &b, const utils::rational &val) noexcept { return b.is_int && is_constant(b, val); }
+
+    /**
+     * @brief Returns the bounds of the sum of two values having the given bounds.
+     */
+    static literal_bounds add(const literal_bounds &l, const literal_bounds &r) { return {l.lb + r.lb, l.ub + r.ub, l.is_int && r.is_int}; }
+    /**
+     * @brief Returns the bounds of the opposite of a value having the given bounds.
+     */
+    static literal_bounds negate(const literal_bounds &b) { return {-b.ub, -b.lb, b.is_int}; }
+    /**
+     * @brief Returns the bounds of the product of a value having the given bounds and the given constant.
+     */
+    static literal_bounds scale(const literal_bounds &b, const utils::rational &c, bool is_int)
+    {
+        if (c < utils::rational::zero)
+            return {b.ub * c, b.lb * c, is_int};
+        return {b.lb * c, b.ub * c, is_int};
+    }
+
+    /**
+     * @brief Creates the literal evaluating to the values having the given bounds.
+     */
+    static std::unique_ptr<expression> make_literal(const literal_bounds &b)
+    {
+        if (b.is_int)
+        {
+            if (is_constant(b))
+                return std::make_unique<int_expression>(int_token(b.lb.numerator(), 0, 0, 0));
+            return std::make_unique<bounded_int_expression>(int_token(b.lb.numerator(), 0, 0, 0), int_token(b.ub.numerator(), 0, 0, 0));
+        }
+        if (is_constant(b))
+            return std::make_unique<real_expression>(real_token(utils::rational(b.lb), 0, 0, 0));
+        return std::make_unique<bounded_real_expression>(real_token(utils::rational(b.lb), 0, 0, 0), real_token(utils::rational(b.ub), 0, 0, 0));
+    }
+    /**
+     * @brief Creates the literal evaluating to the given value.
+     */
+    static std::unique_ptr<expression> make_literal(bool val) { return std::make_unique<bool_expression>(bool_token(val, 0, 0, 0)); }
+
+    /**
+     * @brief Moves the operands of the given operands into the returned vector, replacing the operands which are expressions of the given kind with their own operands.
+     */
+    template <typename Xpr>
+    static std::vector<std::unique_ptr<expression>> flatten(std::vector<std::unique_ptr<expression>> &&xprs, std::vector<std::unique_ptr<expression>> Xpr::*operands)
+    {
+        std::vector<std::unique_ptr<expression>> flat;
+        flat.reserve(xprs.size());
+        for (auto &xpr : xprs)
+            if (auto nested = dynamic_cast<Xpr *>(xpr.get())) // the nested operands are flat already..
+                std::move((nested->*operands).begin(), (nested->*operands).end(), std::back_inserter(flat));
+            else
+                flat.emplace_back(std::move(xpr));
+        return flat;
+    }
+
+    /**
+     * @brief Simplifies the given conjunction or disjunction, dropping its `identity` operands.
+     *
+     * @return The expression replacing the given one, or `nullptr` if the given one is kept.
+     */
+    template <typename Xpr>
+    static std::unique_ptr<expression> simplify_junction(std::vector<std::unique_ptr<expression>> &xprs, std::vector<std::unique_ptr<expression>> Xpr::*operands, bool identity)
+    {
+        auto flat = flatten<Xpr>(std::move(xprs), operands);
+        bool absorbed = false, all_literals = true;
+        std::vector<std::unique_ptr<expression>> args;
+        for (auto &xpr : flat)
+            if (const auto val = xpr->get_truth(); val && *val == identity)
+                continue; // the identity does not change the value of the expression..
+            else
+            {
+                absorbed |= val.has_value();
+                all_literals &= val.has_value();
+                args.emplace_back(std::move(xpr));
+            }
+        if (absorbed && all_literals)
+            return make_literal(!identity);
+        if (args.empty())
+            return make_literal(identity);
+        if (args.size() == 1)
+            return std::move(args.front());
+        xprs = std::move(args);
+        return nullptr;
+    }
+
+    /**
+     * @brief Simplifies a comparison between the given operands, given whether its truth value is known from the bounds of the operands.
+     *
+     * @param holds Whether the comparison certainly holds between values having the given bounds.
+     * @param fails Whether the comparison certainly fails between values having the given bounds.
+     */
+    template <typename Holds, typename Fails>
+    static std::unique_ptr<expression> simplify_comparison(const expression &lhs, const expression &rhs, Holds holds, Fails fails)
+    {
+        const auto l = lhs.get_bounds(), r = rhs.get_bounds();
+        if (!l || !r)
+            return nullptr;
+        if (holds(*l, *r))
+            return make_literal(true);
+        if (fails(*l, *r))
+            return make_literal(false);
+        return nullptr;
+    }
+
+    std::optional<literal_bounds> int_expression::get_bounds() const { return literal_bounds{l.value, l.value, true}; }
+    std::optional<literal_bounds> bounded_int_expression::get_bounds() const { return literal_bounds{lb.value, ub.value, true}; }
+    std::optional<literal_bounds> real_expression::get_bounds() const { return literal_bounds{l.value, l.value, false}; }
+    std::optional<literal_bounds> bounded_real_expression::get_bounds() const { return literal_bounds{lb.value, ub.value, false}; }
+
+    std::unique_ptr<expression> and_expression::simplify() { return simplify_junction(xprs, &and_expression::xprs, true); }
+    std::unique_ptr<expression> or_expression::simplify() { return simplify_junction(xprs, &or_expression::xprs, false); }
+
+    std::unique_ptr<expression> not_expression::simplify()
+    {
+        if (const auto val = xpr->get_truth())
+            return make_literal(!*val);
+        if (auto nested = dynamic_cast<not_expression *>(xpr.get()))
+            return std::move(nested->xpr);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> minus_expression::simplify()
+    {
+        if (const auto b = xpr->get_bounds())
+            return make_literal(negate(*b));
+        if (auto nested = dynamic_cast<minus_expression *>(xpr.get()))
+            return std::move(nested->xpr);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> sum_expression::simplify()
+    {
+        std::optional<literal_bounds> cst; // the sum of the literal operands..
+        std::vector<std::unique_ptr<expression>> args;
+        for (auto &xpr : flatten<sum_expression>(std::move(xprs), &sum_expression::xprs))
+            if (const auto b = xpr->get_bounds())
+                cst = cst ? add(*cst, *b) : *b;
+            else
+                args.emplace_back(std::move(xpr));
+        if (cst && (args.empty() || !is_identity(*cst, utils::rational::zero)))
+            args.emplace_back(make_literal(*cst));
+        if (args.size() == 1)
+            return std::move(args.front());
+        xprs = std::move(args);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> subtraction_expression::simplify()
+    {
+        auto first = std::move(xprs.front());
+        std::vector<std::unique_ptr<expression>> subtrahends;
+        if (auto nested = dynamic_cast<subtraction_expression *>(first.get()))
+        { // `(a - b) - c` is `a - b - c`..
+            subtrahends.insert(subtrahends.end(), std::make_move_iterator(nested->xprs.begin() + 1), std::make_move_iterator(nested->xprs.end()));
+            first = std::move(nested->xprs.front());
+        }
+        subtrahends.insert(subtrahends.end(), std::make_move_iterator(xprs.begin() + 1), std::make_move_iterator(xprs.end()));
+
+        std::optional<literal_bounds> cst; // the sum of the literal subtrahends..
+        std::vector<std::unique_ptr<expression>> args;
+        for (auto &xpr : subtrahends)
+            if (const auto b = xpr->get_bounds())
+                cst = cst ? add(*cst, *b) : *b;
+            else
+                args.emplace_back(std::move(xpr));
+
+        if (const auto b = first->get_bounds(); b && cst)
+        { // the literal subtrahends are subtracted from the literal minuend..
+            first = make_literal(add(*b, negate(*cst)));
+            cst.reset();
+        }
+        if (cst && !is_identity(*cst, utils::rational::zero))
+            args.emplace_back(make_literal(*cst));
+        if (args.empty())
+            return first;
+        args.insert(args.begin(), std::move(first));
+        xprs = std::move(args);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> product_expression::simplify()
+    {
+        std::optional<literal_bounds> cst; // the product of the constant operands..
+        std::vector<std::unique_ptr<expression>> args;
+        for (auto &xpr : flatten<product_expression>(std::move(xprs), &product_expression::xprs))
+            if (const auto b = xpr->get_bounds(); b && is_constant(*b))
+                cst = cst ? scale(*cst, b->lb, cst->is_int && b->is_int) : *b;
+            else
+                args.emplace_back(std::move(xpr));
+        if (!cst)
+        {
+            xprs = std::move(args);
+            return nullptr;
+        }
+        if (args.empty())
+            return make_literal(*cst);
+        if (is_constant(*cst, utils::rational::zero) && std::all_of(args.begin(), args.end(), [](const auto &xpr)
+                                                                    { return xpr->get_bounds().has_value(); }))
+        { // the bounded literals are multiplied by zero..
+            for (const auto &xpr : args)
+                cst->is_int &= xpr->get_bounds()->is_int;
+            return make_literal(*cst);
+        }
+        if (args.size() == 1)
+            if (const auto b = args.front()->get_bounds())
+            { // a bounded literal scaled by a constant, the integers in the scaled bounds being all reachable only if the constant is `1` or `-1`..
+                const bool is_int = cst->is_int && b->is_int;
+                if (!is_int || is_constant(*cst, utils::rational::one) || is_constant(*cst, -utils::rational::one))
+                    return make_literal(scale(*b, cst->lb, is_int));
+            }
+        if (!is_identity(*cst, utils::rational::one))
+            args.emplace_back(make_literal(*cst));
+        if (args.size() == 1)
+            return std::move(args.front());
+        xprs = std::move(args);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> division_expression::simplify()
+    {
+        auto first = std::move(xprs.front());
+        std::vector<std::unique_ptr<expression>> divisors;
+        if (auto nested = dynamic_cast<division_expression *>(first.get()))
+        { // `(a / b) / c` is `a / b / c`..
+            divisors.insert(divisors.end(), std::make_move_iterator(nested->xprs.begin() + 1), std::make_move_iterator(nested->xprs.end()));
+            first = std::move(nested->xprs.front());
+        }
+        divisors.insert(divisors.end(), std::make_move_iterator(xprs.begin() + 1), std::make_move_iterator(xprs.end()));
+
+        std::optional<literal_bounds> cst; // the product of the constant divisors..
+        std::vector<std::unique_ptr<expression>> args;
+        for (auto &xpr : divisors)
+            if (const auto b = xpr->get_bounds(); b && is_constant(*b))
+                cst = cst ? scale(*cst, b->lb, cst->is_int && b->is_int) : *b;
+            else
+                args.emplace_back(std::move(xpr));
+
+        if (const auto b = first->get_bounds(); b && cst && args.empty() && !is_constant(*cst, utils::rational::zero))
+        { // a literal divided by a constant, folded unless the quotient of integers is not an integer..
+            const bool is_int = cst->is_int && b->is_int;
+            const auto inv = utils::rational::one / cst->lb;
+            if (!is_int || is_constant(*cst, utils::rational::one) || is_constant(*cst, -utils::rational::one) || (is_constant(*b) && (b->lb * inv).denominator() == 1))
+                return make_literal(scale(*b, inv, is_int));
+        }
+        if (cst && !is_identity(*cst, utils::rational::one))
+            args.emplace_back(make_literal(*cst));
+        if (args.empty())
+            return first;
+        args.insert(args.begin(), std::move(first));
+        xprs = std::move(args);
+        return nullptr;
+    }
+
+    std::unique_ptr<expression> lt_expression::simplify()
+    {
+        return simplify_comparison(*lhs, *rhs, [](const auto &l, const auto &r)
+                                   { return l.ub < r.lb; }, [](const auto &l, const auto &r)
+                                   { return l.lb >= r.ub; });
+    }
+    std::unique_ptr<expression> le_expression::simplify()
+    {
+        return simplify_comparison(*lhs, *rhs, [](const auto &l, const auto &r)
+                                   { return l.ub <= r.lb; }, [](const auto &l, const auto &r)
+                                   { return l.lb > r.ub; });
+    }
+    std::unique_ptr<expression> gt_expression::simplify()
+    {
+        return simplify_comparison(*lhs, *rhs, [](const auto &l, const auto &r)
+                                   { return l.lb > r.ub; }, [](const auto &l, const auto &r)
+                                   { return l.ub <= r.lb; });
+    }
+    std::unique_ptr<expression> ge_expression::simplify()
+    {
+        return simplify_comparison(*lhs, *rhs, [](const auto &l, const auto &r)
+                                   { return l.lb >= r.ub; }, [](const auto &l, const auto &r)
+                                   { return l.ub < r.lb; });
+    }
+    std::unique_ptr<expression> eq_expression::simplify()
+    {
+        if (const auto l = lhs->get_truth(), r = rhs->get_truth(); l && r)
+            return make_literal(*l == *r);
+        return simplify_comparison(*lhs, *rhs, [](const auto &l, const auto &r)
+                                   { return is_constant(l) && is_constant(r) && l.lb == r.lb; }, [](const auto &l, const auto &r)
+                                   { return l.ub < r.lb || r.ub < l.lb; });
+    }
+
+    std::unique_ptr<expression> simplify(std::unique_ptr<expression> xpr)
+    {
+        if (auto simplified = xpr->simplify())
+            return simplified;
+        return xpr;
+    }
+} // namespace riddle
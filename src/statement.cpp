@@ -3,64 +3,54 @@
 #include "conjunction.hpp"
 #include "exceptions.hpp"
 #include <queue>
+#include <algorithm>
 #include <cassert>
 
 namespace riddle
 {
     void local_field_statement::execute(const scope &scp, env &ctx) const
     { // create local fields in the current environment
-        auto tp = &scp.get_type(field_type[0].id);
-        for (size_t i = 1; i < field_type.size(); ++i)
-            if (auto ct = dynamic_cast<component_type *>(tp))
-                tp = &ct->get_type(field_type[i].id);
-            else
-                throw std::runtime_error("Invalid type reference");
+        auto tp = &resolve_type(scp, field_type, resolved_type);
 
-        for (auto &[id, xpr] : fields)
+        for (size_t i = 0; i < fields.size(); ++i)
         {
+            auto &[id, xpr] = fields[i];
+            expr val;
             if (xpr)
             { // initialize with an expression
-                auto val = xpr->evaluate(scp, ctx);
-                if (tp->is_assignable_from(val->get_type()))
-                    ctx.items.emplace(id.id, val);
-                else
+                val = xpr->evaluate(scp, ctx);
+                if (!tp->is_assignable_from(val->get_type()))
                     throw std::runtime_error("Invalid assignment");
             }
-            else if (tp->is_primitive()) // initialize with a default value
-                ctx.items.emplace(id.id, tp->new_instance());
-            else if (auto et = dynamic_cast<enum_type *>(tp))
-                ctx.items.emplace(id.id, et->new_instance());
-            else if (auto ct = dynamic_cast<component_type *>(tp))
-                switch (ct->get_instances().size())
-                {
-                case 0: // no instances
-                    throw inconsistency_exception();
-                case 1: // only one instance
-                    ctx.items.emplace(id.id, *ct->get_instances().begin());
-                    break;
-                default:
-                { // multiple instances
-                    std::vector<expr> values;
-                    for (auto &inst : ct->get_instances())
-                        values.emplace_back(inst);
-                    ctx.items.emplace(id.id, ctx.get_core().new_enum(*ct, std::move(values)));
-                }
-                }
             else
-                throw std::runtime_error("Invalid type reference");
+                val = new_local(ctx, *tp);
 
-            if (auto cr = dynamic_cast<core *>(&ctx)) // we have a global field..
+            if (!slots.empty())
+            { // the field is stored in its slot..
+                static_cast<frame &>(ctx)[slots[i]] = std::move(val);
+                continue;
+            }
+            ctx.items.emplace(id.id, std::move(val));
+
+            if (auto cr = dynamic_cast<core *>(&ctx))
+            { // we have a global field..
                 cr->add_field(std::make_unique<field>(*tp, std::string(id.id), nullptr));
+                cr->item_defined(id.id);
+            }
         }
     }
 
     void assignment_statement::execute(const scope &scp, env &ctx) const
     { // assign a value to a field of an object
-        auto obj = ctx.items.find(object_id[0].id);
-        if (obj == ctx.items.end())
+        expr obj;
+        if (slot != unbound_slot)
+            obj = static_cast<frame &>(ctx)[slot];
+        else if (auto it = ctx.items.find(object_id[0].id); it != ctx.items.end())
+            obj = it->second;
+        if (!obj)
             throw std::runtime_error("Object not found");
 
-        auto tp = &obj->second->get_type();
+        auto tp = &obj->get_type();
         for (size_t i = 1; i < object_id.size(); ++i)
             if (auto ct = dynamic_cast<component_type *>(tp))
                 tp = &ct->get_type(object_id[i].id);
@@ -71,7 +61,7 @@ namespace riddle
         {
             auto field = ct->get_field(field_id.id);
             if (field.get_type().is_assignable_from(value->evaluate(scp, ctx)->get_type()))
-                static_cast<component &>(*obj->second).items.emplace(field_id.id, value->evaluate(scp, ctx));
+                static_cast<component &>(*obj).items.emplace(field_id.id, value->evaluate(scp, ctx));
             else
                 throw std::runtime_error("Invalid assignment");
         }
@@ -79,31 +69,20 @@ namespace riddle
             throw std::runtime_error("Invalid type reference");
     }
 
-    void expression_statement::execute(const scope &scp, env &ctx) const
+    void expression_statement::execute(const scope &scp, env &ctx) const { assert_constraint(scp, xpr->evaluate(scp, ctx)); }
+
+    /**
+     * @brief Returns whether any of the given statements might be referred to by the terms they create.
+     */
+    static bool any_referred(const std::vector<std::unique_ptr<statement>> &stmts) noexcept
     {
-        auto val = to_cnf(std::dynamic_pointer_cast<bool_term>(xpr->evaluate(scp, ctx))); // convert the expression to conjunctive normal form..
-        if (auto and_val = std::dynamic_pointer_cast<const and_term>(val))
-            for (auto &arg : and_val->args)
-            { // we assert each clause
-                if (auto or_val = std::dynamic_pointer_cast<const or_term>(arg))
-                {
-                    std::vector<bool_expr> args;
-                    for (auto &val : or_val->args)
-                        args.emplace_back(val);
-                    scp.get_core().new_clause(std::move(args));
-                }
-            }
-        else if (auto or_val = std::dynamic_pointer_cast<const or_term>(val))
-        { // we assert the single clause
-            std::vector<bool_expr> args;
-            for (auto &val : or_val->args)
-                args.emplace_back(val);
-            scp.get_core().new_clause(std::move(args));
-        }
-        else
-            scp.get_core().new_clause({val});
+        return std::any_of(stmts.begin(), stmts.end(), [](const auto &stmt)
+                           { return stmt->is_referred(); });
     }
 
+    bool conjunction_statement::is_referred() const noexcept { return any_referred(stmts); }
+    bool for_all_statement::is_referred() const noexcept { return any_referred(stmts); }
+
     void conjunction_statement::execute(const scope &scp, env &ctx) const
     { // execute a conjunction of statements
         for (auto &stmt : stmts)
@@ -113,7 +92,18 @@ namespace riddle
     void disjunction_statement::execute(const scope &scp, env &ctx) const
     { // execute a disjunction of conjunctions
         std::vector<std::unique_ptr<conjunction>> conjs;
-        std::map<std::string, expr, std::less<>> items;
+        if (bound)
+        { // the frame is copied, so that each conjunction retains the current items..
+            for (auto &conj : blocks)
+            {
+                auto cst = conj->cst ? scp.get_core().arith_value(static_cast<arith_term &>(*conj->cst->evaluate(scp, ctx))).get_rational() : utils::rational::one;
+                conjs.emplace_back(std::make_unique<conjunction>(scp, frame(static_cast<frame &>(ctx)), cst, conj->stmts));
+            }
+            scp.get_core().new_disjunction(std::move(conjs));
+            return;
+        }
+
+        item_map items;
         env *tmp_ctx = &ctx; // find the nearest core, component or atom
         while (!(dynamic_cast<core *>(tmp_ctx) || dynamic_cast<component *>(tmp_ctx) || dynamic_cast<enum_term *>(tmp_ctx) || dynamic_cast<atom_term *>(tmp_ctx)))
         {
@@ -122,7 +112,7 @@ namespace riddle
         }
         for (auto &conj : blocks)
         {
-            env cctx(scp.get_core(), *tmp_ctx);            // we create a new context
+            frame cctx(scp.get_core(), *tmp_ctx);          // we create a new context
             cctx.items.insert(items.begin(), items.end()); // copy the items
             auto cst = conj->cst ? scp.get_core().arith_value(static_cast<arith_term &>(*conj->cst->evaluate(scp, ctx))).get_rational() : utils::rational::one;
             conjs.emplace_back(std::make_unique<conjunction>(scp, std::move(cctx), cst, conj->stmts));
@@ -132,86 +122,218 @@ namespace riddle
 
     void for_all_statement::execute(const scope &scp, env &ctx) const
     { // execute a for-all statement
-        auto tp = &scp.get_type(enum_type[0].id);
-        for (size_t i = 1; i < enum_type.size(); ++i)
-            if (auto ct = dynamic_cast<component_type *>(tp))
-                tp = &ct->get_type(enum_type[i].id);
+        auto &ct = static_cast<component_type &>(resolve_type(scp, enum_type, resolved_type)); // the type has been checked to be a component type..
+        for (auto &inst : ct.get_instances())
+            if (slot != unbound_slot)
+            { // the variable is stored in its slot..
+                static_cast<frame &>(ctx)[slot] = inst;
+                for (auto &stmt : stmts)
+                    stmt->execute(scp, ctx);
+            }
             else
-                throw std::runtime_error("Invalid type reference");
-        if (auto ct = dynamic_cast<component_type *>(tp))
-            for (auto &inst : ct->get_instances())
             {
                 env cctx(scp.get_core(), ctx);
                 cctx.items.emplace(enum_id.id, inst);
                 for (auto &stmt : stmts)
                     stmt->execute(scp, cctx);
             }
-        else
-            throw std::runtime_error("Invalid type reference");
     }
 
     void return_statement::execute(const scope &scp, env &ctx) const
     { // return from a method
-        ctx.items.emplace(return_kw, xpr->evaluate(scp, ctx));
+        auto val = xpr->evaluate(scp, ctx);
+        if (slot == unbound_slot)
+            ctx.items.emplace(return_kw, std::move(val));
+        else if (auto &ret = static_cast<frame &>(ctx)[slot]; !ret) // the first returned value is retained..
+            ret = std::move(val);
     }
 
     void formula_statement::execute(const scope &scp, env &ctx) const
     { // create a new atom
-        std::map<std::string, expr, std::less<>> c_args;
+        item_map c_args;
         for (auto &[id, expr] : args)
             c_args.emplace(id.id, expr->evaluate(scp, ctx));
 
         if (!tau.empty())
         {
-            auto c_tau = ctx.get(tau[0].id);
+            auto c_tau = tau_slot == unbound_slot ? ctx.get(tau[0].id) : static_cast<frame &>(ctx).load(tau_slot);
             for (size_t i = 1; i < tau.size(); ++i)
-                if (auto ct = dynamic_cast<component *>(c_tau.get()))
-                    c_tau = ct->get(tau[i].id);
-                else if (auto c = dynamic_cast<enum_term *>(c_tau.get()))
-                    c_tau = c->get(tau[i].id);
-                else if (auto c = dynamic_cast<atom_term *>(c_tau.get()))
-                    c_tau = c->get(tau[i].id);
-                else
-                    throw std::runtime_error("Invalid type reference");
+                c_tau = get_item(c_tau, tau[i].id);
             c_args.emplace(tau_kw, c_tau);
         }
         else
             try
             {
-                c_args.emplace(tau_kw, ctx.get(tau_kw));
+                c_args.emplace(tau_kw, tau_slot == unbound_slot ? ctx.get(tau_kw) : static_cast<frame &>(ctx).load(tau_slot));
             }
             catch (const std::exception &)
             { // there is no tau..
             }
 
-        auto &pred = tau.empty() ? scp.get_predicate(predicate_name.id) : static_cast<component_type &>(c_args.at(tau_kw).get()->get_type()).get_predicate(predicate_name.id);
+        auto atm = new_atom(scp, ctx, is_fact, predicate_name.id, !tau.empty(), resolved_predicate, std::move(c_args));
+
+        if (slot == unbound_slot)
+        {
+            ctx.items.emplace(id.id, std::move(atm));
+            if (auto cr = dynamic_cast<core *>(&ctx)) // we have a global atom..
+                cr->item_defined(id.id);
+        }
+        else
+            static_cast<frame &>(ctx)[slot] = std::move(atm);
+    }
+
+    void local_field_statement::bind(frame_layout &layout)
+    {
+        slots.clear();
+        for (auto &[id, xpr] : fields)
+        { // the initializer is bound before the field is declared, so that it can refer to an outer item with the same name..
+            if (xpr)
+                xpr->bind(layout);
+            slots.push_back(layout.declare(id.id));
+        }
+    }
+
+    void assignment_statement::bind(frame_layout &layout)
+    {
+        if (auto obj = layout.find(object_id[0].id))
+            slot = *obj;
+        value->bind(layout);
+    }
+
+    void expression_statement::bind(frame_layout &layout) { xpr->bind(layout); }
+
+    void conjunction_statement::bind(frame_layout &layout)
+    {
+        if (cst)
+            cst->bind(layout);
+        for (auto &stmt : stmts)
+            stmt->bind(layout);
+    }
+
+    void disjunction_statement::bind(frame_layout &layout)
+    {
+        for (auto &conj : blocks)
+        { // the items declared within a block are not visible outside of it..
+            if (conj->cst)
+                conj->cst->bind(layout);
+            layout.open_scope();
+            for (auto &stmt : conj->stmts)
+                stmt->bind(layout);
+            layout.close_scope();
+        }
+        bound = true;
+    }
+
+    void for_all_statement::bind(frame_layout &layout)
+    {
+        layout.open_scope();
+        slot = layout.declare(enum_id.id);
+        for (auto &stmt : stmts)
+            stmt->bind(layout);
+        layout.close_scope();
+    }
+
+    void return_statement::bind(frame_layout &layout)
+    {
+        xpr->bind(layout);
+        slot = layout.return_slot();
+    }
+
+    void formula_statement::bind(frame_layout &layout)
+    {
+        for (auto &[arg, xpr] : args)
+            if (xpr)
+                xpr->bind(layout);
+        tau_slot = layout.resolve(tau.empty() ? tau_kw : tau[0].id);
+        slot = layout.declare(id.id);
+    }
+
+    expr local_field_statement::new_local(env &ctx, type &tp)
+    {
+        if (tp.is_primitive()) // initialize with a default value
+            return tp.new_instance();
+        else if (auto et = dynamic_cast<enum_type *>(&tp))
+            return et->new_instance();
+        else if (auto ct = dynamic_cast<component_type *>(&tp))
+            switch (ct->get_instances().size())
+            {
+            case 0: // no instances
+                throw inconsistency_exception();
+            case 1: // only one instance
+                return *ct->get_instances().begin();
+            default:
+            { // multiple instances
+                std::vector<expr> values;
+                for (auto &inst : ct->get_instances())
+                    values.emplace_back(inst);
+                return ctx.get_core().new_enum(*ct, std::move(values));
+            }
+            }
+        else
+            throw std::runtime_error("Invalid type reference");
+    }
+
+    void expression_statement::assert_constraint(const scope &scp, const expr &xpr)
+    {
+        auto val = to_cnf(std::static_pointer_cast<bool_term>(xpr)); // convert the expression to conjunctive normal form..
+        auto &cr = scp.get_core();
+        if (cr.c_file) // the constraint is retracted together with the file asserting it..
+            cr.c_file->assertions.emplace_back(cr.c_res, val);
+        if (cr.hash_consing && !cr.add_assertion(val))
+            return; // the constraint has already been posted within the current resolver..
+        if (auto and_val = std::dynamic_pointer_cast<const and_term>(val))
+            for (auto &arg : and_val->args)
+            { // we assert each clause
+                if (auto or_val = std::dynamic_pointer_cast<const or_term>(arg))
+                {
+                    std::vector<bool_expr> args;
+                    for (auto &val : or_val->args)
+                        args.emplace_back(val);
+                    scp.get_core().new_clause(std::move(args));
+                }
+            }
+        else if (auto or_val = std::dynamic_pointer_cast<const or_term>(val))
+        { // we assert the single clause
+            std::vector<bool_expr> args;
+            for (auto &val : or_val->args)
+                args.emplace_back(val);
+            scp.get_core().new_clause(std::move(args));
+        }
+        else
+            scp.get_core().new_clause({val});
+    }
+
+    expr formula_statement::new_atom(const scope &scp, env &ctx, bool is_fact, std::string_view predicate_name, bool qualified, predicate *resolved, item_map &&args)
+    {
+        auto &pred = qualified ? static_cast<component_type &>(args.at(tau_kw).get()->get_type()).get_predicate(predicate_name) : resolved ? *resolved : scp.get_predicate(predicate_name);
 
         // we initialize the unassigned atom's fields..
+        args.reserve(pred.get_fields().size() + 1);
         std::queue<predicate *> q;
         q.push(&pred);
         while (!q.empty())
         {
             auto p = q.front();
             for (const auto &[name, f] : p->get_fields())
-                if (c_args.find(name) == c_args.end())
+                if (args.find(name) == args.end())
                 { // the field is unassigned
                     auto &tp = f->get_type();
                     if (tp.is_primitive())
-                        c_args.emplace(name, tp.new_instance());
+                        args.emplace(name, tp.new_instance());
                     else if (auto ct = dynamic_cast<component_type *>(&tp))
                         switch (ct->get_instances().size())
                         {
                         case 0: // no instances
                             throw inconsistency_exception();
                         case 1: // only one instance
-                            c_args.emplace(name, *ct->get_instances().begin());
+                            args.emplace(name, *ct->get_instances().begin());
                             break;
                         default:
                         { // multiple instances
                             std::vector<expr> values;
                             for (auto &inst : ct->get_instances())
                                 values.emplace_back(inst);
-                            c_args.emplace(name, ctx.get_core().new_enum(*ct, std::move(values)));
+                            args.emplace(name, ctx.get_core().new_enum(*ct, std::move(values)));
                         }
                         }
                     else
@@ -222,8 +344,6 @@ namespace riddle
                 q.push(&parent.get());
         }
 
-        auto atm = scp.get_core().new_atom(is_fact, pred, std::move(c_args));
-
-        ctx.items.emplace(id.id, std::move(atm));
+        return scp.get_core().new_atom(is_fact, pred, std::move(args));
     }
 } // namespace riddle
@@ -0,0 +1,23 @@
+#include "symbol_table.hpp"
+
+namespace riddle
+{
+    const std::string &symbol_table::intern(std::string_view id)
+    {
+        if (concurrent)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            return do_intern(id);
+        }
+        return do_intern(id);
+    }
+
+    const std::string &symbol_table::do_intern(std::string_view id)
+    {
+        if (const auto it = index.find(id); it != index.cend())
+            return *it->second;
+        const auto &str = ids.emplace_back(id);
+        index.emplace(str, &str); // the key refers to the stored string, which never moves..
+        return str;
+    }
+} // namespace riddle
@@ -5,7 +5,7 @@
 
 namespace riddle
 {
-    bool_term::bool_term(bool_type &tp) noexcept : term(tp) {}
+    bool_term::bool_term(bool_type &tp, term_kind kind) noexcept : term(tp, kind) {}
     std::string bool_term::to_string() const noexcept
     {
         switch (get_type().get_scope().get_core().bool_value(*this))
@@ -33,9 +33,9 @@ namespace riddle
         return j_val;
     }
 
-    arith_term::arith_term(int_type &tp) noexcept : term(tp) {}
-    arith_term::arith_term(real_type &tp) noexcept : term(tp) {}
-    arith_term::arith_term(time_type &tp) noexcept : term(tp) {}
+    arith_term::arith_term(int_type &tp) noexcept : term(tp, term_kind::arith_kind) {}
+    arith_term::arith_term(real_type &tp) noexcept : term(tp, term_kind::arith_kind) {}
+    arith_term::arith_term(time_type &tp) noexcept : term(tp, term_kind::arith_kind) {}
     json::json arith_term::to_json() const noexcept
     {
         json::json j_val{{"type", get_type().get_name()}}; // we add the type of the item..
@@ -56,12 +56,12 @@ namespace riddle
         return j_val;
     }
 
-    string_term::string_term(string_type &tp) noexcept : term(tp) {}
+    string_term::string_term(string_type &tp) noexcept : term(tp, term_kind::string_kind) {}
     json::json string_term::to_json() const noexcept { return {{"type", get_type().get_name()}, {"val", get_type().get_scope().get_core().string_value(*this)}}; }
 
     select_value::select_value(flaw &flw, expr v) noexcept : resolver(flw, utils::rational(1)), val(std::move(v)) {}
 
-    enum_term::enum_term(flaw &flw, component_type &tp, std::vector<expr> &&vals) noexcept : term(tp), env(tp.get_core(), tp.get_core()), flw(flw), values(std::move(vals)) { assert(!values.empty()); }
+    enum_term::enum_term(flaw &flw, component_type &tp, std::vector<expr> &&vals) noexcept : term(tp, term_kind::enum_kind), env(tp.get_core(), tp.get_core()), flw(flw), values(std::move(vals)) { assert(!values.empty()); }
     expr enum_term::get(std::string_view name)
     {
         assert(get_values().size() > 1); // should not be a singleton..
@@ -183,7 +183,7 @@ namespace riddle
         return j_val;
     }
 
-    component::component(component_type &t) noexcept : term(t), env(t.get_core(), t.get_core()) {}
+    component::component(component_type &t) noexcept : term(t, term_kind::component_kind), env(t.get_core(), t.get_core()) {}
     json::json component::to_json() const noexcept
     {
         json::json j_itm{{"type", get_type().get_full_name()}}; // we add the type of the item..
@@ -197,7 +197,7 @@ namespace riddle
         return j_itm;
     }
 
-    atom_term::atom_term(flaw &flw, predicate &t, bool fact, std::map<std::string, expr, std::less<>> &&args) noexcept : term(t), env(t.get_core(), atom_parent(t, args), std::move(args)), flw(flw), fact(fact) {}
+    atom_term::atom_term(flaw &flw, predicate &t, bool fact, item_map &&args) noexcept : term(t, term_kind::atom_kind), env(t.get_core(), atom_parent(t, args), std::move(args)), flw(flw), fact(fact) {}
     atom_state atom_term::get_state() const noexcept { return get_type().get_scope().get_core().get_atom_state(*this); }
     json::json atom_term::to_json() const noexcept
     {
@@ -223,7 +223,7 @@ namespace riddle
         return j_atm;
     }
 
-    env &atom_term::atom_parent(const predicate &t, const std::map<std::string, expr, std::less<>> &args)
+    env &atom_term::atom_parent(const predicate &t, const item_map &args)
     {
         if (args.count(tau_kw))
         {
@@ -0,0 +1,51 @@
+#include "term_pool.hpp"
+#include <cassert>
+
+namespace riddle
+{
+    // the index of the size class of blocks of the given size..
+    static constexpr size_t size_class(size_t size) noexcept { return (size + term_pool::granularity - 1) / term_pool::granularity - 1; }
+
+    void *term_pool::allocate(size_t size)
+    {
+        assert(size > 0);
+        if (size > max_block_size) // large blocks come from the global allocator..
+            return ::operator new(size);
+
+        used += size;
+        const auto sc = size_class(size);
+        if (auto *blk = free[sc])
+        { // we reuse a released block..
+            free[sc] = blk->next;
+            return blk;
+        }
+
+        const auto b_size = (sc + 1) * granularity;
+        if (static_cast<size_t>(end - cur) < b_size)
+        { // we need a new chunk, the tail of the current one is left unused..
+            chunks.emplace_back(new std::byte[chunk_size]); // array new aligns for any scalar type..
+            cur = chunks.back().get();
+            end = cur + chunk_size;
+        }
+        auto *ptr = cur;
+        cur += b_size;
+        return ptr;
+    }
+
+    void term_pool::deallocate(void *ptr, size_t size) noexcept
+    {
+        if (!ptr)
+            return;
+        if (size > max_block_size)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        used -= size;
+        const auto sc = size_class(size);
+        auto *blk = static_cast<free_block *>(ptr);
+        blk->next = free[sc];
+        free[sc] = blk;
+    }
+} // namespace riddle
@@ -1,5 +1,6 @@
 #include "core.hpp"
 #include "lexer.hpp"
+#include "bytecode.hpp"
 #include "exceptions.hpp"
 #include <queue>
 #include <cassert>
@@ -265,7 +266,9 @@ namespace riddle
 
     expr component_type::new_instance()
     {
-        auto itm = std::make_shared<component>(static_cast<component_type &>(*this));
+        auto itm = get_core().new_term<component>(static_cast<component_type &>(*this));
+        if (auto file = get_core().c_file) // the instance is retracted together with the file creating it..
+            file->terms.push_back(itm);
         // we store the instance in type the hierarchy..
         std::queue<component_type *> q;
         q.push(this);
@@ -312,7 +315,7 @@ namespace riddle
         }
     }
 
-    predicate::predicate(scope &scp, std::string &&name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body) noexcept : scope(scp.get_core(), scp, std::move(args)), type(scp, std::move(name), false), body(body) {}
+    predicate::predicate(scope &scp, std::string &&name, std::vector<std::unique_ptr<field>> &&args, const std::vector<std::unique_ptr<statement>> &body, const frame_layout &layout, const lazy_program &code) noexcept : scope(scp.get_core(), scp, std::move(args)), type(scp, std::move(name), false), body(body), layout(layout), code(code) {}
 
     bool predicate::is_assignable_from(const type &other) const
     {
@@ -340,9 +343,12 @@ namespace riddle
         assert(is_assignable_from(atm->get_type()));
         for (auto &p : parents)
             p.get().call(atm);
-        env ctx(get_core(), *atm);
-        for (const auto &stmt : body)
-            stmt->execute(*this, ctx);
+        frame ctx(get_core(), *atm, &layout);
+        if (get_core().uses_bytecode())
+            code.run(*this, ctx);
+        else
+            for (const auto &stmt : body)
+                stmt->execute(*this, ctx);
     }
 
     expr predicate::new_instance()
@@ -0,0 +1,338 @@
+#include "type_context.hpp"
+#include "core.hpp"
+#include <queue>
+
+namespace riddle
+{
+    /**
+     * @brief Returns the type of the argument with the given name of the atoms of the given predicate, or `nullptr` if the atoms have no such argument.
+     */
+    static const type *find_arg(const predicate &pred, std::string_view name)
+    {
+        std::queue<const predicate *> q;
+        q.push(&pred);
+        while (!q.empty())
+        { // the atoms have the arguments of the predicate and of its base predicates..
+            auto p = q.front();
+            q.pop();
+            if (const auto it = p->get_fields().find(name); it != p->get_fields().end())
+                return &it->second->get_type();
+            for (const auto &base : p->get_parents())
+                q.push(&base.get());
+        }
+        if (name == tau_kw)
+            return dynamic_cast<const component_type *>(&pred.get_scope());
+        return nullptr;
+    }
+
+    const type *type_context::find_item(const type &tp, std::string_view name)
+    {
+        if (auto ct = dynamic_cast<const component_type *>(&tp))
+        {
+            std::queue<const component_type *> q;
+            q.push(ct);
+            while (!q.empty())
+            { // the instances have the fields of their type and of its supertypes..
+                auto c_ct = q.front();
+                q.pop();
+                if (const auto it = c_ct->get_fields().find(name); it != c_ct->get_fields().end())
+                    return &it->second->get_type();
+                for (const auto &base : c_ct->get_parents())
+                    q.push(&base.get());
+            }
+        }
+        else if (auto pred = dynamic_cast<const predicate *>(&tp))
+        {
+            if (auto arg = find_arg(*pred, name))
+                return arg;
+            if (auto ct = dynamic_cast<const component_type *>(&pred->get_scope())) // the atoms are executed within the environment of their tau..
+                return find_item(*ct, name);
+        }
+        return nullptr;
+    }
+
+    const type *type_context::find(std::string_view name) const
+    {
+        for (auto it = locals.rbegin(); it != locals.rend(); ++it)
+            if (it->first == name)
+                return it->second;
+        if (self)
+            if (auto tp = find_item(*self, name))
+                return tp;
+        if (globals)
+            return globals->find(name);
+
+        // the global items declared by the statements which have already been executed..
+        auto &cr = scp.get_core();
+        if (const auto it = cr.get_fields().find(name); it != cr.get_fields().end())
+            return &it->second->get_type();
+        try
+        {
+            return &cr.get(name)->get_type();
+        }
+        catch (const std::out_of_range &)
+        {
+            return nullptr;
+        }
+    }
+
+    const type &type_context::get(std::string_view name) const
+    {
+        if (auto tp = find(name))
+            return *tp;
+        throw std::out_of_range("item `" + std::string(name) + "` not found");
+    }
+
+    const type &type_context::get_item(const type &tp, std::string_view name)
+    {
+        if (!dynamic_cast<const component_type *>(&tp) && !dynamic_cast<const predicate *>(&tp))
+            throw std::runtime_error("Invalid object reference");
+        if (auto c_tp = find_item(tp, name))
+            return *c_tp;
+        throw std::out_of_range("item `" + std::string(name) + "` not found");
+    }
+
+    static bool is_arith(const type &tp) noexcept { return dynamic_cast<const int_type *>(&tp) || dynamic_cast<const real_type *>(&tp) || dynamic_cast<const time_type *>(&tp); }
+
+    static const type &check_bool(type_context &ctx, expression &xpr)
+    {
+        auto &tp = xpr.check(ctx);
+        if (!dynamic_cast<const bool_type *>(&tp))
+            throw std::runtime_error("Invalid boolean expression");
+        return tp;
+    }
+
+    static const type &check_arith(type_context &ctx, expression &xpr)
+    {
+        auto &tp = xpr.check(ctx);
+        if (!is_arith(tp))
+            throw std::runtime_error("Invalid arithmetic expression");
+        return tp;
+    }
+
+    /**
+     * @brief Checks the given arithmetic expressions, returning the type their combination is promoted to.
+     */
+    static const type &check_ariths(type_context &ctx, const std::vector<std::unique_ptr<expression>> &xprs)
+    {
+        unsigned int max = 0;
+        for (const auto &xpr : xprs)
+        {
+            auto &tp = check_arith(ctx, *xpr);
+            if (dynamic_cast<const time_type *>(&tp))
+                max = 3u;
+            else if (dynamic_cast<const real_type *>(&tp))
+                max = std::max(max, 2u);
+            else
+                max = std::max(max, 1u);
+        }
+        auto &cr = ctx.get_scope().get_core();
+        return cr.get_type(max == 3u ? time_kw : max == 2u ? real_kw : int_kw);
+    }
+
+    static std::vector<std::reference_wrapper<const type>> check_args(type_context &ctx, const std::vector<std::unique_ptr<expression>> &args)
+    {
+        std::vector<std::reference_wrapper<const type>> argument_types;
+        argument_types.reserve(args.size());
+        for (const auto &arg : args)
+            argument_types.emplace_back(arg->check(ctx));
+        return argument_types;
+    }
+
+    const type &bool_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(bool_kw); }
+    const type &int_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(int_kw); }
+    const type &bounded_int_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(int_kw); }
+    const type &uncertain_int_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(int_kw); }
+    const type &real_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(real_kw); }
+    const type &bounded_real_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(real_kw); }
+    const type &uncertain_real_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(real_kw); }
+    const type &string_expression::infer(type_context &ctx) const { return ctx.get_scope().get_core().get_type(string_kw); }
+
+    const type &id_expression::infer(type_context &ctx) const
+    {
+        auto tp = &ctx.get(object_id[0].id);
+        for (size_t i = 1; i < object_id.size(); ++i)
+            tp = &type_context::get_item(*tp, object_id[i].id);
+        return *tp;
+    }
+
+    const type &and_expression::infer(type_context &ctx) const
+    {
+        for (const auto &xpr : xprs)
+            check_bool(ctx, *xpr);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &or_expression::infer(type_context &ctx) const
+    {
+        for (const auto &xpr : xprs)
+            check_bool(ctx, *xpr);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &xor_expression::infer(type_context &ctx) const
+    {
+        for (const auto &xpr : xprs)
+            check_bool(ctx, *xpr);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &not_expression::infer(type_context &ctx) const { return check_bool(ctx, *xpr); }
+    const type &minus_expression::infer(type_context &ctx) const { return check_arith(ctx, *xpr); }
+    const type &sum_expression::infer(type_context &ctx) const { return check_ariths(ctx, xprs); }
+    const type &subtraction_expression::infer(type_context &ctx) const { return check_ariths(ctx, xprs); }
+    const type &product_expression::infer(type_context &ctx) const { return check_ariths(ctx, xprs); }
+    const type &division_expression::infer(type_context &ctx) const { return check_ariths(ctx, xprs); }
+    const type &lt_expression::infer(type_context &ctx) const
+    {
+        check_arith(ctx, *lhs);
+        check_arith(ctx, *rhs);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &le_expression::infer(type_context &ctx) const
+    {
+        check_arith(ctx, *lhs);
+        check_arith(ctx, *rhs);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &gt_expression::infer(type_context &ctx) const
+    {
+        check_arith(ctx, *lhs);
+        check_arith(ctx, *rhs);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &ge_expression::infer(type_context &ctx) const
+    {
+        check_arith(ctx, *lhs);
+        check_arith(ctx, *rhs);
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+    const type &eq_expression::infer(type_context &ctx) const
+    { // the compared items must be of the same kind..
+        auto &l_tp = lhs->check(ctx);
+        auto &r_tp = rhs->check(ctx);
+        if (!(is_arith(l_tp) && is_arith(r_tp)) && !l_tp.is_assignable_from(r_tp) && !r_tp.is_assignable_from(l_tp))
+            throw std::runtime_error("Invalid comparison");
+        return ctx.get_scope().get_core().get_type(bool_kw);
+    }
+
+    const type &constructor_expression::infer(type_context &ctx) const
+    {
+        auto ct = dynamic_cast<component_type *>(&resolve_type(ctx.get_scope(), type_id));
+        if (!ct)
+            throw std::runtime_error("Invalid type reference");
+        resolved_type = ct;
+        [[maybe_unused]] auto &c = ct->get_constructor(check_args(ctx, arguments));
+        return *ct;
+    }
+
+    const type &call_expression::infer(type_context &ctx) const
+    {
+        if (object_id.empty()) // methods are invoked on objects..
+            throw std::runtime_error("Invalid object reference");
+        auto tp = &ctx.get(object_id[0].id);
+        for (size_t i = 1; i < object_id.size(); ++i)
+            tp = &type_context::get_item(*tp, object_id[i].id);
+        auto ct = dynamic_cast<const component_type *>(tp);
+        if (!ct)
+            throw std::runtime_error("Invalid object reference");
+        auto &mthd = ct->get_method(function_id.id, check_args(ctx, arguments));
+        if (!mthd.get_return_type())
+            throw std::runtime_error("method `" + mthd.get_name() + "` does not return a value");
+        return mthd.get_return_type()->get();
+    }
+
+    void local_field_statement::check(type_context &ctx)
+    {
+        auto &tp = resolve_type(ctx.get_scope(), field_type);
+        resolved_type = &tp;
+        for (auto &[id, xpr] : fields)
+        { // the initializer is checked before the field is declared, as it is bound..
+            if (xpr && !tp.is_assignable_from(xpr->check(ctx)))
+                throw std::runtime_error("Invalid assignment");
+            ctx.declare(id.id, tp);
+        }
+    }
+
+    void assignment_statement::check(type_context &ctx)
+    {
+        auto tp = &ctx.get(object_id[0].id);
+        for (size_t i = 1; i < object_id.size(); ++i)
+            tp = &type_context::get_item(*tp, object_id[i].id);
+        auto ct = dynamic_cast<const component_type *>(tp);
+        if (!ct)
+            throw std::runtime_error("Invalid type reference");
+        if (!ct->get_field(field_id.id).get_type().is_assignable_from(value->check(ctx)))
+            throw std::runtime_error("Invalid assignment");
+    }
+
+    void expression_statement::check(type_context &ctx) { check_bool(ctx, *xpr); }
+
+    void conjunction_statement::check(type_context &ctx)
+    {
+        if (cst)
+            check_arith(ctx, *cst);
+        for (auto &stmt : stmts)
+            stmt->check(ctx);
+    }
+
+    void disjunction_statement::check(type_context &ctx)
+    {
+        for (auto &conj : blocks)
+        { // the items declared within a block are not visible outside of it..
+            if (conj->cst)
+                check_arith(ctx, *conj->cst);
+            ctx.open_scope();
+            for (auto &stmt : conj->stmts)
+                stmt->check(ctx);
+            ctx.close_scope();
+        }
+    }
+
+    void for_all_statement::check(type_context &ctx)
+    {
+        auto ct = dynamic_cast<component_type *>(&resolve_type(ctx.get_scope(), enum_type));
+        if (!ct)
+            throw std::runtime_error("Invalid type reference");
+        resolved_type = ct;
+        ctx.open_scope();
+        ctx.declare(enum_id.id, *ct);
+        for (auto &stmt : stmts)
+            stmt->check(ctx);
+        ctx.close_scope();
+    }
+
+    void return_statement::check(type_context &ctx)
+    {
+        auto &tp = xpr->check(ctx);
+        if (!ctx.get_return_type())
+            throw std::runtime_error("Invalid return statement");
+        if (!ctx.get_return_type()->is_assignable_from(tp))
+            throw std::runtime_error("Invalid assignment");
+    }
+
+    void formula_statement::check(type_context &ctx)
+    {
+        const predicate *pred;
+        if (!tau.empty())
+        {
+            auto tp = &ctx.get(tau[0].id);
+            for (size_t i = 1; i < tau.size(); ++i)
+                tp = &type_context::get_item(*tp, tau[i].id);
+            auto ct = dynamic_cast<const component_type *>(tp);
+            if (!ct)
+                throw std::runtime_error("Invalid object reference");
+            pred = &ct->get_predicate(predicate_name.id);
+        }
+        else
+            pred = resolved_predicate = &ctx.get_scope().get_predicate(predicate_name.id);
+
+        for (auto &[arg, xpr] : args)
+            if (xpr)
+            {
+                auto arg_tp = find_arg(*pred, arg.id);
+                if (!arg_tp)
+                    throw std::out_of_range("argument `" + std::string(arg.id) + "` not found");
+                if (!arg_tp->is_assignable_from(xpr->check(ctx)))
+                    throw std::runtime_error("Invalid assignment");
+            }
+        ctx.declare(id.id, *pred);
+    }
+} // namespace riddle
@@ -1,12 +1,93 @@
 #include "types.hpp"
 #include "items.hpp"
 #include "core.hpp"
-#include <sstream>
 #include <set>
 
 namespace riddle
 {
-    state_variable::state_variable(core &cr) noexcept : flaw_aware_component_type(cr, state_variable_kw), timeline(cr) { add_constructor(std::make_unique<constructor>(*this)); }
+    namespace
+    {
+        // the identifiers of the built-in declarations, which are shared by all the cores, hence outlive them..
+        symbol_table &builtin_symbols()
+        {
+            static symbol_table symbols;
+            return symbols;
+        }
+
+        // the built-in declarations do not refer to any source, so their tokens have no position..
+        id_token builtin_id(std::string_view id) { return id_token(builtin_symbols().intern(id), 0, 0, 0); }
+        std::vector<id_token> builtin_ids(std::string_view id)
+        {
+            std::vector<id_token> ids;
+            ids.emplace_back(builtin_id(id));
+            return ids;
+        }
+        std::unique_ptr<expression> builtin_ref(std::string_view id) { return std::make_unique<id_expression>(builtin_ids(id)); }
+        std::unique_ptr<statement> builtin_not_negative(std::string_view id) { return std::make_unique<expression_statement>(std::make_unique<ge_expression>(builtin_ref(id), std::make_unique<real_expression>(real_token(utils::rational(), 0, 0, 0)))); }
+
+        // `<tp>(real arg_0, .., real arg_n) : arg_0(arg_0), .., arg_n(arg_n) { arg_0 >= 0.0; <stmts> }`..
+        std::unique_ptr<constructor_declaration> builtin_constructor(std::initializer_list<std::string_view> args, std::vector<std::unique_ptr<statement>> &&stmts)
+        {
+            std::vector<std::pair<std::vector<id_token>, id_token>> params;
+            std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>> inits;
+            for (const auto &arg : args)
+            {
+                params.emplace_back(builtin_ids(real_kw), builtin_id(arg));
+                std::vector<std::unique_ptr<expression>> init;
+                init.emplace_back(builtin_ref(arg));
+                inits.emplace_back(builtin_id(arg), std::move(init));
+            }
+            stmts.insert(stmts.begin(), builtin_not_negative(*args.begin()));
+            return std::make_unique<constructor_declaration>(std::move(params), std::move(inits), std::move(stmts));
+        }
+
+        // `predicate <name>(real amount) : Interval { amount >= 0.0; }`..
+        std::unique_ptr<predicate_declaration> builtin_amount_predicate(std::string_view name, std::string_view amount)
+        {
+            std::vector<std::pair<std::vector<id_token>, id_token>> params;
+            params.emplace_back(builtin_ids(real_kw), builtin_id(amount));
+            std::vector<std::vector<id_token>> base_predicates;
+            base_predicates.emplace_back(builtin_ids(interval_kw));
+            std::vector<std::unique_ptr<statement>> body;
+            body.emplace_back(builtin_not_negative(amount));
+            return std::make_unique<predicate_declaration>(builtin_id(name), std::move(params), std::move(base_predicates), std::move(body));
+        }
+
+        /**
+         * @brief The declarations of the built-in types.
+         *
+         * They are built once per process, rather than parsed by every core, and are shared by all the cores.
+         */
+        struct builtin_declarations
+        {
+            builtin_declarations()
+            {
+                state_variable_ctr = std::make_unique<constructor_declaration>(std::vector<std::pair<std::vector<id_token>, id_token>>(), std::vector<std::pair<id_token, std::vector<std::unique_ptr<expression>>>>(), std::vector<std::unique_ptr<statement>>());
+                reusable_resource_ctr = builtin_constructor({reusable_resource_capacity_kw}, {});
+                reusable_resource_use = builtin_amount_predicate(reusable_resource_use_predicate_kw, reusable_resource_amount_kw);
+                std::vector<std::unique_ptr<statement>> stmts;
+                stmts.emplace_back(std::make_unique<expression_statement>(std::make_unique<le_expression>(builtin_ref(consumable_resource_initial_amount_kw), builtin_ref(consumable_resource_capacity_kw))));
+                consumable_resource_ctr = builtin_constructor({consumable_resource_capacity_kw, consumable_resource_initial_amount_kw}, std::move(stmts));
+                consumable_resource_produce = builtin_amount_predicate(consumable_resource_produce_predicate_kw, consumable_resource_amount_kw);
+                consumable_resource_consume = builtin_amount_predicate(consumable_resource_consume_predicate_kw, consumable_resource_amount_kw);
+            }
+
+            std::unique_ptr<constructor_declaration> state_variable_ctr;
+            std::unique_ptr<constructor_declaration> reusable_resource_ctr;
+            std::unique_ptr<predicate_declaration> reusable_resource_use;
+            std::unique_ptr<constructor_declaration> consumable_resource_ctr;
+            std::unique_ptr<predicate_declaration> consumable_resource_produce;
+            std::unique_ptr<predicate_declaration> consumable_resource_consume;
+        };
+
+        const builtin_declarations &builtins()
+        {
+            static const builtin_declarations decls;
+            return decls;
+        }
+    } // namespace
+
+    state_variable::state_variable(core &cr) noexcept : flaw_aware_component_type(cr, state_variable_kw), timeline(cr) { builtins().state_variable_ctr->refine(*this); }
 
     void state_variable::created_predicate(predicate &pred) noexcept { add_parent(pred, get_core().get_predicate(interval_kw)); }
 
@@ -107,16 +188,10 @@ namespace riddle
     {
         add_field(std::make_unique<field>(cr.get_type(real_kw), reusable_resource_capacity_kw, nullptr));
 
-        std::istringstream ctr_decl("ReusableResource(real capacity) : capacity(capacity) { capacity >= 0.0; }");
-        parser ctr_p(ctr_decl);
-        ctr = ctr_p.parse_constructor_declaration();
-        ctr->refine(*this);
-
-        std::istringstream use_pred_decl("predicate Use(real amount) : Interval { amount >= 0.0; }");
-        parser use_pred_p(use_pred_decl);
-        use_pred = use_pred_p.parse_predicate_declaration();
-        use_pred->declare(*this);
-        use_pred->refine(*this);
+        const auto &decls = builtins();
+        decls.reusable_resource_ctr->refine(*this);
+        decls.reusable_resource_use->declare(*this);
+        decls.reusable_resource_use->refine(*this);
     }
 
     void reusable_resource::created_predicate(predicate &pred) noexcept { add_parent(pred, get_core().get_predicate(interval_kw)); }
@@ -228,22 +303,12 @@ namespace riddle
         add_field(std::make_unique<field>(cr.get_type(real_kw), consumable_resource_capacity_kw, nullptr));
         add_field(std::make_unique<field>(cr.get_type(real_kw), consumable_resource_initial_amount_kw, nullptr));
 
-        std::istringstream ctr_decl("ConsumableResource(real capacity, real initial_amount) : capacity(capacity), initial_amount(initial_amount) { capacity >= 0.0; initial_amount <= capacity; }");
-        parser ctr_p(ctr_decl);
-        ctr = ctr_p.parse_constructor_declaration();
-        ctr->refine(*this);
-
-        std::istringstream prod_pred_decl("predicate Produce(real amount) : Interval { amount >= 0.0; }");
-        parser prod_pred_p(prod_pred_decl);
-        prod_pred = prod_pred_p.parse_predicate_declaration();
-        prod_pred->declare(*this);
-        prod_pred->refine(*this);
-
-        std::istringstream cons_pred_decl("predicate Consume(real amount) : Interval { amount >= 0.0; }");
-        parser cons_pred_p(cons_pred_decl);
-        cons_pred = cons_pred_p.parse_predicate_declaration();
-        cons_pred->declare(*this);
-        cons_pred->refine(*this);
+        const auto &decls = builtins();
+        decls.consumable_resource_ctr->refine(*this);
+        decls.consumable_resource_produce->declare(*this);
+        decls.consumable_resource_produce->refine(*this);
+        decls.consumable_resource_consume->declare(*this);
+        decls.consumable_resource_consume->refine(*this);
     }
 
     void consumable_resource::created_predicate(predicate &pred) noexcept { add_parent(pred, get_core().get_predicate(interval_kw)); }
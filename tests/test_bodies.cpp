@@ -0,0 +1,174 @@
+#include "test_core.hpp"
+#include "types.hpp"
+#include <cassert>
+
+void test_frames()
+{
+    test_core core;
+    core.read("class A { real v; A(real v) : v(v) {} real shifted() { real y = v + 1.0; return y; } };");
+    core.read("A a0 = new A(1.0); A a1 = new A(2.0); real r = a0.shifted();");
+    assert(core.get("r"));
+
+    // the bodies of the predicates are executed once the atoms are called..
+    core.read("predicate q(real z) { z >= 0.0; } predicate p(real a, real b) { real c = a; for (A x) { x.v < b; } { real d = c + b; fact f = new q(z: d); } or { c >= b; fact f = new q(z: c); } }");
+    core.read("fact f = new p(a: 1.0, b: 2.0);");
+    auto &p = core.get_predicate("p");
+    p.call(p.get_atoms().front());
+    auto &q = core.get_predicate("q");
+    assert(q.get_atoms().empty());
+
+    // the conjunctions retain the items of the predicate's frame..
+    assert(core.conjunctions.size() == 2);
+    for (auto &conj : core.conjunctions)
+        conj->execute();
+    assert(q.get_atoms().size() == 2);
+}
+
+void test_bytecode()
+{
+    test_core core;
+    core.set_bytecode(true);
+    core.read("class A { real v; A(real v) : v(v) { v >= 0.0; } real shifted() { real y = v + 1.0; return y; } real twice() { return this.shifted() + this.shifted(); } };");
+    core.read("A a0 = new A(1.0); A a1 = new A(2.0); real r = a0.twice();");
+    assert(core.get("r"));
+
+    // the compiled bodies produce the same atoms as the walked trees..
+    core.read("predicate q(real z) { z >= 0.0; } predicate p(real a, real b) { real c = a; for (A x) { x.v < b; } { real d = c + b; fact f = new q(z: d); } or { c >= b; fact f = new q(z: c); } }");
+    core.read("fact f = new p(a: 1.0, b: 2.0);");
+    auto &p = core.get_predicate("p");
+    p.call(p.get_atoms().front());
+    auto &q = core.get_predicate("q");
+    assert(q.get_atoms().empty());
+
+    assert(core.conjunctions.size() == 2);
+    for (auto &conj : core.conjunctions)
+        conj->execute();
+    assert(q.get_atoms().size() == 2);
+
+    // the bodies declared while the bytecode is disabled are compiled once it is enabled..
+    test_core late;
+    late.read("class B { real v; B(real v) : v(v) { v >= 0.0; } };");
+    late.set_bytecode(true);
+    late.read("B b0 = new B(1.0); B b1 = new B(2.0);");
+    assert(late.get("b0") && late.get("b1"));
+}
+
+void test_type_check()
+{
+    test_core core;
+    core.read("class A { real v; A(real v) : v(v) {} real get() { return v; } }; predicate p(A x) { x.get() >= 0.0; }");
+    core.read("A a = new A(1.0); real r = a.get() + 2; bool b = r <= 3.0; fact f = new p(x: a);");
+
+    // ill-typed scripts are rejected before any of their statements is executed..
+    for (const auto script : {"real x = 1.0; x + 1.0;", "real x = 1.0; bool c = a;", "real x = 1.0; a.v > true;", "real x = 1.0; a == r;", "real x = 1.0; fact g = new p(x: r);", "real x = 1.0; predicate q(real z) { !z; }"})
+    {
+        bool thrown = false;
+        try
+        {
+            core.read(script);
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try
+        {
+            static_cast<void>(core.get("x"));
+        }
+        catch (const std::out_of_range &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void test_overload_cache()
+{
+    for (const bool bytecode : {false, true})
+    {
+        test_core core;
+        core.set_bytecode(bytecode);
+        core.read("class B { real v; B(real v) : v(v) {} bool make() { B y = new B(this.v); return true; } }; class C : B { C(real v) : B(v) {} };");
+        core.read("predicate p(B x) { x.make(); }");
+        // the same call site is invoked on objects of different types..
+        core.read("B b0 = new B(1.0); B b1 = new B(2.0); C c = new C(1.0); fact f0 = new p(x: b0); fact f1 = new p(x: c); fact f2 = new p(x: b1);");
+
+        auto &p = core.get_predicate("p");
+        for (auto &atm : p.get_atoms())
+            p.call(atm);
+        assert(static_cast<riddle::component_type &>(core.get_type("C")).get_instances().size() == 1);
+        assert(static_cast<riddle::component_type &>(core.get_type("B")).get_instances().size() == 6);
+    }
+}
+
+void test_type_paths()
+{
+    for (const bool bytecode : {false, true})
+    {
+        test_core core;
+        core.set_bytecode(bytecode);
+        core.read("class B { real r; B(real r) : r(r) {} }; predicate q(B x) { x.r >= 0.0; } predicate p(real z) { B b = new B(z); for (B x) { fact f = new q(x: x); } }");
+        core.read("fact f0 = new p(z: 1.0); fact f1 = new p(z: 2.0);");
+
+        // the type paths are resolved once, while checking, and reused by every call..
+        auto &p = core.get_predicate("p");
+        for (auto &atm : p.get_atoms())
+            p.call(atm);
+        assert(static_cast<riddle::component_type &>(core.get_type("B")).get_instances().size() == 2);
+        assert(core.get_predicate("q").get_atoms().size() == 3);
+    }
+}
+
+class test_reusable_resource : public riddle::reusable_resource
+{
+public:
+    using reusable_resource::reusable_resource;
+
+    std::shared_ptr<riddle::flaw> new_peak(std::vector<riddle::atom_expr> &&) noexcept override { return nullptr; }
+};
+
+class test_consumable_resource : public riddle::consumable_resource
+{
+public:
+    using consumable_resource::consumable_resource;
+
+    std::shared_ptr<riddle::flaw> new_overproduction(std::vector<riddle::atom_expr> &&, std::vector<riddle::atom_expr> &&) noexcept override { return nullptr; }
+    std::shared_ptr<riddle::flaw> new_overconsumption(std::vector<riddle::atom_expr> &&, std::vector<riddle::atom_expr> &&) noexcept override { return nullptr; }
+};
+
+class test_resource_core : public test_core
+{
+public:
+    test_resource_core()
+    {
+        read("predicate Interval(time start, time end, time duration) { duration >= 0.0; end == start + duration; }");
+        const auto n_symbols = get_symbols().size();
+        add_type(std::make_unique<test_reusable_resource>(*this));
+        add_type(std::make_unique<test_consumable_resource>(*this));
+        assert(get_symbols().size() == n_symbols); // the built-in declarations are not parsed..
+    }
+};
+
+void test_builtin_types()
+{
+    for (int i = 0; i < 2; ++i)
+    { // the built-in declarations are shared by the cores..
+        test_resource_core core;
+        core.read("ReusableResource rr = new ReusableResource(10.0); fact u = new rr.Use(start: 0.0, end: 1.0, duration: 1.0, amount: 5.0);");
+        core.read("ConsumableResource cr = new ConsumableResource(10.0, 5.0); fact p = new cr.Produce(start: 0.0, end: 1.0, duration: 1.0, amount: 2.0); fact c = new cr.Consume(start: 1.0, end: 2.0, duration: 1.0, amount: 3.0);");
+    }
+}
+
+int main()
+{
+    test_frames();
+    test_bytecode();
+    test_type_check();
+    test_overload_cache();
+    test_type_paths();
+    test_builtin_types();
+    return 0;
+}
@@ -0,0 +1,291 @@
+#include "test_core.hpp"
+#include "ast_cache.hpp"
+#include "mapped_file.hpp"
+#include <fstream>
+#include <cassert>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define RIDDLE_PIPES
+#endif
+
+class test_reloading_core : public test_core
+{
+public:
+    void new_clause(std::vector<riddle::bool_expr> &&) override { ++clauses; }
+
+private:
+    void retract(const std::vector<riddle::expr> &terms) override
+    { // the flaws of the retracted atoms are dropped, while the ones of the enums are kept..
+        const std::unordered_set<riddle::expr> retracting(terms.begin(), terms.end());
+        flaws.erase(std::remove_if(flaws.begin(), flaws.end(), [&retracting](const auto &flw)
+                                   {
+                                       if (auto atm_flw = dynamic_cast<test_atom_flaw *>(flw.get()))
+                                           return retracting.count(atm_flw->get_atom()) > 0;
+                                       return false; }),
+                    flaws.end());
+        retracted += terms.size();
+    }
+
+public:
+    std::size_t clauses = 0;   // the number of clauses posted to the backend..
+    std::size_t retracted = 0; // the number of terms retracted from the backend..
+};
+
+void test_parallel_read()
+{
+    std::vector<std::filesystem::path> files;
+    for (int i = 0; i < 8; ++i)
+    {
+        files.push_back(std::filesystem::temp_directory_path() / ("riddle_parallel_" + std::to_string(i) + ".rddl"));
+        std::ofstream ofs(files.back());
+        if (i == 0)
+            ofs << "class A { real r; A(real r) : r(r) {} };";
+        else
+            ofs << "A a" << i << " = new A(" << i << ".5); a" << i << ".r >= 0.0;";
+    }
+
+    test_core core;
+    core.set_parse_threads(4);
+    core.read(files);
+
+    files.push_back(std::filesystem::temp_directory_path() / "riddle_parallel_missing.rddl");
+    bool thrown = false;
+    try
+    {
+        core.read(files);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    for (const auto &file : files)
+        std::filesystem::remove(file);
+}
+
+void test_mapped_file()
+{
+    const auto file = std::filesystem::temp_directory_path() / "riddle_mapped.rddl";
+    std::string src = "real x = 1.0;";
+    src += std::string(4096 - src.size() - 1, ' ') + "x"; // the source ends at a page boundary, right after an identifier..
+    {
+        std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+        ofs << src;
+    }
+    assert(riddle::mapped_file(file).content() == src);
+    riddle::symbol_table symbols;
+    bool thrown = false;
+    try
+    {
+        static_cast<void>(riddle::parser(riddle::mapped_file(file).content(), symbols).parse_compilation_unit());
+    }
+    catch (const std::invalid_argument &)
+    { // the trailing identifier is not a statement..
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::ofstream(file, std::ios::trunc).close();
+    assert(riddle::mapped_file(file).content().empty());
+    test_core core;
+    core.read(std::vector<std::filesystem::path>{file});
+
+#ifdef RIDDLE_PIPES
+    if (int fds[2]; ::pipe(fds) == 0)
+    { // pipes can be neither mapped nor sought, yet they must be read as well..
+        const std::string pipe_src = "real y = 2.0;";
+        const auto written = ::write(fds[1], pipe_src.data(), pipe_src.size());
+        assert(written == static_cast<ssize_t>(pipe_src.size()));
+        ::close(fds[1]);
+        const std::filesystem::path pipe_file = "/dev/fd/" + std::to_string(fds[0]);
+        if (std::filesystem::exists(pipe_file))
+            assert(riddle::mapped_file(pipe_file).content() == pipe_src);
+        ::close(fds[0]);
+    }
+#endif
+
+    std::filesystem::remove(file);
+    thrown = false;
+    try
+    {
+        riddle::mapped_file mf(file);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_reload()
+{
+    const auto domain = std::filesystem::temp_directory_path() / "riddle_reload_domain.rddl";
+    const auto problem = std::filesystem::temp_directory_path() / "riddle_reload_problem.rddl";
+    const auto write = [](const std::filesystem::path &file, const std::string &src)
+    {
+        std::ofstream ofs(file, std::ios::trunc);
+        ofs << src;
+    };
+    write(domain, "class A { real r; A(real r) : r(r) {} };");
+    write(problem, "A a = new A(1.5); real x = 1.0, y = 2.0;");
+
+    test_reloading_core core;
+    core.reload({domain, problem}); // the files are read for the first time, their problems being recorded..
+    const auto a = core.get_items().at("a");
+
+    // unchanged files are skipped..
+    core.reload({domain, problem});
+    assert(core.get_items().at("a") == a);
+
+    // the items of changed files are replaced..
+    write(problem, "A a = new A(2.5); real x = 3.0, z = 4.0;");
+    core.reload({domain, problem});
+    assert(core.get_items().at("a") != a);
+    assert(core.get_items().count("x") && !core.get_items().count("y") && core.get_items().count("z"));
+
+    // ..and so are their instances, atoms and constraints, while the enums of the unchanged files are kept..
+    write(domain, "enum E { \"a\", \"b\" }; E e; class A { real r; A(real r) : r(r) {} }; predicate P(real u) { u >= 0.0; }");
+    write(problem, "A a = new A(1.0); fact f = new P(u: 1.0); a.r >= 0.5;");
+    test_reloading_core p_core;
+    p_core.reload({domain, problem});
+    const auto &a_tp = static_cast<riddle::component_type &>(p_core.get_type("A"));
+    const auto &p_pred = p_core.get_predicate("P");
+    assert(a_tp.get_instances().size() == 1 && p_pred.get_atoms().size() == 1);
+    for (const auto u : {"2.0", "3.0"})
+    {
+        write(problem, std::string("A a = new A(1.0); fact f = new P(u: ") + u + "); a.r >= 0.5;");
+        p_core.reload({domain, problem});
+        assert(a_tp.get_instances().size() == 1 && p_pred.get_atoms().size() == 1);
+        assert(a_tp.get_instances().front() == p_core.get_items().at("a") && p_pred.get_atoms().front() == p_core.get_items().at("f"));
+    }
+    assert(p_core.retracted == 6); // the instance, the atom and the constraint of each previous version..
+    assert(p_core.get_items().count("e"));
+    write(domain, "class A { real r; A(real r) : r(r) {} };");
+
+    // backends which cannot retract terms cannot reload changed files, and the core is left untouched..
+    write(problem, "A a = new A(1.0);");
+    test_core s_core;
+    s_core.reload({domain, problem});
+    const auto s_a = s_core.get_items().at("a");
+    write(problem, "A a = new A(2.0);");
+    bool unsupported = false;
+    try
+    {
+        s_core.reload({domain, problem});
+    }
+    catch (const std::runtime_error &)
+    {
+        unsupported = true;
+    }
+    assert(unsupported && s_core.get_items().at("a") == s_a && static_cast<riddle::component_type &>(s_core.get_type("A")).get_instances().size() == 1);
+
+    // with hash-consing, the constraints posted once on behalf of several files are retracted only together with the last of them..
+    const auto shared = std::filesystem::temp_directory_path() / "riddle_reload_shared.rddl";
+    write(domain, "real x, y;");
+    write(problem, "x >= y;");
+    write(shared, "x >= y;");
+    test_reloading_core h_core;
+    h_core.set_hash_consing(true);
+    h_core.reload({domain, problem, shared});
+    assert(h_core.clauses == 1);
+    write(problem, "y >= x;");
+    h_core.reload({domain, problem, shared});
+    assert(h_core.retracted == 0 && h_core.clauses == 2);
+    write(shared, "y >= x;");
+    h_core.reload({domain, problem, shared});
+    assert(h_core.retracted == 1 && h_core.clauses == 2);
+    std::filesystem::remove(shared);
+    write(domain, "class A { real r; A(real r) : r(r) {} };");
+
+    // the problems of the files read through `read` are not recorded, hence they cannot be reloaded..
+    write(problem, "A a = new A(1.0);");
+    test_reloading_core r_core;
+    r_core.read(std::vector<std::filesystem::path>{domain, problem});
+    write(problem, "A a = new A(2.0);");
+    bool unrecorded = false;
+    try
+    {
+        r_core.reload({domain, problem});
+    }
+    catch (const std::runtime_error &)
+    {
+        unrecorded = true;
+    }
+    assert(unrecorded && r_core.retracted == 0);
+
+    // declarations cannot be reloaded..
+    write(domain, "class A { real r; A(real r) : r(r) {} }; class B {};");
+    bool thrown = false;
+    try
+    {
+        core.reload({domain, problem});
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::filesystem::remove(domain);
+    std::filesystem::remove(problem);
+}
+
+void test_ast_cache()
+{
+    const std::string src = "enum Color {\"red\", \"green\"};\nclass A : B.C { real r = 1.5, s; int i = [0, 10]; A(real r) : r(r), s(-r * 2.0) {} bool m(int x) { return !(x > 1 & x <= i) | x == 0 ^ true; } predicate P(int x) : Q { x + 1 - i >= x / 2; goal g = new Q(x: x); { r <= 0.0; } or { r > 0.0; } for (A a) { a.r >= 1.0; } } };\nreal u = ?[0.0, 1.0]; int v = ?[1, 2]; real z = [0.0, 2.5]; string w = \"w\";\nfact f = new a.P(x: 1);";
+    riddle::symbol_table symbols;
+    const auto hash = riddle::content_hash(src);
+    auto cu = riddle::parser(src, symbols).parse_compilation_unit();
+    const auto data = riddle::serialize(*cu, hash);
+
+    // the deserialized trees serialize back to the same data..
+    auto c_cu = riddle::deserialize(data, hash, symbols);
+    assert(c_cu);
+    assert(riddle::serialize(*c_cu, hash) == data);
+
+    // stale and corrupted data is rejected..
+    assert(!riddle::deserialize(data, hash + 1, symbols));
+    assert(!riddle::deserialize(data.substr(0, data.size() - 1), hash, symbols));
+    assert(!riddle::deserialize(data + '\0', hash, symbols));
+    assert(!riddle::deserialize("", hash, symbols));
+
+    // a corrupted number of identifiers is rejected rather than allocated..
+    size_t ids_pos = 4; // the identifiers are counted after the magic number, the version, the size of the integers and the hash..
+    for (int i = 0; i < 3; ++i)
+        while (static_cast<unsigned char>(data[ids_pos++]) & 0x80)
+            ;
+    auto ids_end = ids_pos;
+    while (static_cast<unsigned char>(data[ids_end++]) & 0x80)
+        ;
+    for (const auto *count : {"\xff\xff\xff\xff\xff\xff\xff\xff\x7f", "\x80\x80\x80\x80\x80\x10"})
+        assert(!riddle::deserialize(data.substr(0, ids_pos) + count + data.substr(ids_end), hash, symbols));
+
+    // files are read from the cache once it has been written..
+    const auto cache_dir = std::filesystem::temp_directory_path() / "riddle_ast_cache";
+    std::filesystem::remove_all(cache_dir);
+    const auto file = std::filesystem::temp_directory_path() / "riddle_cached.rddl";
+    {
+        std::ofstream ofs(file);
+        ofs << "class A { real r; A(real r) : r(r) {} }; A a = new A(1.5); a.r >= 0.0;";
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        test_core core;
+        core.set_ast_cache(cache_dir);
+        core.read(std::vector<std::filesystem::path>{file});
+        assert(std::distance(std::filesystem::directory_iterator(cache_dir), std::filesystem::directory_iterator()) == 1);
+    }
+    std::filesystem::remove_all(cache_dir);
+    std::filesystem::remove(file);
+}
+
+int main()
+{
+    test_parallel_read();
+    test_mapped_file();
+    test_reload();
+    test_ast_cache();
+    return 0;
+}
@@ -1,11 +1,15 @@
 #include "lexer.hpp"
+#include "scan.hpp"
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 #include <cassert>
 
 void test_lexer0()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "bool a = true;";
     auto tokens = lex.parse(ss);
@@ -35,7 +39,8 @@ void test_lexer0()
 
 void test_lexer1()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "int a = 42;";
     auto tokens = lex.parse(ss);
@@ -65,7 +70,8 @@ void test_lexer1()
 
 void test_lexer2()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "real a = 3.14;";
     auto tokens = lex.parse(ss);
@@ -95,7 +101,8 @@ void test_lexer2()
 
 void test_lexer3()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "string a = \"hello\";";
     auto tokens = lex.parse(ss);
@@ -125,7 +132,8 @@ void test_lexer3()
 
 void test_lexer4()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "enum E { \"a\", \"b\", \"c\" } | a.b.c;";
     auto tokens = lex.parse(ss);
@@ -199,7 +207,8 @@ void test_lexer4()
 
 void test_comment()
 {
-    riddle::lexer lex;
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
     std::stringstream ss;
     ss << "int a = 42; // this is a comment";
     auto tokens = lex.parse(ss);
@@ -227,6 +236,166 @@ void test_comment()
     assert(tokens[5]->sym == riddle::EoF);
 }
 
+void test_buffer()
+{
+    riddle::symbol_table symbols;
+    std::string src = "enum E { \"a\", \"b\" } | a.b;\nint a = 42; // this is a comment\nreal b = 3.14 + .5;\nb >= a;";
+    std::stringstream ss;
+    ss << src;
+    auto expected = riddle::lexer(symbols).parse(ss);
+    auto tokens = riddle::lexer(symbols).parse(std::string_view(src));
+    assert(tokens.size() == expected.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        assert(tokens[i]->sym == expected[i]->sym);
+        assert(tokens[i]->line == expected[i]->line);
+        assert(tokens[i]->start_pos == expected[i]->start_pos);
+        assert(tokens[i]->end_pos == expected[i]->end_pos);
+    }
+    assert(static_cast<const riddle::id_token &>(*tokens[10]).id == "b");
+    assert(static_cast<const riddle::int_token &>(*tokens[15]).value == 42);
+    assert(static_cast<const riddle::real_token &>(*tokens[20]).value == utils::rational(314, 100));
+    assert(static_cast<const riddle::real_token &>(*tokens[22]).value == utils::rational(1, 2));
+}
+
+void test_buffer_comment()
+{
+    riddle::symbol_table symbols;
+    auto tokens = riddle::lexer(symbols).parse(std::string_view("/* a\nmulti-line\ncomment */ bool a;"));
+    assert(tokens.size() == 4);
+    assert(tokens[0]->sym == riddle::BOOL);
+    assert(tokens[0]->line == 3);
+    assert(tokens[0]->start_pos == 11);
+    assert(tokens[2]->sym == riddle::SEMICOLON);
+    assert(tokens[3]->sym == riddle::EoF);
+}
+
+void test_token_stream()
+{
+    riddle::symbol_table symbols;
+    auto ts = riddle::lexer(symbols).tokenize("fact f = new P(x: 2, y: 0.5, z: \"s\", w: true);");
+    assert(ts.size() == 24);
+    assert(ts.at(0).sym == riddle::FACT);
+    assert(ts.at(1).sym == riddle::ID && ts.get_id(ts.at(1)) == "f");
+    assert(ts.at(4).sym == riddle::ID && ts.get_id(ts.at(4)) == "P");
+    assert(ts.at(8).sym == riddle::Int && ts.get_int(ts.at(8)) == 2);
+    assert(ts.at(12).sym == riddle::Real && ts.get_real(ts.at(12)) == utils::rational(1, 2));
+    assert(ts.at(16).sym == riddle::String && ts.get_string(ts.at(16)) == "s");
+    assert(ts.at(16).start_pos == 32 && ts.at(16).end_pos == 34);
+    assert(ts.at(20).sym == riddle::Bool && ts.get_bool(ts.at(20)));
+    assert(ts.at(23).sym == riddle::EoF);
+}
+
+void test_symbols()
+{
+    riddle::symbol_table symbols;
+    auto ts0 = riddle::lexer(symbols).tokenize("a.b = a;");
+    auto ts1 = riddle::lexer(symbols).tokenize("b < a;");
+    assert(symbols.size() == 2);
+    assert(&ts0.get_id(ts0.at(0)) == &ts0.get_id(ts0.at(4)));
+    assert(&ts0.get_id(ts0.at(0)) == &ts1.get_id(ts1.at(2)));
+    assert(&ts0.get_id(ts0.at(2)) == &ts1.get_id(ts1.at(0)));
+    assert(&symbols.intern("a") == &ts0.get_id(ts0.at(0)));
+}
+
+void test_stream()
+{
+    riddle::symbol_table symbols;
+    std::string src;
+    for (int i = 0; i < 5000; ++i) // a source larger than the window of the lexer..
+        src += "a" + std::to_string(i) + " >= 12 + .5; /* a\n comment */ \"a\nstring\"; // another comment\n";
+
+    riddle::lexer buf_lex(symbols);
+    auto expected = buf_lex.tokenize(src);
+
+    std::istringstream ss(src);
+    riddle::lexer lex(symbols);
+    auto ts = lex.stream(ss);
+    size_t pos = 0;
+    do
+    {
+        const auto &tk = ts.at(pos);
+        const auto &e_tk = expected.at(pos);
+        assert(tk.sym == e_tk.sym && tk.line == e_tk.line && tk.start_pos == e_tk.start_pos && tk.end_pos == e_tk.end_pos);
+        if (tk.sym == riddle::ID)
+            assert(ts.get_id(tk) == expected.get_id(e_tk));
+        else if (tk.sym == riddle::String)
+            assert(ts.get_string(tk) == expected.get_string(e_tk));
+        ts.release(pos); // we retain just the current token..
+    } while (ts.at(pos++).sym != riddle::EoF);
+    assert(pos == expected.size());
+}
+
+void test_scan()
+{
+    // a source mixing all the character classes, with runs crossing the vector boundaries..
+    std::string src;
+    for (int i = 0; i < 64; ++i)
+        src += std::string(i % 37, ' ') + "\t\r" + std::string(i % 41, 'a') + "_Z9\xC3\xA8" + std::string(i % 19, '*') + "/\n\"" + std::string(i % 23, 'x') + "@[`{";
+
+    const char *begin = src.data(), *end = src.data() + src.size();
+    const auto isa = riddle::scan::current();
+    for (const auto set : {riddle::scan::isa::scalar, riddle::scan::isa::sse2, riddle::scan::isa::avx2})
+    {
+        riddle::scan::use(set);
+        for (const char *p = begin; p != end; ++p)
+        {
+            const char *sp = p, *id = p;
+            while (sp != end && (*sp == ' ' || *sp == '\t' || *sp == '\r'))
+                ++sp;
+            while (id != end && riddle::scan::is_id_char(*id))
+                ++id;
+            assert(riddle::scan::skip_spaces(p, end) == sp);
+            assert(riddle::scan::skip_id(p, end) == id);
+            assert(riddle::scan::find(p, end, '"') == std::find(p, end, '"'));
+            const char *star_or_nl = p;
+            while (star_or_nl != end && *star_or_nl != '*' && *star_or_nl != '\n')
+                ++star_or_nl;
+            assert(riddle::scan::find_either(p, end, '*', '\n') == star_or_nl);
+        }
+    }
+    riddle::scan::use(isa);
+}
+
+void test_keywords()
+{
+    riddle::symbol_table symbols;
+    riddle::lexer lex(symbols);
+    auto ts = lex.tokenize("bool int real time string enum class predicate new for this void return fact goal or true false tru boolean o predicates Class thisx");
+    const riddle::symbol expected[] = {riddle::BOOL, riddle::INT, riddle::REAL, riddle::TIME, riddle::STRING, riddle::ENUM, riddle::CLASS, riddle::PREDICATE, riddle::NEW, riddle::FOR, riddle::THIS, riddle::VOID, riddle::RETURN, riddle::FACT, riddle::GOAL, riddle::OR, riddle::Bool, riddle::Bool, riddle::ID, riddle::ID, riddle::ID, riddle::ID, riddle::ID, riddle::ID, riddle::EoF};
+    assert(ts.size() == std::size(expected));
+    for (size_t i = 0; i < ts.size(); ++i)
+        assert(ts.at(i).sym == expected[i]);
+    assert(ts.get_bool(ts.at(16)) && !ts.get_bool(ts.at(17)));
+}
+
+void test_numeric_literals()
+{
+    riddle::symbol_table symbols;
+    const auto max = std::to_string(std::numeric_limits<INT_TYPE>::max());
+    riddle::lexer lex(symbols);
+    auto ts = lex.tokenize(max + " 0.0001 .25 12.500000000000000000000000000000 007");
+    assert(ts.get_int(ts.at(0)) == std::numeric_limits<INT_TYPE>::max());
+    assert(ts.get_real(ts.at(1)) == utils::rational(1, 10000));
+    assert(ts.get_real(ts.at(2)) == utils::rational(1, 4));
+    assert(ts.get_real(ts.at(3)) == utils::rational(25, 2));
+    assert(ts.get_int(ts.at(4)) == 7);
+
+    for (const auto &src : {max + "0", "0." + std::string(max.size(), '0') + "1", max + ".5"})
+    {
+        bool thrown = false;
+        try
+        {
+            static_cast<void>(lex.tokenize(src));
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
 int main()
 {
     test_lexer0();
@@ -235,5 +404,13 @@ int main()
     test_lexer3();
     test_lexer4();
     test_comment();
+    test_buffer();
+    test_buffer_comment();
+    test_token_stream();
+    test_symbols();
+    test_stream();
+    test_scan();
+    test_keywords();
+    test_numeric_literals();
     return 0;
 }
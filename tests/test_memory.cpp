@@ -0,0 +1,83 @@
+#include "test_core.hpp"
+#include <sstream>
+#include <atomic>
+#include <cstdlib>
+#include <cassert>
+
+static std::atomic<std::size_t> live_bytes = 0; // the number of bytes currently allocated through `operator new`..
+
+void *operator new(std::size_t size)
+{ // every allocation is preceded by its size, preserving the alignment of the allocated memory..
+    auto *header = static_cast<std::max_align_t *>(std::malloc(sizeof(std::max_align_t) + size));
+    if (!header)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(header) = size;
+    live_bytes += size;
+    return header + 1;
+}
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    auto *header = static_cast<std::max_align_t *>(ptr) - 1;
+    live_bytes -= *reinterpret_cast<std::size_t *>(header);
+    std::free(header);
+}
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+
+/**
+ * @brief A stream generating `x >= i.0;` statements, one at a time, which tracks the memory in use while they are read.
+ */
+class statement_source : public std::streambuf
+{
+public:
+    statement_source(std::size_t n, std::size_t warm_up) noexcept : n(n), warm_up(warm_up) {}
+
+    std::size_t base = 0; // the number of bytes in use once the first statements have been read..
+    std::size_t peak = 0; // the largest number of bytes in use while the remaining statements are read..
+
+private:
+    int_type underflow() override
+    {
+        if (i == warm_up)
+            base = live_bytes;
+        else if (i > warm_up)
+            peak = std::max(peak, live_bytes.load());
+        if (i == n)
+            return traits_type::eof();
+        line = "x >= " + std::to_string(i++) + ".0;\n";
+        setg(line.data(), line.data(), line.data() + line.size());
+        return traits_type::to_int_type(line[0]);
+    }
+
+private:
+    const std::size_t n, warm_up;
+    std::size_t i = 0;
+    std::string line;
+};
+
+void test_stream_memory()
+{
+    test_core core;
+    std::istringstream decls("real x;");
+    core.read(decls);
+
+    // the executed statements are dropped, together with their nodes, hence the memory does not grow with the number of statements..
+    statement_source src(20000, 1000);
+    std::istream is(&src);
+    core.read(is);
+    assert(src.peak < src.base + (64 << 10));
+
+    // the disjunctions are retained, since the posted conjunctions execute their blocks..
+    std::istringstream disj("{ x >= 1.0; } or { x <= 0.0; } x >= 2.0;");
+    core.read(disj);
+    assert(core.conjunctions.size() == 2);
+    for (auto &conj : core.conjunctions)
+        conj->execute();
+}
+
+int main()
+{
+    test_stream_memory();
+    return 0;
+}
@@ -1,111 +1,8 @@
-#include "core.hpp"
-#include "flaw.hpp"
-#include "items.hpp"
+#include "test_core.hpp"
+#include "type_context.hpp"
+#include <sstream>
 #include <cassert>
 
-class test_enum_flaw : public riddle::flaw
-{
-public:
-    test_enum_flaw(riddle::core &cr, riddle::component_type &tp, std::vector<riddle::expr> &&vals) noexcept : riddle::flaw(cr, {}), itm(std::make_shared<riddle::enum_item>(*this, tp, std::move(vals), 0)) {}
-
-    [[nodiscard]] riddle::enum_expr get_enum() const noexcept { return itm; }
-
-    utils::rational get_estimated_cost() const noexcept override { return utils::rational(1); }
-
-private:
-    void compute_resolvers() override {}
-
-private:
-    riddle::enum_expr itm;
-};
-
-class test_atom_flaw : public riddle::flaw
-{
-public:
-    test_atom_flaw(riddle::core &cr, bool is_fact, riddle::predicate &pred, std::map<std::string, std::shared_ptr<riddle::term>, std::less<>> &&args) noexcept : riddle::flaw(cr, {}), atm(std::make_shared<riddle::atom>(*this, pred, is_fact, std::move(args), cr.new_bool())) {}
-
-    [[nodiscard]] riddle::atom_expr get_atom() const noexcept { return atm; }
-
-    utils::rational get_estimated_cost() const noexcept override { return utils::rational(1); }
-
-private:
-    void compute_resolvers() override {}
-
-private:
-    riddle::atom_expr atm;
-};
-
-class test_core : public riddle::core
-{
-public:
-    test_core() noexcept : riddle::core() {}
-    ~test_core() override = default;
-
-    riddle::bool_expr new_bool(const bool) override { return std::make_shared<riddle::bool_item>(static_cast<riddle::bool_type &>(get_type(riddle::bool_kw)), utils::lit()); }
-    riddle::bool_expr new_bool() override { return new_bool(false); }
-    utils::lbool bool_value(const riddle::bool_term &) const noexcept override { return utils::Undefined; }
-    riddle::arith_expr new_int(const INT_TYPE) override { return std::make_shared<riddle::arith_item>(static_cast<riddle::int_type &>(get_type(riddle::int_kw)), utils::lin()); }
-    riddle::arith_expr new_int() override { return new_int(0); }
-    riddle::arith_expr new_int(const INT_TYPE lb, const INT_TYPE) override { return new_int(lb); }
-    riddle::arith_expr new_uncertain_int(const INT_TYPE lb, const INT_TYPE) override { return new_int(lb); }
-    riddle::arith_expr new_real(utils::rational &&) override { return std::make_shared<riddle::arith_item>(static_cast<riddle::real_type &>(get_type(riddle::real_kw)), utils::lin()); }
-    riddle::arith_expr new_real() override { return new_real(utils::rational(0)); }
-    riddle::arith_expr new_real(utils::rational &&lb, utils::rational &&) override { return new_real(utils::rational(lb)); }
-    riddle::arith_expr new_uncertain_real(utils::rational &&lb, utils::rational &&) override { return new_real(utils::rational(lb)); }
-    riddle::arith_expr new_time(utils::rational &&) override { return std::make_shared<riddle::arith_item>(static_cast<riddle::time_type &>(get_type(riddle::time_kw)), utils::lin()); }
-    riddle::arith_expr new_time() override { return new_time(utils::rational(0)); }
-    utils::inf_rational arith_value(const riddle::arith_term &) const noexcept override { return utils::inf_rational(); }
-    bool is_constant(const riddle::arith_term &) const noexcept override { return true; }
-    riddle::string_expr new_string(std::string &&) override { return std::make_shared<riddle::string_item>(static_cast<riddle::string_type &>(get_type(riddle::string_kw)), ""); }
-    riddle::string_expr new_string() override { return new_string(""); }
-    std::string string_value(const riddle::string_term &) const noexcept override { return ""; }
-    riddle::expr new_enum(riddle::component_type &tp, std::vector<riddle::expr> &&values) override
-    {
-        auto flw = std::make_shared<test_enum_flaw>(*this, tp, std::move(values));
-        flaws.emplace_back(flw);
-        return flw->get_enum();
-    }
-    std::unordered_set<riddle::expr> enum_value(const riddle::enum_term &xpr) const noexcept override { return {xpr.get_values()[0]}; }
-
-    riddle::arith_expr new_negation(riddle::arith_expr) override { return new_int(0); }
-
-    riddle::arith_expr new_sum(std::vector<riddle::arith_expr> &&) override { return new_int(0); }
-    riddle::arith_expr new_subtraction(std::vector<riddle::arith_expr> &&) override { return new_int(0); }
-    riddle::arith_expr new_product(std::vector<riddle::arith_expr> &&) override { return new_int(0); }
-    riddle::arith_expr new_division(std::vector<riddle::arith_expr> &&) override { return new_int(0); }
-
-    void new_disjunction(std::vector<std::unique_ptr<riddle::conjunction>> &&) override {}
-    void new_clause(std::vector<riddle::bool_expr> &&) override {}
-
-    riddle::atom_expr create_atom(bool is_fact, riddle::predicate &pred, std::map<std::string, std::shared_ptr<riddle::term>, std::less<>> &&args) override
-    {
-        auto flw = std::make_shared<test_atom_flaw>(*this, is_fact, pred, std::move(args));
-        flaws.emplace_back(flw);
-        return flw->get_atom();
-    }
-    riddle::atom_state get_atom_state(const riddle::atom_term &) const noexcept override { return riddle::atom_state::active; }
-
-private:
-    bool mk_assign(riddle::bool_expr, utils::lbool) noexcept { return true; }
-    bool mk_eq(riddle::bool_expr, riddle::bool_expr) noexcept { return true; }
-    bool mk_neq(riddle::bool_expr, riddle::bool_expr) noexcept { return true; }
-
-    bool mk_lt(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-    bool mk_le(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-    bool mk_eq(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-    bool mk_neq(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-    bool mk_ge(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-    bool mk_gt(riddle::arith_expr, riddle::arith_expr) noexcept { return true; }
-
-    bool mk_assign(riddle::enum_expr, const utils::enum_val &) noexcept { return true; }
-    bool mk_forbid(riddle::enum_expr, const utils::enum_val &) noexcept { return true; }
-    bool mk_eq(riddle::enum_expr, riddle::enum_expr) noexcept { return true; }
-    bool mk_neq(riddle::enum_expr, riddle::enum_expr) noexcept { return true; }
-
-private:
-    std::vector<std::shared_ptr<riddle::flaw>> flaws;
-};
-
 void test_class_declaration()
 {
     test_core core;
@@ -184,6 +81,87 @@ void test_statements()
     core.read("2*a + 3*b < 4*c;");
 }
 
+void test_expressions()
+{
+    riddle::symbol_table symbols;
+    // chains of the same operator build a single n-ary node..
+    assert(dynamic_cast<riddle::sum_expression *>(riddle::parser(std::string_view("a + b * c + d"), symbols).parse_expression().get()));
+    assert(dynamic_cast<riddle::subtraction_expression *>(riddle::parser(std::string_view("a + b - c"), symbols).parse_expression().get()));
+    assert(dynamic_cast<riddle::product_expression *>(riddle::parser(std::string_view("(a + b) * c"), symbols).parse_expression().get()));
+    assert(dynamic_cast<riddle::eq_expression *>(riddle::parser(std::string_view("a | b == c & d"), symbols).parse_expression().get()));
+    // unary operators apply to the whole expression that follows them..
+    assert(dynamic_cast<riddle::minus_expression *>(riddle::parser(std::string_view("-a + b"), symbols).parse_expression().get()));
+    assert(dynamic_cast<riddle::not_expression *>(riddle::parser(std::string_view("!a & b"), symbols).parse_expression().get()));
+
+    // long chains and deep nesting do not exhaust the native stack..
+    test_core core;
+    std::string sum = "real a; real b = a";
+    for (int i = 0; i < 100000; ++i)
+        sum += " + a";
+    core.read(sum + ";");
+    core.read("real c = " + std::string(100000, '(') + "a + b" + std::string(100000, ')') + ";");
+}
+
+void test_simplify()
+{
+    riddle::symbol_table symbols;
+    auto bounds = [&symbols](const char *script)
+    {
+        riddle::parser p(script, symbols);
+        return p.parse_expression()->get_bounds();
+    };
+    auto truth = [&symbols](const char *script)
+    {
+        riddle::parser p(script, symbols);
+        return p.parse_expression()->get_truth();
+    };
+
+    // constant subexpressions are folded..
+    auto b = bounds("1 + 2 * 3 - 4");
+    assert(b && b->is_int && b->lb == utils::rational(3) && b->ub == utils::rational(3));
+    b = bounds("-(1.5 * 2)");
+    assert(b && !b->is_int && b->lb == utils::rational(-3));
+    b = bounds("7 / 2");
+    assert(!b); // the quotient of the integers is not an integer..
+    b = bounds("7 / 2.0");
+    assert(b && !b->is_int && b->lb == utils::rational(7, 2));
+
+    // literal bounds are propagated..
+    b = bounds("[1, 2] + 3");
+    assert(b && b->is_int && b->lb == utils::rational(4) && b->ub == utils::rational(5));
+    b = bounds("-2.0 * [1.0, 2.0]");
+    assert(b && !b->is_int && b->lb == utils::rational(-4) && b->ub == utils::rational(-2));
+    b = bounds("2 * [1, 2]");
+    assert(!b); // not all the integers within the scaled bounds are reachable..
+
+    // comparisons with a known truth value are resolved..
+    assert(truth("3 >= 2") == std::optional<bool>(true));
+    assert(truth("[0, 10] < 20") == std::optional<bool>(true));
+    assert(truth("1.5 == 2") == std::optional<bool>(false));
+    assert(truth("!(1 > 2) & true") == std::optional<bool>(true));
+    assert(!truth("[0, 10] < 5"));
+
+    // identities are removed..
+    riddle::parser p("(x + 0) * 1 - 0 / 1", symbols);
+    assert(dynamic_cast<riddle::id_expression *>(p.parse_expression().get()));
+    // ..unless they are the only real operands, which make the expression real..
+    for (const auto script : {"x + 0.0", "x - 0.0", "x * 1.0", "x / 1.0", "(x + 0) * 1.0"})
+    {
+        riddle::parser q(script, symbols);
+        assert(!dynamic_cast<riddle::id_expression *>(q.parse_expression().get()));
+    }
+
+    test_core core;
+    core.read("real x = 1.0; real y = (x + 1) + 2 * 3; y >= 0.5 * 2; 3 >= 2;");
+    core.read("int i = 1;");
+    for (const auto script : {"i + 0.0", "i - 0.0", "i * 1.0", "i / 1.0"})
+    {
+        riddle::parser q(script, symbols);
+        riddle::type_context ctx(core);
+        assert(&q.parse_expression()->check(ctx) == &core.get_type(riddle::real_kw));
+    }
+}
+
 void test_fact()
 {
     test_core core;
@@ -195,6 +173,28 @@ void test_fact()
     core.read("A a = new A(); fact f = new a.p();");
 }
 
+void test_stream()
+{
+    test_core core;
+    std::istringstream ss("class A { int a; A(int a) : a(a) {} }; A a0 = new A(1); predicate p(A x) { x.a > 0; } fact f0 = new p(x: a0);");
+    core.read(ss);
+}
+
+void test_arena()
+{
+    riddle::symbol_table symbols;
+    riddle::parser p("class A { int a = 1 + 2; }; predicate p(int x) { x > 0; }", symbols);
+    auto cu = p.parse_compilation_unit();
+    assert(p.get_arena()->allocated() > 0);
+
+    riddle::parser q("1 + 2 * 3", symbols);
+    auto expr = q.parse_expression(); // nodes built outside compilation units come from the heap..
+    assert(q.get_arena()->allocated() == 0);
+
+    test_core core;
+    core.read("class B { real r; }; B b = new B(); b.r >= 0.5;");
+}
+
 int main()
 {
     test_class_declaration();
@@ -208,6 +208,10 @@ int main()
     test_bounded_ariths();
     test_uncertain_ariths();
     test_statements();
+    test_expressions();
+    test_simplify();
     test_fact();
+    test_stream();
+    test_arena();
     return 0;
 }
@@ -0,0 +1,137 @@
+#include "test_core.hpp"
+#include <set>
+#include <cassert>
+
+void test_hash_consing()
+{
+    test_core core;
+    core.read("real a; real b;");
+    auto a = std::static_pointer_cast<riddle::arith_term>(core.get("a"));
+    auto b = std::static_pointer_cast<riddle::arith_term>(core.get("b"));
+    assert(core.new_lt(a, b) != core.new_lt(a, b));
+    core.assert_expr(core.new_lt(a, b));
+    core.assert_expr(core.new_lt(a, b));
+    assert(core.posted_lts == 2);
+
+    core.set_hash_consing(true);
+    auto lt = core.new_lt(a, b);
+    assert(lt == core.new_lt(a, b));
+    assert(lt != core.new_lt(b, a));
+    assert(core.new_not(lt) == core.new_not(lt));
+    assert(core.new_and({lt, core.new_not(lt)}) == core.new_and({lt, core.new_not(lt)}));
+
+    // identical assertions are posted once..
+    core.assert_expr(lt);
+    core.assert_expr(core.new_lt(a, b));
+    assert(core.posted_lts == 3);
+
+    // ..as long as the term is alive, the assertions not extending its lifetime..
+    std::weak_ptr<riddle::bool_term> dead = lt;
+    lt.reset();
+    assert(dead.expired());
+    core.assert_expr(core.new_lt(a, b));
+    assert(core.posted_lts == 4);
+}
+
+void test_item_map()
+{
+    test_core core;
+    riddle::item_map items;
+    assert(items.emplace("c", core.new_int(3)).second);
+    assert(items.emplace("a", core.new_int(1)).second);
+    assert(items.emplace("b", core.new_int(2)).second);
+    assert(!items.emplace("a", core.new_int(4)).second); // an existing item is not replaced..
+    assert(items.size() == 3);
+
+    std::string names;
+    for (const auto &[name, itm] : items) // the items are iterated in the order of their names..
+        names += name;
+    assert(names == "abc");
+
+    std::string_view b = "b";
+    assert(items.find(b) != items.end() && items.count("b") == 1);
+    assert(items.find("d") == items.end() && items.count("d") == 0);
+    assert(items.erase("b") == 1 && items.erase("b") == 0);
+    assert(items.size() == 2 && items.find("b") == items.end());
+
+    // large maps are indexed, yet they behave as small ones..
+    riddle::item_map large;
+    const size_t n = 4 * riddle::item_map::index_threshold;
+    for (size_t i = 0; i < n; ++i)
+        assert(large.emplace("x" + std::to_string((i * 37) % n), core.new_int(static_cast<INT_TYPE>(i))).second);
+    assert(large.size() == n && !large.emplace("x0", core.new_int(0)).second);
+    for (size_t i = 0; i < n; i += 2)
+        assert(large.erase("x" + std::to_string(i)) == 1);
+    assert(large.size() == n / 2 && large.count("x0") == 0 && large.count("x1") == 1);
+    assert(large.emplace("x0", core.new_int(0)).second && large.at("x0"));
+    const auto copy = large;
+    std::set<std::string> visited;
+    for (const auto &[name, itm] : copy) // each item is visited once, in an unspecified order..
+        assert(visited.insert(name).second && large.at(name) == itm);
+    assert(visited.size() == copy.size());
+    assert(copy.find("x3") != copy.end() && copy.find("x2") == copy.end());
+
+    core.read("class A { int x; real y; bool z; A(int x) : x(x) {} }; predicate P(int u, real v) { u >= 0; } A a = new A(1); fact f = new P(u: 1);");
+    auto a = std::dynamic_pointer_cast<riddle::component>(core.get("a"));
+    assert(a->get_items().size() == 3);
+    assert(a->get_items().begin()->first == "x");
+    auto f = std::dynamic_pointer_cast<riddle::atom_term>(core.get("f"));
+    assert(f->get_items().count("u") && f->get_items().count("v"));
+}
+
+void test_term_pool()
+{
+    auto pool = std::make_unique<riddle::term_pool>();
+    auto *a = pool->allocate(24);
+    auto *b = pool->allocate(24);
+    assert(a != b && pool->allocated() == 48);
+    pool->deallocate(a, 24);
+    assert(pool->allocate(20) == a); // blocks of the same size class are reused..
+    auto *big = pool->allocate(riddle::term_pool::max_block_size + 1); // large blocks come from the global allocator..
+    pool->deallocate(big, riddle::term_pool::max_block_size + 1);
+    pool->deallocate(a, 20);
+    pool->deallocate(b, 24);
+    assert(pool->allocated() == 0);
+
+    riddle::expr x;
+    {
+        test_core core;
+        core.read("real r = 1.5; bool b0; bool b1 = r >= 0.5 | b0;");
+        x = core.get("r");
+    } // the memory of the terms outliving their core is released along with them..
+    assert(x.use_count() == 1);
+    x.reset();
+}
+
+void test_term_kinds()
+{
+    test_core core;
+    auto a = core.new_real();
+    auto b = core.new_real();
+    assert(a->get_kind() == riddle::term_kind::arith_kind);
+    assert(core.new_bool()->get_kind() == riddle::term_kind::bool_kind);
+    assert(core.new_string()->get_kind() == riddle::term_kind::string_kind);
+    assert(core.new_lt(a, b)->get_kind() == riddle::term_kind::lt_kind);
+    assert(core.new_not(core.new_lt(a, b))->get_kind() == riddle::term_kind::not_kind);
+    assert(riddle::is_bool_kind(core.new_eq(a, b)->get_kind()) && !riddle::is_bool_kind(a->get_kind()));
+    assert(core.new_and({core.new_bool(), core.new_bool()})->get_kind() == riddle::term_kind::and_kind);
+    assert(core.new_or({core.new_bool(), core.new_bool()})->get_kind() == riddle::term_kind::or_kind);
+    assert(core.new_xor({core.new_bool(), core.new_bool()})->get_kind() == riddle::term_kind::xor_kind);
+
+    core.read("class A { int x; }; predicate P(int u) { u >= 0; } A a0 = new A(); fact f = new P(u: 1);");
+    assert(core.get("a0")->get_kind() == riddle::term_kind::component_kind);
+    assert(core.get("f")->get_kind() == riddle::term_kind::atom_kind);
+
+    // the negated comparisons are posted as their complements..
+    assert(core.assert_expr(core.new_not(core.new_le(a, b))));
+    assert(core.posted_lts == 1);
+}
+
+int main()
+{
+    test_hash_consing();
+    test_item_map();
+    test_term_pool();
+    test_term_kinds();
+    return 0;
+}